@@ -0,0 +1,110 @@
+#!/bin/sh
+# Compare two sets of hurdbench results
+#
+# Copyright (C) 2026 Free Software Foundation, Inc.
+#
+# This file is part of the GNU Hurd.
+#
+# The GNU Hurd is free software; you can redistribute it and/or
+# modify it under the terms of the GNU General Public License as
+# published by the Free Software Foundation; either version 2, or (at
+# your option) any later version.
+#
+# The GNU Hurd is distributed in the hope that it will be useful, but
+# WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+#
+
+USAGE="Usage: $0 [OPTION...] OLD NEW"
+DOC="Compare the hurdbench --machine results in OLD and NEW."
+
+THRESHOLD=5
+
+while [ "$#" -gt 0 ]; do
+  case "$1" in
+    --help|"-?")
+      echo "$USAGE"
+      echo "$DOC"
+      echo ""
+      echo "  -t, --threshold=PERCENT    Report changes of the median larger"
+      echo "                             than PERCENT (default 5)"
+      echo "  -?, --help                 Give this help list"
+      echo "      --usage                Give a short usage message"
+      echo "  -V, --version              Print program version"
+      echo ""
+      echo "The exit status is 1 if any median got slower by more than"
+      echo "the threshold, and 2 if OLD or NEW is unreadable or OLD is empty."
+      exit 0;;
+    --usage)
+      echo "Usage: $0 [-V?] [-t PERCENT] [--threshold=PERCENT] [--help]"
+      echo "       [--usage] [--version] OLD NEW"
+      exit 0;;
+    --version|-V)
+      echo "STANDARD_HURD_VERSION_bench-compare_"; exit 0;;
+    -t)
+      THRESHOLD="$2"; shift 2;;
+    --threshold=*)
+      THRESHOLD="${1#--threshold=}"; shift;;
+    --)
+      shift
+      break;;
+    -*)
+      echo 1>&2 "$0: unrecognized option \`$1'"
+      echo 1>&2 "Try \`$0 --help' or \`$0 --usage' for more information";
+      exit 1;;
+    *)
+      break;;
+  esac
+done
+
+if [ $# -ne 2 ]; then
+  echo 1>&2 "$USAGE"
+  echo 1>&2 "Try \`$0 --help' or \`$0 --usage' for more information";
+  exit 1
+fi
+
+# awk tells OLD from NEW by FNR == NR, which holds all through NEW if
+# OLD has no lines at all.
+for f in "$1" "$2"; do
+  if [ ! -r "$f" ]; then
+    echo 1>&2 "$0: $f: cannot read"
+    exit 2
+  fi
+done
+if [ ! -s "$1" ]; then
+  echo 1>&2 "$0: $1: empty file"
+  exit 2
+fi
+
+# Results are keyed on the benchmark and its parameter; the median is
+# compared, and the 99th percentile is shown alongside it since tail
+# latency regressions often do not move the median.
+exec awk -F '\t' -v threshold="$THRESHOLD" '
+  /^#/ { next }
+  FNR == NR { old50[$1 "\t" $2] = $5; old99[$1 "\t" $2] = $7; next }
+  {
+    key = $1 "\t" $2
+    if (!(key in old50))
+      {
+	printf "%-8s %-14s %12s %12s  new\n", $1, $2, "-", $5
+	next
+      }
+    change = old50[key] ? ($5 - old50[key]) * 100 / old50[key] : 0
+    mark = ""
+    if (change > threshold)
+      {
+	mark = "  slower"
+	slower = 1
+      }
+    else if (change < -threshold)
+      mark = "  faster"
+    printf "%-8s %-14s %12d %12d %+7.1f%% p99 %d -> %d%s\n", \
+	   $1, $2, old50[key], $5, change, old99[key], $7, mark
+  }
+  END { exit slower }
+' "$1" "$2"
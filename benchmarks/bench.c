@@ -0,0 +1,232 @@
+/* Microbenchmarks of Hurd servers and RPC paths
+
+   Copyright (C) 2026 Free Software Foundation, Inc.
+
+   This file is part of the GNU Hurd.
+
+   The GNU Hurd is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation; either version 2, or (at
+   your option) any later version.
+
+   The GNU Hurd is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include <argp.h>
+#include <errno.h>
+#include <error.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <version.h>
+
+#include "bench.h"
+
+const char *argp_program_version = STANDARD_HURD_VERSION (hurdbench);
+
+unsigned bench_iterations = 1000;
+unsigned bench_warmup = 100;
+const char *bench_dir = ".";
+
+const size_t bench_sizes[] = { 64, 512, 4096, 32768, 262144, 0 };
+
+/* If set, print results as tab separated values for bench-compare.  */
+static int machine;
+
+struct bench
+{
+  const char *name;
+  void (*run) (void);
+  const char *doc;
+};
+
+static const struct bench benches[] =
+{
+  {"rpc",    bench_rpc,    "Null RPC round trip through libports"},
+  {"io",     bench_io,     "io_read and io_write throughput"},
+  {"lookup", bench_lookup, "dir_lookup latency by path depth"},
+  {"fault",  bench_fault,  "Pager fault latency"},
+  {"pipe",   bench_pipe,   "Pipe throughput through pflocal"},
+  {"unix",   bench_unix,   "AF_UNIX stream throughput through pflocal"},
+  {"fork",   bench_fork,   "fork and fork+exec latency"},
+  {0}
+};
+
+uint64_t
+bench_now (void)
+{
+  struct timespec ts;
+  clock_gettime (CLOCK_MONOTONIC, &ts);
+  return (uint64_t) ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+void
+bench_samples_init (struct bench_samples *samples, size_t n)
+{
+  samples->ns = malloc (n * sizeof *samples->ns);
+  if (!samples->ns)
+    error (1, errno, "allocating samples");
+  samples->count = 0;
+  samples->alloced = n;
+}
+
+void
+bench_sample_add (struct bench_samples *samples, uint64_t ns)
+{
+  if (samples->count < samples->alloced)
+    samples->ns[samples->count++] = ns;
+}
+
+void
+bench_samples_fini (struct bench_samples *samples)
+{
+  free (samples->ns);
+  samples->ns = NULL;
+  samples->count = samples->alloced = 0;
+}
+
+static int
+compare_ns (const void *a, const void *b)
+{
+  uint64_t x = *(const uint64_t *) a, y = *(const uint64_t *) b;
+  return x < y ? -1 : x > y;
+}
+
+/* Return the Pth percentile of the N sorted values in NS, using the
+   nearest rank.  */
+static uint64_t
+percentile (const uint64_t *ns, size_t n, unsigned p)
+{
+  size_t rank = (n * p + 99) / 100;
+  return ns[rank ? rank - 1 : 0];
+}
+
+void
+bench_report (struct bench_samples *samples, const char *name,
+	      const char *param, size_t bytes)
+{
+  size_t n = samples->count, i;
+  uint64_t total = 0, p50, p90, p99;
+  double mean, rate = 0;
+
+  if (n == 0)
+    return;
+
+  qsort (samples->ns, n, sizeof *samples->ns, compare_ns);
+  for (i = 0; i < n; i++)
+    total += samples->ns[i];
+  mean = (double) total / n;
+  if (bytes && total)
+    rate = (double) bytes * n * 1e9 / total;
+
+  p50 = percentile (samples->ns, n, 50);
+  p90 = percentile (samples->ns, n, 90);
+  p99 = percentile (samples->ns, n, 99);
+
+  if (machine)
+    printf ("%s\t%s\t%zu\t%llu\t%llu\t%llu\t%llu\t%llu\t%.0f\t%.0f\n",
+	    name, param, n,
+	    (unsigned long long) samples->ns[0],
+	    (unsigned long long) p50, (unsigned long long) p90,
+	    (unsigned long long) p99,
+	    (unsigned long long) samples->ns[n - 1], mean, rate);
+  else
+    {
+      printf ("%-8s %-14s %7zu %9.2f %9.2f %9.2f %9.2f %9.2f",
+	      name, param, n, samples->ns[0] / 1e3, p50 / 1e3, p90 / 1e3,
+	      p99 / 1e3, samples->ns[n - 1] / 1e3);
+      if (bytes)
+	printf (" %9.2f", rate / (1024 * 1024));
+      putchar ('\n');
+    }
+  fflush (stdout);
+
+  samples->count = 0;
+}
+
+static const struct argp_option options[] =
+{
+  {"iterations", 'n', "N", 0, "Time N operations per measurement"
+   " (default 1000)"},
+  {"warmup",     'w', "N", 0, "Run N untimed operations first (default 100)"},
+  {"directory",  'd', "DIR", 0, "Create scratch files in DIR; run once on"
+   " each file system to compare them (default `.')"},
+  {"machine",    'm', 0, 0, "Print results as tab separated values"},
+  {"list",       'l', 0, 0, "List the available benchmarks and exit"},
+  {0}
+};
+static const char args_doc[] = "[BENCHMARK...]";
+static const char doc[] = "Run microbenchmarks of Hurd servers."
+"\vWithout arguments, all benchmarks are run.  Times are in microseconds"
+" and throughput in MiB/s, or in nanoseconds and bytes per second with"
+" --machine.  Use bench-compare to compare two sets of --machine results.";
+
+static unsigned
+parse_count (char *arg, struct argp_state *state)
+{
+  char *end;
+  unsigned long n = strtoul (arg, &end, 10);
+  if (*arg == '\0' || *end != '\0' || n == 0 || n > 10000000)
+    argp_error (state, "%s: Invalid count", arg);
+  return n;
+}
+
+int
+main (int argc, char **argv)
+{
+  const struct bench *b;
+  int selected[sizeof benches / sizeof benches[0]] = { 0 };
+  int any_selected = 0;
+
+  error_t parse_opt (int key, char *arg, struct argp_state *state)
+    {
+      switch (key)
+	{
+	case 'n': bench_iterations = parse_count (arg, state); break;
+	case 'w':
+	  bench_warmup = strcmp (arg, "0") ? parse_count (arg, state) : 0;
+	  break;
+	case 'd': bench_dir = arg; break;
+	case 'm': machine = 1; break;
+	case 'l':
+	  for (b = benches; b->name; b++)
+	    printf ("%-8s %s\n", b->name, b->doc);
+	  exit (0);
+
+	case ARGP_KEY_ARG:
+	  for (b = benches; b->name; b++)
+	    if (strcmp (b->name, arg) == 0)
+	      break;
+	  if (!b->name)
+	    argp_error (state, "%s: Unknown benchmark", arg);
+	  selected[b - benches] = any_selected = 1;
+	  break;
+
+	default:
+	  return ARGP_ERR_UNKNOWN;
+	}
+      return 0;
+    }
+  struct argp argp = { options, parse_opt, args_doc, doc };
+
+  argp_parse (&argp, argc, argv, 0, 0, 0);
+
+  if (machine)
+    puts ("#bench\tparam\tcount\tmin_ns\tp50_ns\tp90_ns\tp99_ns\tmax_ns"
+	  "\tmean_ns\tbytes_per_sec");
+  else
+    printf ("%-8s %-14s %7s %9s %9s %9s %9s %9s %9s\n", "BENCH", "PARAM",
+	    "COUNT", "MIN", "P50", "P90", "P99", "MAX", "MIB/S");
+
+  for (b = benches; b->name; b++)
+    if (!any_selected || selected[b - benches])
+      (*b->run) ();
+
+  return 0;
+}
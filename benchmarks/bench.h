@@ -0,0 +1,72 @@
+/* Common definitions for the Hurd benchmark suite
+
+   Copyright (C) 2026 Free Software Foundation, Inc.
+
+   This file is part of the GNU Hurd.
+
+   The GNU Hurd is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation; either version 2, or (at
+   your option) any later version.
+
+   The GNU Hurd is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#ifndef __BENCH_H__
+#define __BENCH_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Settings from the command line.  */
+extern unsigned bench_iterations;	/* Timed operations per measurement.  */
+extern unsigned bench_warmup;		/* Untimed operations before those.  */
+extern const char *bench_dir;		/* Where to create scratch files.  */
+
+/* Transfer sizes used by the throughput benchmarks, terminated by 0.  */
+extern const size_t bench_sizes[];
+
+/* The timings of a series of single operations, in nanoseconds.  */
+struct bench_samples
+{
+  uint64_t *ns;
+  size_t count;
+  size_t alloced;
+};
+
+/* Return a monotonic timestamp in nanoseconds.  */
+uint64_t bench_now (void);
+
+/* Prepare SAMPLES to receive up to N timings.  */
+void bench_samples_init (struct bench_samples *samples, size_t n);
+
+/* Add a timing of NS nanoseconds to SAMPLES.  */
+void bench_sample_add (struct bench_samples *samples, uint64_t ns);
+
+/* Print the percentiles of SAMPLES as the result of benchmark NAME with
+   parameter PARAM, and clear SAMPLES for reuse.  If BYTES is not zero,
+   it is the amount of data each operation transferred, and a
+   throughput is reported as well.  */
+void bench_report (struct bench_samples *samples, const char *name,
+		   const char *param, size_t bytes);
+
+/* Release the storage of SAMPLES.  */
+void bench_samples_fini (struct bench_samples *samples);
+
+/* The benchmarks.  Each runs all of its measurements and reports them
+   with bench_report; failures are reported with error and the
+   benchmark returns early.  */
+void bench_rpc (void);
+void bench_io (void);
+void bench_lookup (void);
+void bench_fault (void);
+void bench_pipe (void);
+void bench_unix (void);
+void bench_fork (void);
+
+#endif /* __BENCH_H__ */
@@ -0,0 +1,123 @@
+/* Pager fault latency
+
+   Copyright (C) 2026 Free Software Foundation, Inc.
+
+   This file is part of the GNU Hurd.
+
+   The GNU Hurd is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation; either version 2, or (at
+   your option) any later version.
+
+   The GNU Hurd is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include <errno.h>
+#include <error.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+#include "bench.h"
+
+/* Touch each page of the SIZE bytes at ADDR once, writing if WRITE is
+   set, and time each touch.  */
+static void
+touch_pages (struct bench_samples *samples, volatile char *addr,
+	     size_t size, int write)
+{
+  size_t page = getpagesize (), off;
+
+  for (off = 0; off < size; off += page)
+    {
+      uint64_t start = bench_now ();
+      if (write)
+	addr[off] = 1;
+      else
+	(void) addr[off];
+      bench_sample_add (samples, bench_now () - start);
+    }
+}
+
+/* Map a new sparse file of SIZE bytes and fault each page of it in.
+   The file has never been read or written, so every fault has to go to
+   its pager.  */
+static void
+fault_file (struct bench_samples *samples, size_t size, int write)
+{
+  char *path;
+  void *addr;
+  int fd;
+
+  if (asprintf (&path, "%s/hurdbench-fault.%d", bench_dir, getpid ()) < 0)
+    {
+      error (0, errno, "fault");
+      return;
+    }
+
+  fd = open (path, O_RDWR | O_CREAT | O_TRUNC, 0600);
+  if (fd < 0)
+    {
+      error (0, errno, "fault: %s", path);
+      free (path);
+      return;
+    }
+  unlink (path);
+
+  if (ftruncate (fd, size) < 0)
+    {
+      error (0, errno, "fault: %s", path);
+      goto out;
+    }
+
+  addr = mmap (NULL, size, write ? PROT_READ | PROT_WRITE : PROT_READ,
+	       MAP_SHARED, fd, 0);
+  if (addr == MAP_FAILED)
+    {
+      error (0, errno, "fault: mapping %s", path);
+      goto out;
+    }
+
+  touch_pages (samples, addr, size, write);
+  bench_report (samples, "fault", write ? "file-write" : "file-read", 0);
+
+  munmap (addr, size);
+ out:
+  close (fd);
+  free (path);
+}
+
+/* Measure with as many pages as iterations were asked for; each page
+   only faults once, so there is no warm up.  */
+void
+bench_fault (void)
+{
+  struct bench_samples samples;
+  size_t size = (size_t) bench_iterations * getpagesize ();
+  void *addr;
+
+  bench_samples_init (&samples, bench_iterations);
+
+  addr = mmap (NULL, size, PROT_READ | PROT_WRITE, MAP_ANON | MAP_PRIVATE,
+	       -1, 0);
+  if (addr == MAP_FAILED)
+    error (0, errno, "fault: mapping anonymous memory");
+  else
+    {
+      touch_pages (&samples, addr, size, 1);
+      bench_report (&samples, "fault", "anon-write", 0);
+      munmap (addr, size);
+    }
+
+  fault_file (&samples, size, 0);
+  fault_file (&samples, size, 1);
+
+  bench_samples_fini (&samples);
+}
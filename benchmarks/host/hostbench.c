@@ -0,0 +1,858 @@
+/* Benchmarks of Hurd data structure libraries, built on a POSIX host
+
+   Copyright (C) 2026 Free Software Foundation, Inc.
+
+   This file is part of the GNU Hurd.
+
+   The GNU Hurd is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation; either version 2, or (at
+   your option) any later version.
+
+   The GNU Hurd is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include <argp.h>
+#include <errno.h>
+#include <error.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <hurd/ihash.h>
+#include <libhurd-slab/slab.h>
+#include <libpipe/pq.h>
+#include <libshouldbeinlibc/cacheq.h>
+#include "priv.h"
+
+const char *argp_program_version = "hostbench";
+
+/* Settings from the command line.  */
+static size_t nitems = 100000;
+static unsigned max_threads = 8;
+static int machine;
+
+unsigned long shim_port_deallocations;
+
+static uint64_t
+now (void)
+{
+  struct timespec ts;
+  clock_gettime (CLOCK_MONOTONIC, &ts);
+  return (uint64_t) ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+/* Print the result of OPS operations of benchmark NAME with parameter
+   PARAM, which took NS nanoseconds in all.  EXTRA is printed as is.  */
+static void
+report (const char *name, const char *param, uint64_t ops, uint64_t ns,
+	const char *extra)
+{
+  double per_op = ops ? (double) ns / ops : 0;
+  double mops = ns ? ops * 1e3 / ns : 0;
+
+  if (machine)
+    printf ("%s\t%s\t%llu\t%.2f\t%.3f\t%s\n", name, param,
+	    (unsigned long long) ops, per_op, mops, extra ?: "");
+  else
+    printf ("%-10s %-24s %10llu %9.2f %9.3f  %s\n", name, param,
+	    (unsigned long long) ops, per_op, mops, extra ?: "");
+  fflush (stdout);
+}
+
+/* Random numbers.  Each thread uses its own state.  */
+
+static inline uint64_t
+rand64 (uint64_t *state)
+{
+  uint64_t x = *state;
+  x ^= x << 13;
+  x ^= x >> 7;
+  x ^= x << 17;
+  return *state = x;
+}
+
+/* Return an index below N following roughly a Zipf distribution, as
+   the popularity of names and files tends to.  */
+static inline size_t
+zipf (uint64_t *state, size_t n)
+{
+  double u = (rand64 (state) >> 11) * (1.0 / 9007199254740992.0);
+  size_t i = (size_t) exp (u * log ((double) n + 1)) - 1;
+  return i < n ? i : n - 1;
+}
+
+/* Key distributions.  Each generator fills KEYS with N distinct keys;
+   the first half is inserted and the second half is used for misses.  */
+
+/* Mach port names: an index in the upper bits and a small generation
+   count in the lowest byte, with freed indices being reused.  */
+static void
+keys_port (hurd_ihash_key_t *keys, size_t n, uint64_t *state)
+{
+  size_t i, index = 1;
+  for (i = 0; i < n; i++)
+    {
+      keys[i] = (index << 8) | (rand64 (state) % 4 == 0 ? 7 : 3);
+      index += 1 + (rand64 (state) % 8 == 0);
+    }
+}
+
+/* Inode numbers on an ext2 file system: clustered in block groups of
+   2048 inodes, with most of each group in use.  */
+static void
+keys_inode (hurd_ihash_key_t *keys, size_t n, uint64_t *state)
+{
+  size_t i, group = 0, ino = 12;
+  for (i = 0; i < n; i++)
+    {
+      keys[i] = group * 2048 + ino;
+      ino += 1 + (rand64 (state) % 16 == 0);
+      if (ino >= 2048)
+	{
+	  group += 1 + rand64 (state) % 4;
+	  ino = 1;
+	}
+    }
+}
+
+/* Process ids: handed out sequentially with gaps where short lived
+   processes already exited.  */
+static void
+keys_pid (hurd_ihash_key_t *keys, size_t n, uint64_t *state)
+{
+  size_t i, pid = 2;
+  for (i = 0; i < n; i++)
+    {
+      keys[i] = pid;
+      pid += 1 + rand64 (state) % 3;
+    }
+}
+
+/* Uniformly random keys, for comparison.  Duplicates are improbable
+   enough to be ignored.  */
+static void
+keys_random (hurd_ihash_key_t *keys, size_t n, uint64_t *state)
+{
+  size_t i;
+  for (i = 0; i < n; i++)
+    keys[i] = (hurd_ihash_key_t) rand64 (state) | 1;
+}
+
+static const struct
+{
+  const char *name;
+  void (*fill) (hurd_ihash_key_t *, size_t, uint64_t *);
+} dists[] =
+{
+  {"port", keys_port},
+  {"inode", keys_inode},
+  {"pid", keys_pid},
+  {"random", keys_random},
+  {0}
+};
+
+/* Shuffle the N keys in KEYS, so that lookups do not simply follow the
+   insertion order.  */
+static void
+shuffle (hurd_ihash_key_t *keys, size_t n, uint64_t *state)
+{
+  size_t i;
+  for (i = n - 1; i > 0; i--)
+    {
+      size_t j = rand64 (state) % (i + 1);
+      hurd_ihash_key_t t = keys[i];
+      keys[i] = keys[j];
+      keys[j] = t;
+    }
+}
+
+/* libihash.  */
+
+/* Describe how far the items in HT are from their home slot.  Integer
+   keys are not hashed, so the home slot is the key modulo the size.  */
+static void
+probe_stats (hurd_ihash_t ht, char *buf, size_t len)
+{
+  size_t mask = ht->size - 1, i, total = 0, max = 0;
+
+  for (i = 0; i < ht->size; i++)
+    if (hurd_ihash_value_valid (ht->items[i].value))
+      {
+	size_t dist = (i - (ht->items[i].key & mask)) & mask;
+	total += dist;
+	if (dist > max)
+	  max = dist;
+      }
+
+  snprintf (buf, len, "size=%zu load=%u%% probe-avg=%.2f probe-max=%zu",
+	    ht->size, hurd_ihash_get_load (ht) * 100 / 128,
+	    ht->nr_items ? (double) total / ht->nr_items : 0.0, max);
+}
+
+static void
+bench_ihash_dist (const char *dist, hurd_ihash_key_t *keys,
+		  unsigned max_load, uint64_t *state)
+{
+  struct hurd_ihash ht;
+  hurd_ihash_key_t *hits = keys, *misses = keys + nitems;
+  char param[64], extra[128];
+  uint64_t start;
+  size_t i, found = 0;
+
+  hurd_ihash_init (&ht, HURD_IHASH_NO_LOCP);
+  hurd_ihash_set_max_load (&ht, max_load);
+
+  start = now ();
+  for (i = 0; i < nitems; i++)
+    if (hurd_ihash_add (&ht, hits[i], (void *) (hits[i] | 1)))
+      error (1, ENOMEM, "hurd_ihash_add");
+  snprintf (param, sizeof param, "%s/load%u/add", dist, max_load);
+  probe_stats (&ht, extra, sizeof extra);
+  report ("ihash", param, nitems, now () - start, extra);
+
+  shuffle (hits, nitems, state);
+
+  start = now ();
+  for (i = 0; i < nitems; i++)
+    found += hurd_ihash_find (&ht, hits[i]) != NULL;
+  snprintf (param, sizeof param, "%s/load%u/find-hit", dist, max_load);
+  report ("ihash", param, nitems, now () - start, NULL);
+  if (found != nitems)
+    error (1, 0, "ihash: %zu of %zu keys found", found, nitems);
+
+  start = now ();
+  for (i = 0; i < nitems; i++)
+    found += hurd_ihash_find (&ht, misses[i]) != NULL;
+  snprintf (param, sizeof param, "%s/load%u/find-miss", dist, max_load);
+  report ("ihash", param, nitems, now () - start, NULL);
+
+  start = now ();
+  for (i = 0; i < nitems; i++)
+    hurd_ihash_remove (&ht, hits[i]);
+  snprintf (param, sizeof param, "%s/load%u/remove", dist, max_load);
+  report ("ihash", param, nitems, now () - start, NULL);
+
+  hurd_ihash_destroy (&ht);
+}
+
+/* Shared state of the contention benchmarks.  */
+struct contention
+{
+  pthread_rwlock_t lock;
+  struct hurd_ihash ht;
+  hurd_ihash_key_t *keys;
+  pthread_barrier_t barrier;
+};
+
+/* When the first of a group of threads started its measured work, and
+   when the last one finished.  */
+static uint64_t threads_start, threads_end;
+
+/* Wait at BARRIER until all threads are ready, and note the start.  */
+static void
+thread_begin (pthread_barrier_t *barrier)
+{
+  uint64_t start, old;
+
+  pthread_barrier_wait (barrier);
+  start = now ();
+  old = __atomic_load_n (&threads_start, __ATOMIC_RELAXED);
+  while ((old == 0 || start < old)
+	 && !__atomic_compare_exchange_n (&threads_start, &old, start, 0,
+					  __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+    ;
+}
+
+/* Note that the calling thread has finished its measured work.  */
+static void
+thread_end (void)
+{
+  uint64_t end = now (), old;
+
+  old = __atomic_load_n (&threads_end, __ATOMIC_RELAXED);
+  while (end > old
+	 && !__atomic_compare_exchange_n (&threads_end, &old, end, 0,
+					  __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+    ;
+}
+
+static void *
+ihash_reader (void *arg)
+{
+  struct contention *c = arg;
+  uint64_t state = (uintptr_t) &state | 1;
+  size_t i;
+
+  thread_begin (&c->barrier);
+  for (i = 0; i < nitems; i++)
+    {
+      hurd_ihash_key_t key = c->keys[zipf (&state, nitems)];
+      pthread_rwlock_rdlock (&c->lock);
+      if (!hurd_ihash_find (&c->ht, key))
+	abort ();
+      pthread_rwlock_unlock (&c->lock);
+    }
+  thread_end ();
+  return NULL;
+}
+
+/* Run NTHREADS copies of FN on ARG, and return how long they took from
+   the first one starting to the last one finishing.  FN must call
+   thread_begin with BARRIER and thread_end around its work.  */
+static uint64_t
+run_threads (unsigned nthreads, void *(*fn) (void *), void *arg,
+	     pthread_barrier_t *barrier)
+{
+  pthread_t threads[nthreads];
+  unsigned i;
+  int err;
+
+  threads_start = threads_end = 0;
+  pthread_barrier_init (barrier, NULL, nthreads);
+  for (i = 0; i < nthreads; i++)
+    {
+      err = pthread_create (&threads[i], NULL, fn, arg);
+      if (err)
+	error (1, err, "pthread_create");
+    }
+  for (i = 0; i < nthreads; i++)
+    pthread_join (threads[i], NULL);
+  pthread_barrier_destroy (barrier);
+  return threads_end - threads_start;
+}
+
+static void
+bench_ihash (void)
+{
+  static const unsigned loads[] = { 64, HURD_IHASH_MAX_LOAD_DEFAULT, 120, 0 };
+  hurd_ihash_key_t *keys = malloc (2 * nitems * sizeof *keys);
+  struct contention c;
+  uint64_t state = 0x9e3779b97f4a7c15;
+  char param[32];
+  unsigned d, l, n;
+  size_t i;
+
+  if (!keys)
+    error (1, errno, "ihash");
+
+  for (d = 0; dists[d].name; d++)
+    for (l = 0; loads[l]; l++)
+      {
+	(*dists[d].fill) (keys, 2 * nitems, &state);
+	/* Misses come from the same distribution, after the hits.  */
+	bench_ihash_dist (dists[d].name, keys, loads[l], &state);
+      }
+
+  /* Lookups from several threads, under a reader lock as libports
+     does for its port tables.  */
+  keys_port (keys, nitems, &state);
+  pthread_rwlock_init (&c.lock, NULL);
+  hurd_ihash_init (&c.ht, HURD_IHASH_NO_LOCP);
+  for (i = 0; i < nitems; i++)
+    hurd_ihash_add (&c.ht, keys[i], (void *) (keys[i] | 1));
+  c.keys = keys;
+  for (n = 1; n <= max_threads; n *= 2)
+    {
+      snprintf (param, sizeof param, "port/threads%u/find", n);
+      report ("ihash", param, (uint64_t) n * nitems,
+	      run_threads (n, ihash_reader, &c, &c.barrier), NULL);
+    }
+  hurd_ihash_destroy (&c.ht);
+  pthread_rwlock_destroy (&c.lock);
+
+  free (keys);
+}
+
+/* libhurd-slab.  */
+
+/* The size of a struct port_info on a 64-bit host, roughly.  */
+#define SLAB_OBJECT_SIZE 96
+
+/* Objects each thread keeps allocated at a time.  */
+#define SLAB_BATCH 64
+
+struct slab_contention
+{
+  hurd_slab_space_t space;
+  pthread_barrier_t barrier;
+};
+
+static void *
+slab_worker (void *arg)
+{
+  struct slab_contention *c = arg;
+  void *objs[SLAB_BATCH];
+  size_t i, j;
+
+  thread_begin (&c->barrier);
+  for (i = 0; i < nitems / SLAB_BATCH; i++)
+    {
+      for (j = 0; j < SLAB_BATCH; j++)
+	if (hurd_slab_alloc (c->space, &objs[j]))
+	  abort ();
+      for (j = 0; j < SLAB_BATCH; j++)
+	hurd_slab_dealloc (c->space, objs[j]);
+    }
+  thread_end ();
+  return NULL;
+}
+
+static void *
+malloc_worker (void *arg)
+{
+  pthread_barrier_t *barrier = arg;
+  void *objs[SLAB_BATCH];
+  size_t i, j;
+
+  thread_begin (barrier);
+  for (i = 0; i < nitems / SLAB_BATCH; i++)
+    {
+      for (j = 0; j < SLAB_BATCH; j++)
+	if (!(objs[j] = malloc (SLAB_OBJECT_SIZE)))
+	  abort ();
+      for (j = 0; j < SLAB_BATCH; j++)
+	free (objs[j]);
+    }
+  thread_end ();
+  return NULL;
+}
+
+static void
+bench_slab (void)
+{
+  struct slab_contention c;
+  pthread_barrier_t barrier;
+  void **objs = malloc (nitems * sizeof *objs);
+  uint64_t start, ops = nitems / SLAB_BATCH * SLAB_BATCH;
+  char param[32];
+  size_t i;
+  unsigned n;
+  error_t err;
+
+  if (!objs)
+    error (1, errno, "slab");
+  err = hurd_slab_create (SLAB_OBJECT_SIZE, 0, NULL, NULL, NULL, NULL, NULL,
+			  &c.space);
+  if (err)
+    error (1, err, "hurd_slab_create");
+
+  /* Grow the slab space to NITEMS objects, and shrink it again.  */
+  start = now ();
+  for (i = 0; i < nitems; i++)
+    if (hurd_slab_alloc (c.space, &objs[i]))
+      error (1, ENOMEM, "hurd_slab_alloc");
+  report ("slab", "alloc-grow", nitems, now () - start, NULL);
+
+  start = now ();
+  for (i = 0; i < nitems; i++)
+    hurd_slab_dealloc (c.space, objs[i]);
+  report ("slab", "dealloc", nitems, now () - start, NULL);
+
+  /* Steady state with memory already in the slab space, and malloc
+     for comparison.  */
+  for (n = 1; n <= max_threads; n *= 2)
+    {
+      snprintf (param, sizeof param, "threads%u/batch", n);
+      report ("slab", param, n * ops,
+	      run_threads (n, slab_worker, &c, &c.barrier), NULL);
+      snprintf (param, sizeof param, "threads%u/malloc", n);
+      report ("slab", param, n * ops,
+	      run_threads (n, malloc_worker, &barrier, &barrier), NULL);
+    }
+
+  hurd_slab_free (c.space);
+  free (objs);
+}
+
+/* libpipe's packet queues.  */
+
+/* Called by pq_dequeue for packets with a source address, which the
+   benchmark never sets.  */
+void
+pipe_dealloc_addr (void *addr)
+{
+  abort ();
+}
+
+static void
+bench_pq (void)
+{
+  static const size_t sizes[] = { 64, 1024, PACKET_SIZE_LARGE,
+				  4 * PACKET_SIZE_LARGE, 0 };
+  const size_t *size;
+  char *buf = malloc (4 * PACKET_SIZE_LARGE), *rbuf, *data;
+  char param[32];
+  struct pq *pq;
+  uint64_t start;
+  size_t i, ops = nitems / 10, len, amount;
+  error_t err;
+
+  rbuf = malloc (4 * PACKET_SIZE_LARGE);
+  if (!buf || !rbuf)
+    error (1, errno, "pq");
+  memset (buf, 0x5a, 4 * PACKET_SIZE_LARGE);
+
+  err = pq_create (&pq);
+  if (err)
+    error (1, err, "pq_create");
+
+  /* What a stream pipe does for each write followed by a read of the
+     same size: queue a packet, append the data, read it out, and
+     dequeue the packet once it is empty.  */
+  for (size = sizes; *size; size++)
+    {
+      start = now ();
+      for (i = 0; i < ops; i++)
+	{
+	  struct packet *packet = pq_queue (pq, PACKET_TYPE_DATA, NULL);
+	  if (!packet)
+	    error (1, ENOMEM, "pq_queue");
+	  err = packet_write (packet, buf, *size, &amount);
+	  if (err)
+	    error (1, err, "packet_write");
+
+	  data = rbuf;
+	  len = 4 * PACKET_SIZE_LARGE;
+	  err = packet_read (pq_head (pq, PACKET_TYPE_DATA, NULL),
+			     &data, &len, *size);
+	  if (err)
+	    error (1, err, "packet_read");
+	  if (data != rbuf)
+	    munmap (data, len);
+	  pq_dequeue (pq);
+	}
+      snprintf (param, sizeof param, "write-read:%zu", *size);
+      report ("pq", param, ops, now () - start, NULL);
+    }
+
+  /* Many small writes accumulating in one packet, as a busy pipe with
+     a slow reader sees them.  */
+  start = now ();
+  for (i = 0; i < ops; i++)
+    {
+      struct packet *packet = pq_tail (pq, PACKET_TYPE_DATA, NULL);
+      if (!packet || packet_readable (packet) >= 65536)
+	{
+	  pq_drain (pq);
+	  packet = pq_queue (pq, PACKET_TYPE_DATA, NULL);
+	  if (!packet)
+	    error (1, ENOMEM, "pq_queue");
+	}
+      err = packet_write (packet, buf, 64, &amount);
+      if (err)
+	error (1, err, "packet_write");
+    }
+  report ("pq", "append:64", ops, now () - start, NULL);
+
+  pq_free (pq);
+  free (rbuf);
+  free (buf);
+}
+
+/* libshouldbeinlibc's cacheq, used the way nfs's lookup cache does:
+   scan from the most recently used end, and reuse the least recently
+   used entry on a miss.  */
+
+struct cq_entry
+{
+  struct cacheq_hdr hdr;
+  size_t key;
+  int valid;
+};
+
+static void
+bench_cacheq (void)
+{
+  static const int lengths[] = { 64, 512, 0 };
+  const int *length;
+  uint64_t state = 0x2545f4914f6cdd1d;
+  char param[32], extra[32];
+
+  for (length = lengths; *length; length++)
+    {
+      struct cacheq cq = { sizeof (struct cq_entry) };
+      size_t i, hits = 0, universe = *length * 8;
+      uint64_t start;
+
+      if (cacheq_set_length (&cq, *length))
+	error (1, ENOMEM, "cacheq_set_length");
+
+      start = now ();
+      for (i = 0; i < nitems; i++)
+	{
+	  size_t key = zipf (&state, universe);
+	  struct cq_entry *e;
+
+	  for (e = cq.mru; e; e = e->hdr.next)
+	    if (e->valid && e->key == key)
+	      break;
+	  if (e)
+	    hits++;
+	  else
+	    {
+	      e = cq.lru;
+	      e->key = key;
+	      e->valid = 1;
+	    }
+	  cacheq_make_mru (&cq, e);
+	}
+      snprintf (param, sizeof param, "length%d/lookup", *length);
+      snprintf (extra, sizeof extra, "hit-rate=%.1f%%", hits * 100.0 / nitems);
+      report ("cacheq", param, nitems, now () - start, extra);
+
+      /* cacheq_set_length cannot shrink a cacheq to nothing.  */
+      free (cq.entries);
+    }
+}
+
+/* libdiskfs's name cache.  It holds 256 buckets of 4 entries, so the
+   files looked up are kept to that many, spread over NC_DIRS
+   directories; a bigger working set just measures misses.  As in
+   diskfs_S_dir_lookup, a name that misses is entered afterwards.  */
+
+#define NC_DIRS 16
+#define NC_FILES 1024
+
+static struct node *nodes;
+static size_t nnodes;
+struct node *diskfs_root_node;
+
+void
+diskfs_nref (struct node *np)
+{
+  __atomic_add_fetch (&np->references, 1, __ATOMIC_RELAXED);
+}
+
+void
+diskfs_nput (struct node *np)
+{
+  __atomic_sub_fetch (&np->references, 1, __ATOMIC_RELAXED);
+  pthread_mutex_unlock (&np->lock);
+}
+
+error_t
+diskfs_cached_lookup (ino64_t cache_id, struct node **npp)
+{
+  if (cache_id >= nnodes)
+    return ENOENT;
+  *npp = &nodes[cache_id];
+  diskfs_nref (*npp);
+  pthread_mutex_lock (&(*npp)->lock);
+  return 0;
+}
+
+/* Name of the Ith file of directory DIR.  */
+static void
+nc_name (char *buf, size_t len, size_t i)
+{
+  snprintf (buf, len, "file-%zu.c", i);
+}
+
+/* Look up the Ith file of directory D, entering it on a miss as
+   diskfs_S_dir_lookup would.  Return whether it was a hit.  */
+static int
+nc_lookup (size_t per_dir, size_t d, size_t i)
+{
+  struct node *dir = &nodes[1 + d], *np;
+  char name[32];
+
+  nc_name (name, sizeof name, i);
+  np = diskfs_check_lookup_cache (dir, name);
+  if (np && np != (struct node *) -1)
+    {
+      diskfs_nput (np);
+      return 1;
+    }
+  diskfs_enter_lookup_cache (dir, &nodes[1 + NC_DIRS + d * per_dir + i],
+			     name);
+  return 0;
+}
+
+struct nc_contention
+{
+  pthread_barrier_t barrier;
+  size_t per_dir;
+};
+
+static void *
+nc_reader (void *arg)
+{
+  struct nc_contention *c = arg;
+  uint64_t state = (uintptr_t) &state | 1;
+  size_t i;
+
+  thread_begin (&c->barrier);
+  for (i = 0; i < nitems; i++)
+    {
+      size_t d = rand64 (&state) % NC_DIRS;
+      nc_lookup (c->per_dir, d, zipf (&state, c->per_dir));
+    }
+  thread_end ();
+  return NULL;
+}
+
+static void
+bench_name_cache (void)
+{
+  struct nc_contention c;
+  uint64_t state = 0x5851f42d4c957f2d, start;
+  size_t i, d, found = 0;
+  char name[32], param[32], extra[32];
+  double hit_rate;
+  unsigned n;
+
+  /* Node 0 is unused since the cache treats it as a negative entry, and
+     nodes 1 to NC_DIRS are the directories.  */
+  c.per_dir = NC_FILES / NC_DIRS;
+  nnodes = 1 + NC_DIRS + NC_DIRS * c.per_dir;
+  nodes = calloc (nnodes, sizeof *nodes);
+  if (!nodes)
+    error (1, errno, "name-cache");
+  for (i = 0; i < nnodes; i++)
+    {
+      nodes[i].cache_id = i;
+      pthread_mutex_init (&nodes[i].lock, NULL);
+    }
+  diskfs_root_node = &nodes[1];
+
+  start = now ();
+  for (d = 0; d < NC_DIRS; d++)
+    for (i = 0; i < c.per_dir; i++)
+      {
+	nc_name (name, sizeof name, i);
+	diskfs_enter_lookup_cache (&nodes[1 + d],
+				   &nodes[1 + NC_DIRS + d * c.per_dir + i],
+				   name);
+      }
+  report ("name-cache", "enter", NC_DIRS * c.per_dir, now () - start, NULL);
+
+  /* Warm the cache up, so that the popular names have earned their
+     place.  */
+  for (i = 0; i < nitems; i++)
+    {
+      d = rand64 (&state) % NC_DIRS;
+      nc_lookup (c.per_dir, d, zipf (&state, c.per_dir));
+    }
+
+  start = now ();
+  for (i = 0; i < nitems; i++)
+    {
+      d = rand64 (&state) % NC_DIRS;
+      found += nc_lookup (c.per_dir, d, zipf (&state, c.per_dir));
+    }
+  hit_rate = found * 100.0 / nitems;
+  snprintf (extra, sizeof extra, "hit-rate=%.1f%%", hit_rate);
+  report ("name-cache", "check", nitems, now () - start, extra);
+  if (hit_rate < 50)
+    error (0, 0, "name-cache: hit rate only %.1f%%;"
+	   " the lookups mostly measure misses", hit_rate);
+
+  for (n = 1; n <= max_threads; n *= 2)
+    {
+      snprintf (param, sizeof param, "threads%u/check", n);
+      report ("name-cache", param, (uint64_t) n * nitems,
+	      run_threads (n, nc_reader, &c, &c.barrier), NULL);
+    }
+
+  free (nodes);
+  nodes = NULL;
+  nnodes = 0;
+}
+
+static const struct
+{
+  const char *name;
+  void (*run) (void);
+} benches[] =
+{
+  {"ihash", bench_ihash},
+  {"slab", bench_slab},
+  {"pq", bench_pq},
+  {"cacheq", bench_cacheq},
+  {"name-cache", bench_name_cache},
+  {0}
+};
+
+static const struct argp_option options[] =
+{
+  {"items",   'n', "N", 0, "Use N items or operations per measurement"
+   " (default 100000)"},
+  {"threads", 't', "N", 0, "Scale contention up to N threads (default 8)"},
+  {"machine", 'm', 0, 0, "Print results as tab separated values"},
+  {0}
+};
+static const char args_doc[] = "[BENCHMARK...]";
+static const char doc[] = "Benchmark Hurd data structure libraries."
+"\vThe benchmarks are ihash, slab, pq, cacheq and name-cache; without"
+" arguments, all are run.  Results are given as nanoseconds and millions"
+" of operations per second.";
+
+static int selected[sizeof benches / sizeof benches[0]];
+static int any_selected;
+
+static error_t
+parse_opt (int key, char *arg, struct argp_state *state)
+{
+  char *end;
+  int i;
+
+  switch (key)
+    {
+    case 'n':
+      nitems = strtoul (arg, &end, 10);
+      if (*end || nitems < 1000)
+	argp_error (state, "%s: Invalid count", arg);
+      break;
+    case 't':
+      max_threads = strtoul (arg, &end, 10);
+      if (*end || max_threads < 1 || max_threads > 256)
+	argp_error (state, "%s: Invalid thread count", arg);
+      break;
+    case 'm': machine = 1; break;
+
+    case ARGP_KEY_ARG:
+      for (i = 0; benches[i].name; i++)
+	if (strcmp (benches[i].name, arg) == 0)
+	  break;
+      if (!benches[i].name)
+	argp_error (state, "%s: Unknown benchmark", arg);
+      selected[i] = any_selected = 1;
+      break;
+
+    default:
+      return ARGP_ERR_UNKNOWN;
+    }
+  return 0;
+}
+
+int
+main (int argc, char **argv)
+{
+  struct argp argp = { options, parse_opt, args_doc, doc };
+  int i;
+
+  argp_parse (&argp, argc, argv, 0, 0, 0);
+
+  if (machine)
+    puts ("#bench\tparam\tops\tns_per_op\tmops\textra");
+  else
+    printf ("%-10s %-24s %10s %9s %9s\n", "BENCH", "PARAM", "OPS",
+	    "NS/OP", "MOPS/S");
+
+  for (i = 0; benches[i].name; i++)
+    if (!any_selected || selected[i])
+      (*benches[i].run) ();
+
+  return 0;
+}
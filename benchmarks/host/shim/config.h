@@ -0,0 +1 @@
+/* Nothing from configure is needed by the host builds.  */
@@ -0,0 +1,9 @@
+/* Mapping flags as the Hurd's libc interprets them, for host builds.
+
+   On the Hurd, an anonymous mapping that asks for neither MAP_SHARED nor
+   MAP_PRIVATE is private; other systems reject it.  */
+
+#include <sys/mman.h>
+
+#undef MAP_ANON
+#define MAP_ANON (MAP_ANONYMOUS | MAP_PRIVATE)
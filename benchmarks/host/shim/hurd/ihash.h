@@ -0,0 +1,2 @@
+/* Map the installed header name onto the one in the source tree.  */
+#include <libihash/ihash.h>
@@ -0,0 +1,95 @@
+/* Minimal Mach interfaces for building Hurd libraries on a POSIX host
+
+   Copyright (C) 2026 Free Software Foundation, Inc.
+
+   This file is part of the GNU Hurd.
+
+   The GNU Hurd is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation; either version 2, or (at
+   your option) any later version.
+
+   The GNU Hurd is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#ifndef _SHIM_MACH_H
+#define _SHIM_MACH_H
+
+#include <stdint.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+typedef unsigned int mach_port_t;
+typedef int kern_return_t;
+typedef uintptr_t vm_address_t;
+typedef uintptr_t vm_offset_t;
+typedef uintptr_t vm_size_t;
+typedef mach_port_t task_t;
+
+#define KERN_SUCCESS		0
+#define KERN_NO_SPACE		3
+#define MACH_PORT_NULL		((mach_port_t) 0)
+
+#define vm_page_size		((vm_size_t) getpagesize ())
+#define trunc_page(x)		((vm_offset_t) (x) & ~(vm_page_size - 1))
+#define round_page(x)		trunc_page ((vm_offset_t) (x) + vm_page_size - 1)
+
+/* Port rights are plain numbers here; counting deallocations is all the
+   harness needs of them.  */
+extern unsigned long shim_port_deallocations;
+
+static inline task_t
+mach_task_self (void)
+{
+  return 1;
+}
+
+static inline kern_return_t
+mach_port_deallocate (task_t task, mach_port_t name)
+{
+  (void) task;
+  (void) name;
+  shim_port_deallocations++;
+  return KERN_SUCCESS;
+}
+
+/* vm_allocate with ANYWHERE false must not replace existing mappings,
+   which is what libpipe relies on to grow packets in place.  */
+static inline kern_return_t
+vm_allocate (task_t task, vm_address_t *addr, vm_size_t size, int anywhere)
+{
+  int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+  void *want = anywhere ? NULL : (void *) *addr;
+  void *got;
+
+  (void) task;
+#ifdef MAP_FIXED_NOREPLACE
+  if (!anywhere)
+    flags |= MAP_FIXED_NOREPLACE;
+#endif
+  got = mmap (want, size, PROT_READ | PROT_WRITE, flags, -1, 0);
+  if (got == MAP_FAILED)
+    return KERN_NO_SPACE;
+  if (!anywhere && got != want)
+    {
+      munmap (got, size);
+      return KERN_NO_SPACE;
+    }
+  *addr = (vm_address_t) got;
+  return KERN_SUCCESS;
+}
+
+static inline kern_return_t
+vm_deallocate (task_t task, vm_address_t addr, vm_size_t size)
+{
+  (void) task;
+  munmap ((void *) addr, size);
+  return KERN_SUCCESS;
+}
+
+#endif /* _SHIM_MACH_H */
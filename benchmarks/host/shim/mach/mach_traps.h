@@ -0,0 +1,9 @@
+/* The Mach traps used by libshouldbeinlibc, for host builds.  */
+
+#include <stdio.h>
+
+static inline void
+mach_print (const char *s)
+{
+  fputs (s, stderr);
+}
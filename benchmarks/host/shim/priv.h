@@ -0,0 +1,48 @@
+/* The parts of libdiskfs's priv.h used by name-cache.c, for host builds
+
+   Copyright (C) 2026 Free Software Foundation, Inc.
+
+   This file is part of the GNU Hurd.
+
+   The GNU Hurd is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation; either version 2, or (at
+   your option) any later version.
+
+   The GNU Hurd is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#ifndef _SHIM_DISKFS_PRIV_H
+#define _SHIM_DISKFS_PRIV_H
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <sys/types.h>
+
+/* A node only needs its cache id and lock for the name cache.  The
+   harness keeps all of them in one table, indexed by cache id.  */
+struct node
+{
+  ino64_t cache_id;
+  pthread_mutex_t lock;
+  unsigned long references;
+};
+
+extern struct node *diskfs_root_node;
+
+void diskfs_nref (struct node *np);
+void diskfs_nput (struct node *np);
+error_t diskfs_cached_lookup (ino64_t cache_id, struct node **npp);
+
+void diskfs_enter_lookup_cache (struct node *dir, struct node *np,
+				const char *name);
+void diskfs_purge_lookup_cache (struct node *dp, struct node *np);
+struct node *diskfs_check_lookup_cache (struct node *dir, const char *name);
+
+#endif /* _SHIM_DISKFS_PRIV_H */
@@ -0,0 +1,149 @@
+/* io_read and io_write throughput
+
+   Copyright (C) 2026 Free Software Foundation, Inc.
+
+   This file is part of the GNU Hurd.
+
+   The GNU Hurd is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation; either version 2, or (at
+   your option) any later version.
+
+   The GNU Hurd is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include <errno.h>
+#include <error.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <hurd.h>
+#include <hurd/io.h>
+
+#include "bench.h"
+
+/* Operations cycle through this much of the file, so that the larger
+   transfer sizes do not grow it without bound.  */
+#define IO_WINDOW (4 * 1024 * 1024)
+
+static error_t
+io_write_op (file_t file, char *buf, size_t size, off_t offset)
+{
+  error_t err;
+  vm_size_t amount;
+
+  err = io_write (file, buf, size, offset, &amount);
+  if (!err && amount != size)
+    err = EIO;
+  return err;
+}
+
+static error_t
+io_read_op (file_t file, char *buf, size_t size, off_t offset)
+{
+  error_t err;
+  char *data = buf;
+  mach_msg_type_number_t len = size;
+
+  err = io_read (file, &data, &len, offset, size);
+  if (data != buf)
+    vm_deallocate (mach_task_self (), (vm_address_t) data, len);
+  if (!err && len != size)
+    err = EIO;
+  return err;
+}
+
+/* Time OP on FILE for each of the transfer sizes.  Writes run first, so
+   that the reads find the data they ask for.  */
+static error_t
+io_series (file_t file, char *buf, const char *what,
+	   error_t (*op) (file_t, char *, size_t, off_t))
+{
+  error_t err = 0;
+  struct bench_samples samples;
+  const size_t *size;
+  char param[32];
+  unsigned i;
+
+  bench_samples_init (&samples, bench_iterations);
+  for (size = bench_sizes; *size && !err; size++)
+    {
+      size_t slots = IO_WINDOW / *size;
+
+      for (i = 0; i < bench_warmup + bench_iterations; i++)
+	{
+	  uint64_t start = bench_now ();
+	  err = (*op) (file, buf, *size, (off_t) (i % slots) * *size);
+	  if (i >= bench_warmup)
+	    bench_sample_add (&samples, bench_now () - start);
+	  if (err)
+	    {
+	      error (0, err, "io: %s of %zu bytes", what, *size);
+	      break;
+	    }
+	}
+
+      if (!err)
+	{
+	  snprintf (param, sizeof param, "%s:%zu", what, *size);
+	  bench_report (&samples, "io", param, *size);
+	}
+    }
+  bench_samples_fini (&samples);
+
+  return err;
+}
+
+void
+bench_io (void)
+{
+  error_t err;
+  const size_t *size;
+  size_t max = 0;
+  char *path, *buf;
+  file_t file;
+
+  for (size = bench_sizes; *size; size++)
+    if (*size > max)
+      max = *size;
+  buf = malloc (max);
+  if (!buf)
+    {
+      error (0, errno, "io");
+      return;
+    }
+  memset (buf, 0xa5, max);
+
+  if (asprintf (&path, "%s/hurdbench-io.%d", bench_dir, getpid ()) < 0)
+    {
+      error (0, errno, "io");
+      free (buf);
+      return;
+    }
+
+  file = file_name_lookup (path, O_RDWR | O_CREAT | O_TRUNC, 0600);
+  if (file == MACH_PORT_NULL)
+    {
+      error (0, errno, "io: %s", path);
+      free (path);
+      free (buf);
+      return;
+    }
+  /* The file only needs to live as long as our port to it.  */
+  unlink (path);
+
+  err = io_series (file, buf, "write", io_write_op);
+  if (!err)
+    io_series (file, buf, "read", io_read_op);
+
+  mach_port_deallocate (mach_task_self (), file);
+  free (path);
+  free (buf);
+}
@@ -0,0 +1,148 @@
+/* Pipe and AF_UNIX stream throughput through pflocal
+
+   Copyright (C) 2026 Free Software Foundation, Inc.
+
+   This file is part of the GNU Hurd.
+
+   The GNU Hurd is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation; either version 2, or (at
+   your option) any later version.
+
+   The GNU Hurd is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include <errno.h>
+#include <error.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+
+#include "bench.h"
+
+/* Read and discard everything from the file descriptor ARG until end of
+   file.  */
+static void *
+drain (void *arg)
+{
+  int fd = (intptr_t) arg;
+  char buf[65536];
+
+  while (read (fd, buf, sizeof buf) > 0)
+    ;
+  return NULL;
+}
+
+/* Time writes of each transfer size into WFD while another thread reads
+   from RFD.  Once the buffer in pflocal has filled up, each write waits
+   for the reader, so the timings reflect the steady state.  Closes both
+   descriptors.  */
+static void
+stream (const char *name, int rfd, int wfd)
+{
+  struct bench_samples samples;
+  const size_t *size;
+  size_t max = 0;
+  pthread_t reader;
+  char param[32];
+  char *buf;
+  unsigned i;
+  int err;
+
+  for (size = bench_sizes; *size; size++)
+    if (*size > max)
+      max = *size;
+  buf = malloc (max);
+  if (!buf)
+    {
+      error (0, errno, "%s", name);
+      close (rfd);
+      close (wfd);
+      return;
+    }
+  memset (buf, 0x5a, max);
+
+  err = pthread_create (&reader, NULL, drain, (void *) (intptr_t) rfd);
+  if (err)
+    {
+      error (0, err, "%s: creating reader thread", name);
+      close (rfd);
+      close (wfd);
+      free (buf);
+      return;
+    }
+
+  bench_samples_init (&samples, bench_iterations);
+  for (size = bench_sizes; *size && !err; size++)
+    {
+      for (i = 0; i < bench_warmup + bench_iterations; i++)
+	{
+	  size_t done = 0;
+	  uint64_t start = bench_now ();
+
+	  while (done < *size)
+	    {
+	      ssize_t n = write (wfd, buf + done, *size - done);
+	      if (n < 0)
+		{
+		  err = errno;
+		  break;
+		}
+	      done += n;
+	    }
+	  if (i >= bench_warmup)
+	    bench_sample_add (&samples, bench_now () - start);
+	  if (err)
+	    {
+	      error (0, err, "%s: write of %zu bytes", name, *size);
+	      break;
+	    }
+	}
+
+      if (!err)
+	{
+	  snprintf (param, sizeof param, "write:%zu", *size);
+	  bench_report (&samples, name, param, *size);
+	}
+    }
+  bench_samples_fini (&samples);
+
+  close (wfd);
+  pthread_join (reader, NULL);
+  close (rfd);
+  free (buf);
+}
+
+void
+bench_pipe (void)
+{
+  int fds[2];
+
+  if (pipe (fds) < 0)
+    error (0, errno, "pipe");
+  else
+    stream ("pipe", fds[0], fds[1]);
+}
+
+void
+bench_unix (void)
+{
+  int fds[2];
+
+  if (socketpair (AF_UNIX, SOCK_STREAM, 0, fds) < 0)
+    error (0, errno, "unix: socketpair");
+  else
+    {
+      shutdown (fds[0], SHUT_WR);
+      shutdown (fds[1], SHUT_RD);
+      stream ("unix", fds[0], fds[1]);
+    }
+}
@@ -0,0 +1,154 @@
+/* dir_lookup latency by path depth
+
+   Copyright (C) 2026 Free Software Foundation, Inc.
+
+   This file is part of the GNU Hurd.
+
+   The GNU Hurd is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation; either version 2, or (at
+   your option) any later version.
+
+   The GNU Hurd is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include <errno.h>
+#include <error.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <hurd.h>
+#include <hurd/fs.h>
+
+#include "bench.h"
+
+#define LOOKUP_MAX_DEPTH 16
+
+static const int depths[] = { 1, 2, 4, 8, LOOKUP_MAX_DEPTH, 0 };
+
+/* Store in BUF the relative path d/d/.../d with DEPTH components.  */
+static void
+make_path (char *buf, int depth)
+{
+  int i;
+  for (i = 0; i < depth; i++)
+    {
+      *buf++ = 'd';
+      *buf++ = '/';
+    }
+  buf[-1] = '\0';
+}
+
+void
+bench_lookup (void)
+{
+  error_t err = 0;
+  struct bench_samples samples;
+  char path[2 * LOOKUP_MAX_DEPTH];
+  char param[16];
+  char *base, *full;
+  file_t dir;
+  const int *depth;
+  int made, i;
+
+  if (asprintf (&base, "%s/hurdbench-lookup.%d", bench_dir, getpid ()) < 0)
+    {
+      error (0, errno, "lookup");
+      return;
+    }
+  full = malloc (strlen (base) + 1 + sizeof path);
+  if (!full)
+    {
+      error (0, errno, "lookup");
+      free (base);
+      return;
+    }
+
+  /* Build BASE/d/d/.../d, one level at a time.  */
+  for (made = 0; made <= LOOKUP_MAX_DEPTH; made++)
+    {
+      if (made == 0)
+	strcpy (full, base);
+      else
+	{
+	  make_path (path, made);
+	  sprintf (full, "%s/%s", base, path);
+	}
+      if (mkdir (full, 0700) < 0)
+	{
+	  err = errno;
+	  error (0, err, "lookup: %s", full);
+	  break;
+	}
+    }
+
+  dir = MACH_PORT_NULL;
+  if (!err)
+    {
+      dir = file_name_lookup (base, O_RDONLY | O_DIRECTORY, 0);
+      if (dir == MACH_PORT_NULL)
+	{
+	  err = errno;
+	  error (0, err, "lookup: %s", base);
+	}
+    }
+
+  bench_samples_init (&samples, bench_iterations);
+  for (depth = depths; *depth && !err; depth++)
+    {
+      make_path (path, *depth);
+
+      for (i = 0; i < bench_warmup + bench_iterations; i++)
+	{
+	  retry_type retry;
+	  string_t retryname;
+	  mach_port_t port;
+	  uint64_t start = bench_now ();
+
+	  err = dir_lookup (dir, path, O_RDONLY, 0, &retry, retryname, &port);
+	  if (i >= bench_warmup)
+	    bench_sample_add (&samples, bench_now () - start);
+	  if (!err && (retry != FS_RETRY_NORMAL || retryname[0] != '\0'))
+	    /* Something in the tree is a translator; that would not
+	       measure a single server.  */
+	    err = EXDEV;
+	  if (err)
+	    {
+	      error (0, err, "lookup: %s/%s", base, path);
+	      break;
+	    }
+	  mach_port_deallocate (mach_task_self (), port);
+	}
+
+      if (!err)
+	{
+	  snprintf (param, sizeof param, "depth:%d", *depth);
+	  bench_report (&samples, "lookup", param, 0);
+	}
+    }
+  bench_samples_fini (&samples);
+
+  if (dir != MACH_PORT_NULL)
+    mach_port_deallocate (mach_task_self (), dir);
+
+  /* Remove the tree, innermost directory first.  */
+  while (made-- > 1)
+    {
+      make_path (path, made);
+      sprintf (full, "%s/%s", base, path);
+      rmdir (full);
+    }
+  if (made == 0)
+    rmdir (base);
+
+  free (full);
+  free (base);
+}
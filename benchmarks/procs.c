@@ -0,0 +1,83 @@
+/* fork and fork+exec latency
+
+   Copyright (C) 2026 Free Software Foundation, Inc.
+
+   This file is part of the GNU Hurd.
+
+   The GNU Hurd is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation; either version 2, or (at
+   your option) any later version.
+
+   The GNU Hurd is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include <errno.h>
+#include <error.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include "bench.h"
+
+/* The program run by the exec measurement.  */
+#define EXEC_PROGRAM "/bin/true"
+
+/* Time creating a child which exits at once, or execs EXEC_PROGRAM if
+   EXEC is set, up to the point where the parent has reaped it.  */
+static void
+spawn (const char *param, int exec)
+{
+  struct bench_samples samples;
+  unsigned i;
+
+  bench_samples_init (&samples, bench_iterations);
+  for (i = 0; i < bench_warmup + bench_iterations; i++)
+    {
+      uint64_t start = bench_now ();
+      int status;
+      pid_t pid, reaped;
+
+      pid = fork ();
+      if (pid < 0)
+	{
+	  error (0, errno, "fork");
+	  break;
+	}
+      if (pid == 0)
+	{
+	  if (exec)
+	    execl (EXEC_PROGRAM, EXEC_PROGRAM, (char *) NULL);
+	  _exit (exec ? 127 : 0);
+	}
+      while ((reaped = waitpid (pid, &status, 0)) < 0 && errno == EINTR)
+	;
+      if (reaped < 0)
+	{
+	  error (0, errno, "fork: %s: waitpid", param);
+	  break;
+	}
+      if (i >= bench_warmup)
+	bench_sample_add (&samples, bench_now () - start);
+
+      if (!WIFEXITED (status) || WEXITSTATUS (status) != 0)
+	{
+	  error (0, 0, "fork: %s: child failed", param);
+	  break;
+	}
+    }
+  if (i == bench_warmup + bench_iterations)
+    bench_report (&samples, "fork", param, 0);
+  bench_samples_fini (&samples);
+}
+
+void
+bench_fork (void)
+{
+  spawn ("exit", 0);
+  spawn ("exec", 1);
+}
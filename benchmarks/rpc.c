@@ -0,0 +1,121 @@
+/* Null RPC round trip through libports
+
+   Copyright (C) 2026 Free Software Foundation, Inc.
+
+   This file is part of the GNU Hurd.
+
+   The GNU Hurd is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation; either version 2, or (at
+   your option) any later version.
+
+   The GNU Hurd is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include <error.h>
+#include <pthread.h>
+#include <hurd.h>
+#include <hurd/ports.h>
+#include <hurd/interrupt.h>
+
+#include "bench.h"
+#include "libports/interrupt_S.h"
+
+static int
+demuxer (mach_msg_header_t *inp, mach_msg_header_t *outp)
+{
+  mig_routine_t routine;
+  if ((routine = ports_interrupt_server_routine (inp)))
+    {
+      (*routine) (inp, outp);
+      return TRUE;
+    }
+  return FALSE;
+}
+
+static void *
+serve_one_thread (void *arg)
+{
+  ports_manage_port_operations_one_thread (arg, demuxer, 0);
+  return NULL;
+}
+
+static void *
+serve_multithread (void *arg)
+{
+  ports_manage_port_operations_multithread (arg, demuxer, 0, 0, 0);
+  return NULL;
+}
+
+/* Time interrupt_operation calls on a port served by SERVE, which does
+   nothing in the server beyond libports' own bookkeeping.  */
+static void
+rpc_round_trip (const char *param, void *(*serve) (void *))
+{
+  error_t err;
+  struct port_bucket *bucket;
+  struct port_class *class;
+  struct port_info *pi;
+  struct bench_samples samples;
+  mach_port_t port;
+  pthread_t thread;
+  unsigned i;
+
+  bucket = ports_create_bucket ();
+  class = ports_create_class (0, 0);
+  if (!bucket || !class)
+    {
+      error (0, errno, "rpc: creating port bucket");
+      return;
+    }
+
+  err = ports_create_port (class, bucket, sizeof *pi, &pi);
+  if (err)
+    {
+      error (0, err, "rpc: creating port");
+      return;
+    }
+  port = ports_get_send_right (pi);
+  ports_port_deref (pi);
+
+  err = pthread_create (&thread, NULL, serve, bucket);
+  if (err)
+    {
+      error (0, err, "rpc: creating server thread");
+      return;
+    }
+  pthread_detach (thread);
+
+  bench_samples_init (&samples, bench_iterations);
+  for (i = 0; i < bench_warmup + bench_iterations; i++)
+    {
+      uint64_t start = bench_now ();
+      err = interrupt_operation (port, 0);
+      if (i >= bench_warmup)
+	bench_sample_add (&samples, bench_now () - start);
+      if (err)
+	{
+	  error (0, err, "rpc: interrupt_operation");
+	  break;
+	}
+    }
+  if (!err)
+    bench_report (&samples, "rpc", param, 0);
+  bench_samples_fini (&samples);
+
+  /* The server thread keeps running; it has nothing more to do once the
+     send right is gone.  */
+  mach_port_deallocate (mach_task_self (), port);
+}
+
+void
+bench_rpc (void)
+{
+  rpc_round_trip ("one-thread", serve_one_thread);
+  rpc_round_trip ("multithread", serve_multithread);
+}
@@ -1,6 +1,6 @@
 /* Load a task using the single server, and then run it
    as if we were the kernel.
-   Copyright (C) 1993,94,95,96,97,98,99,2000,01,02,2006,14,16
+   Copyright (C) 1993,94,95,96,97,98,99,2000,01,02,2006,14,16,26
      Free Software Foundation, Inc.
 
    This file is part of the GNU Hurd.
@@ -271,6 +271,7 @@ boot_demuxer (mach_msg_header_t *inp,
 
 static void read_reply (void);
 static void * msg_thread (void *);
+static error_t start_msg_thread (void);
 
 const char *argp_program_version = STANDARD_HURD_VERSION (boot);
 
@@ -538,7 +539,6 @@ main (int argc, char **argv, char **envp)
   error_t err;
   mach_port_t foo;
   char *buf = 0;
-  pthread_t pthread_id;
   char *root_store_name;
   const struct argp_child kids[] = { { &store_argp, 0, "Store options:", -2 },
                                      { 0 }};
@@ -753,10 +753,8 @@ main (int argc, char **argv, char **envp)
 
   mach_port_deallocate (mach_task_self (), pseudo_master_device_port);
 
-  err = pthread_create (&pthread_id, NULL, msg_thread, NULL);
-  if (!err)
-    pthread_detach (pthread_id);
-  else
+  err = start_msg_thread ();
+  if (err)
     {
       errno = err;
       perror ("pthread_create");
@@ -775,11 +773,89 @@ main (int argc, char **argv, char **envp)
     }
 }
 
-void * __attribute__ ((noreturn))
+/* The subhurd's RPCs are served by a pool of threads, so that one of
+   them blocking, in a console select or in I/O on the root store, does
+   not hold up the others.  As in libports, a new thread is started
+   whenever the last idle one picks up a message, and threads beyond
+   the first exit after being idle for THREAD_TIMEOUT milliseconds.  */
+#define THREAD_TIMEOUT	(1000 * 60 * 2)
+
+static pthread_mutex_t msg_threads_lock = PTHREAD_MUTEX_INITIALIZER;
+static int msg_threads, idle_msg_threads;
+
+static error_t
+start_msg_thread (void)
+{
+  pthread_t thread;
+  error_t err;
+
+  pthread_mutex_lock (&msg_threads_lock);
+  msg_threads++;
+  idle_msg_threads++;
+  pthread_mutex_unlock (&msg_threads_lock);
+
+  err = pthread_create (&thread, NULL, msg_thread, NULL);
+  if (err)
+    {
+      pthread_mutex_lock (&msg_threads_lock);
+      msg_threads--;
+      idle_msg_threads--;
+      pthread_mutex_unlock (&msg_threads_lock);
+      return err;
+    }
+
+  pthread_detach (thread);
+  return 0;
+}
+
+static boolean_t
+msg_thread_demuxer (mach_msg_header_t *inp, mach_msg_header_t *outp)
+{
+  boolean_t handled;
+  int spawn;
+
+  pthread_mutex_lock (&msg_threads_lock);
+  spawn = --idle_msg_threads == 0;
+  pthread_mutex_unlock (&msg_threads_lock);
+
+  if (spawn)
+    {
+      error_t err = start_msg_thread ();
+      if (err)
+	error (0, err, "pthread_create");
+    }
+
+  handled = boot_demuxer (inp, outp);
+
+  pthread_mutex_lock (&msg_threads_lock);
+  idle_msg_threads++;
+  pthread_mutex_unlock (&msg_threads_lock);
+
+  return handled;
+}
+
+static void *
 msg_thread (void *arg)
 {
-  while (1)
-    mach_msg_server (boot_demuxer, 0, receive_set);
+  mach_msg_return_t err;
+
+  for (;;)
+    {
+      err = mach_msg_server_timeout (msg_thread_demuxer, 0, receive_set,
+				     MACH_RCV_TIMEOUT, THREAD_TIMEOUT);
+      if (err != MACH_RCV_TIMED_OUT)
+	continue;
+
+      pthread_mutex_lock (&msg_threads_lock);
+      if (msg_threads > 1 && idle_msg_threads > 1)
+	{
+	  msg_threads--;
+	  idle_msg_threads--;
+	  pthread_mutex_unlock (&msg_threads_lock);
+	  return NULL;
+	}
+      pthread_mutex_unlock (&msg_threads_lock);
+    }
 }
 
 
@@ -950,7 +1026,7 @@ ds_device_open (mach_port_t master_port,
 			      pseudo_console, MACH_MSG_TYPE_MAKE_SEND);
       console_send_rights++;
 #endif
-      console_mscount++;
+      __atomic_add_fetch (&console_mscount, 1, __ATOMIC_RELAXED);
       *device = pseudo_console;
       *devicetype = MACH_MSG_TYPE_MAKE_SEND;
       return 0;
@@ -1041,7 +1117,12 @@ ds_device_write (device_t device,
   else if (device == pseudo_root)
     {
       size_t wrote;
-      if (store_write (root_store, recnum, data, datalen, &wrote) != 0)
+      error_t err;
+
+      root_pager_sync (recnum, datalen);
+      err = store_write (root_store, recnum, data, datalen, &wrote);
+      root_pager_flush (recnum, datalen);
+      if (err)
 	return D_IO_ERROR;
       *bytes_written = wrote;
       return D_SUCCESS;
@@ -1078,7 +1159,12 @@ ds_device_write_inband (device_t device,
   else if (device == pseudo_root)
     {
       size_t wrote;
-      if (store_write (root_store, recnum, data, datalen, &wrote) != 0)
+      error_t err;
+
+      root_pager_sync (recnum, datalen);
+      err = store_write (root_store, recnum, data, datalen, &wrote);
+      root_pager_flush (recnum, datalen);
+      if (err)
 	return D_IO_ERROR;
       *bytes_written = wrote;
       return D_SUCCESS;
@@ -1132,6 +1218,7 @@ ds_device_read (device_t device,
   else if (device == pseudo_root)
     {
       size_t data_size = 0;
+      root_pager_sync (recnum, bytes_wanted);
       err = store_read (root_store, recnum, bytes_wanted, (void **)data, &data_size);
       if (err)
         return D_IO_ERROR;
@@ -1190,6 +1277,7 @@ ds_device_read_inband (device_t device,
       void *returned = data;
       size_t data_size = bytes_wanted;
 
+      root_pager_sync (recnum, bytes_wanted);
       err = store_read (root_store, recnum, bytes_wanted,
 			(void **)&returned, &data_size);
       *datalen = data_size;
@@ -1218,8 +1306,19 @@ ds_device_map (device_t device,
 	       memory_object_t *pager,
 	       int unmap)
 {
-  if (device == pseudo_console || device == pseudo_root)
+  if (device == pseudo_console)
     return D_INVALID_OPERATION;
+  else if (device == pseudo_root)
+    {
+      error_t err = root_store_map (prot, pager);
+      if (err == EROFS)
+	return D_READ_ONLY;
+      else if (err == EOPNOTSUPP)
+	return D_INVALID_OPERATION;
+      else if (err)
+	return D_IO_ERROR;
+      return D_SUCCESS;
+    }
   else if (device == pseudo_time)
     {
       error_t err;
@@ -1342,6 +1441,7 @@ do_mach_notify_no_senders (mach_port_t notify,
 {
   static int no_console;
   mach_port_t foo;
+  int console_made = __atomic_load_n (&console_mscount, __ATOMIC_RELAXED);
   if (notify == pseudo_master_device_port)
     {
       if (no_console)
@@ -1351,7 +1451,7 @@ do_mach_notify_no_senders (mach_port_t notify,
     }
   if (notify == pseudo_console)
     {
-      if (mscount == console_mscount &&
+      if (mscount == console_made &&
 	  pseudo_master_device_port == MACH_PORT_NULL)
 	{
 	bye:
@@ -1361,13 +1461,13 @@ do_mach_notify_no_senders (mach_port_t notify,
 	}
       else
 	{
-	  no_console = (mscount == console_mscount);
+	  no_console = (mscount == console_made);
 
 	  mach_port_request_notification (mach_task_self (), pseudo_console,
 					  MACH_NOTIFY_NO_SENDERS,
-					  console_mscount == mscount
+					  console_made == mscount
 					  ? mscount + 1
-					  : console_mscount,
+					  : console_made,
 					  pseudo_console,
 					  MACH_MSG_TYPE_MAKE_SEND_ONCE, &foo);
 	  if (foo != MACH_PORT_NULL)
@@ -1711,7 +1811,7 @@ S_io_restrict_auth (mach_port_t object,
     return EOPNOTSUPP;
   *newobject = pseudo_console;
   *newobjtype = MACH_MSG_TYPE_MAKE_SEND;
-  console_mscount++;
+  __atomic_add_fetch (&console_mscount, 1, __ATOMIC_RELAXED);
   return 0;
 }
 
@@ -1726,7 +1826,7 @@ S_io_duplicate (mach_port_t object,
     return EOPNOTSUPP;
   *newobj = pseudo_console;
   *newobjtype = MACH_MSG_TYPE_MAKE_SEND;
-  console_mscount++;
+  __atomic_add_fetch (&console_mscount, 1, __ATOMIC_RELAXED);
   return 0;
 }
 
@@ -2030,6 +2130,7 @@ task_ihash_cleanup (hurd_ihash_value_t value, void *cookie)
 static struct hurd_ihash task_ihash =
   HURD_IHASH_INITIALIZER_GKI (HURD_IHASH_NO_LOCP, task_ihash_cleanup, NULL,
                               NULL, NULL);
+static pthread_mutex_t task_ihash_lock = PTHREAD_MUTEX_INITIALIZER;
 
 static void
 task_died (mach_port_t name)
@@ -2037,7 +2138,9 @@ task_died (mach_port_t name)
   if (verbose > 1)
     fprintf (stderr, "Task '%u' died.\r\n", name);
 
+  pthread_mutex_lock (&task_ihash_lock);
   hurd_ihash_remove (&task_ihash, (hurd_ihash_key_t) name);
+  pthread_mutex_unlock (&task_ihash_lock);
 }
 
 /* Handle new task notifications from proc.  */
@@ -2065,9 +2168,11 @@ S_mach_notify_new_task (mach_port_t notify,
   assert_backtrace (! MACH_PORT_VALID (previous));
 
   mach_port_mod_refs (mach_task_self (), task, MACH_PORT_RIGHT_SEND, +1);
+  pthread_mutex_lock (&task_ihash_lock);
   err = hurd_ihash_add (&task_ihash,
                         (hurd_ihash_key_t) task,
 			(hurd_ihash_value_t)(uintptr_t) task);
+  pthread_mutex_unlock (&task_ihash_lock);
   if (err)
     {
       mach_port_deallocate (mach_task_self (), task);
@@ -2095,8 +2200,11 @@ S_processor_set_tasks(mach_port_t processor_set,
   error_t err;
   size_t i;
 
+  pthread_mutex_lock (&task_ihash_lock);
+
   if (!task_ihash.nr_items)
     {
+      pthread_mutex_unlock (&task_ihash_lock);
       *task_listCnt = 0;
       return 0;
     }
@@ -2104,7 +2212,10 @@ S_processor_set_tasks(mach_port_t processor_set,
   err = vm_allocate (mach_task_self (), (vm_address_t *) task_list,
 		     task_ihash.nr_items * sizeof **task_list, 1);
   if (err)
-    return err;
+    {
+      pthread_mutex_unlock (&task_ihash_lock);
+      return err;
+    }
 
   /* The first task has to be the kernel.  */
   (*task_list)[0] = pseudo_kernel;
@@ -2121,5 +2232,6 @@ S_processor_set_tasks(mach_port_t processor_set,
     }
 
   *task_listCnt = task_ihash.nr_items;
+  pthread_mutex_unlock (&task_ihash_lock);
   return 0;
 }
@@ -0,0 +1,260 @@
+/* Paging on the subhurd's root store
+
+   Copyright (C) 2026 Free Software Foundation, Inc.
+
+   This file is part of the GNU Hurd.
+
+   The GNU Hurd is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation; either version 2, or (at
+   your option) any later version.
+
+   The GNU Hurd is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with the GNU Hurd.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include <hurd.h>
+#include <hurd/pager.h>
+#include <hurd/store.h>
+#include <assert-backtrace.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <error.h>
+#include <errno.h>
+
+#include "private.h"
+
+struct user_pager_info
+{
+  struct store *store;
+};
+
+/* The pager on ROOT_STORE, or NULL if there currently is none.  */
+static struct pager *root_pager;
+static pthread_mutex_t root_pager_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static struct port_bucket *pager_bucket;
+static struct pager_requests *pager_requests;
+
+/* Pager library callbacks; see <hurd/pager.h> for more info.  */
+
+error_t
+pager_read_page (struct user_pager_info *upi,
+		 vm_offset_t page, vm_address_t *buf, int *writelock)
+{
+  struct store *store = upi->store;
+  size_t want = vm_page_size;
+  size_t read = 0;
+  void *data = NULL;
+  error_t err;
+
+  if (page + want > store->size)
+    /* Read a partial page if necessary to avoid reading off the end.  */
+    want = store->size - page;
+
+  err = store_read (store, page >> store->log2_block_size, want,
+		    &data, &read);
+  if (err || read < want)
+    {
+      if (!err)
+	munmap (data, read);
+      return EIO;
+    }
+
+  if (want < vm_page_size)
+    /* Zero anything we didn't read.  Allocation only happens in page-size
+       multiples, so we know we can write there.  */
+    memset ((char *) data + want, '\0', vm_page_size - want);
+
+  *buf = (vm_address_t) data;
+  *writelock = (store->flags & STORE_READONLY);
+  return 0;
+}
+
+error_t
+pager_write_page (struct user_pager_info *upi,
+		  vm_offset_t page, vm_address_t buf)
+{
+  struct store *store = upi->store;
+  size_t want = vm_page_size;
+  size_t written;
+  error_t err;
+
+  if (store->flags & STORE_READONLY)
+    return EROFS;
+
+  if (page + want > store->size)
+    /* Write a partial page if necessary to avoid writing off the end.  */
+    want = store->size - page;
+
+  err = store_write (store, page >> store->log2_block_size,
+		     (void *) buf, want, &written);
+  if (err || written < want)
+    return EIO;
+  return 0;
+}
+
+error_t
+pager_unlock_page (struct user_pager_info *upi, vm_offset_t address)
+{
+  if (upi->store->flags & STORE_READONLY)
+    return EROFS;
+  return 0;
+}
+
+void
+pager_notify_evict (struct user_pager_info *upi, vm_offset_t page)
+{
+  assert_backtrace (!"unrequested notification on eviction");
+}
+
+error_t
+pager_report_extent (struct user_pager_info *upi,
+		     vm_address_t *offset, vm_size_t *size)
+{
+  *offset = 0;
+  *size = upi->store->size;
+  return 0;
+}
+
+void
+pager_clear_user_data (struct user_pager_info *upi)
+{
+  pthread_mutex_lock (&root_pager_lock);
+  if (root_pager && pager_get_upi (root_pager) == upi)
+    root_pager = NULL;
+  pthread_mutex_unlock (&root_pager_lock);
+}
+
+void
+pager_dropweak (struct user_pager_info *upi)
+{
+}
+
+/* Return in MEMOBJ a memory object for ROOT_STORE.  If the store can
+   be mapped directly, that is what the subhurd gets; otherwise we page
+   it ourselves.  */
+error_t
+root_store_map (vm_prot_t prot, memory_object_t *memobj)
+{
+  error_t err;
+  int created = 0;
+
+  if ((prot & VM_PROT_WRITE) && (root_store->flags & STORE_READONLY))
+    return EROFS;
+
+  err = store_map (root_store, prot, memobj);
+  if (err != EOPNOTSUPP)
+    return err;
+
+  pthread_mutex_lock (&root_pager_lock);
+
+  if (pager_bucket == NULL)
+    {
+      pager_bucket = ports_create_bucket ();
+      err = pager_start_workers (pager_bucket, &pager_requests);
+      if (err)
+	{
+	  pthread_mutex_unlock (&root_pager_lock);
+	  error (0, err, "pager_start_workers");
+	  return err;
+	}
+    }
+
+  if (root_pager == NULL)
+    {
+      root_pager = pager_create_alloc (sizeof (struct user_pager_info),
+				       pager_bucket,
+				       1, MEMORY_OBJECT_COPY_DELAY, 0);
+      if (root_pager == NULL)
+	{
+	  err = errno;
+	  pthread_mutex_unlock (&root_pager_lock);
+	  return err;
+	}
+      pager_get_upi (root_pager)->store = root_store;
+      created = 1;
+    }
+
+  *memobj = pager_get_port (root_pager);
+  if (*memobj == MACH_PORT_NULL)
+    /* Pager is currently being destroyed, try again.  */
+    {
+      root_pager = NULL;
+      pthread_mutex_unlock (&root_pager_lock);
+      return root_store_map (prot, memobj);
+    }
+
+  err = mach_port_insert_right (mach_task_self (), *memobj, *memobj,
+				MACH_MSG_TYPE_MAKE_SEND);
+  if (created)
+    ports_port_deref (root_pager);
+
+  pthread_mutex_unlock (&root_pager_lock);
+  return err;
+}
+
+/* Return a reference to the pager on ROOT_STORE, or NULL.  */
+static struct pager *
+root_pager_get (void)
+{
+  struct pager *pager;
+
+  pthread_mutex_lock (&root_pager_lock);
+  pager = root_pager;
+  if (pager)
+    ports_port_ref (pager);
+  pthread_mutex_unlock (&root_pager_lock);
+  return pager;
+}
+
+/* Page-align the byte range of LEN bytes at block ADDR of ROOT_STORE
+   in *START and *SIZE.  */
+static void
+root_pager_range (store_offset_t addr, size_t len,
+		  vm_offset_t *start, vm_size_t *size)
+{
+  vm_offset_t offset = addr << root_store->log2_block_size;
+
+  *start = trunc_page (offset);
+  *size = round_page (offset + len) - *start;
+}
+
+/* Write back whatever the subhurd has dirtied through a mapping of the
+   LEN bytes at block ADDR, so that reading or writing them by RPC sees
+   the same data as the mapping.  */
+void
+root_pager_sync (store_offset_t addr, size_t len)
+{
+  struct pager *pager = root_pager_get ();
+  vm_offset_t start;
+  vm_size_t size;
+
+  if (! pager)
+    return;
+
+  root_pager_range (addr, len, &start, &size);
+  pager_sync_some (pager, start, size, 1);
+  ports_port_deref (pager);
+}
+
+/* Throw away the cached pages covering the LEN bytes at block ADDR,
+   which have just been written by RPC.  */
+void
+root_pager_flush (store_offset_t addr, size_t len)
+{
+  struct pager *pager = root_pager_get ();
+  vm_offset_t start;
+  vm_size_t size;
+
+  if (! pager)
+    return;
+
+  root_pager_range (addr, len, &start, &size);
+  pager_flush_some (pager, start, size, 1);
+  ports_port_deref (pager);
+}
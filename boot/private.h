@@ -1,6 +1,6 @@
 /* Boot boots Subhurds.
 
-   Copyright (C) 2017 Free Software Foundation, Inc.
+   Copyright (C) 2017, 2026 Free Software Foundation, Inc.
 
    This file is part of the GNU Hurd.
 
@@ -20,6 +20,15 @@
 #ifndef BOOT_PRIVATE_H
 #define BOOT_PRIVATE_H
 
+#include <mach.h>
+#include <hurd/store.h>
+
 extern int verbose;
+extern struct store *root_store;
+
+/* In pager.c.  */
+error_t root_store_map (vm_prot_t prot, memory_object_t *memobj);
+void root_pager_sync (store_offset_t addr, size_t len);
+void root_pager_flush (store_offset_t addr, size_t len);
 
 #endif /* BOOT_PRIVATE_H */
@@ -108,13 +108,24 @@ chmod 664 /etc/motd
 
 echo -n starting daemons:
 
+# Start a daemon in the background, and report it once it has detached.
+start_daemon() {
+  local name="$1"
+  shift
+  { "$@" && echo -n " $name"; } &
+}
+
+# Everything else logs through syslogd, so start it first.  The other
+# daemons do not depend on each other and are started concurrently.
 /sbin/syslogd	&& echo -n ' syslogd'
-/sbin/inetd	&& echo -n ' inetd'
+
+start_daemon inetd /sbin/inetd
 
 if test -x /sbin/sendmail -a -r /etc/sendmail.cf; then
-  /sbin/sendmail -bd -q30m	&& echo -n ' sendmail'
+  start_daemon sendmail /sbin/sendmail -bd -q30m
 fi
 
+wait
 echo .
 
 date
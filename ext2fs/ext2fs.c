@@ -1,6 +1,6 @@
 /* Main entry point for the ext2 file system translator
 
-   Copyright (C) 1994,95,96,97,98,99,2002 Free Software Foundation, Inc.
+   Copyright (C) 1994,95,96,97,98,99,2002,2026 Free Software Foundation, Inc.
 
    Converted for ext2fs by Miles Bader <miles@gnu.ai.mit.edu>
 
@@ -98,6 +98,11 @@ int ext2_debug_flag;
 int use_xattr_translator_records = 1;
 #define NO_XATTR_TRANSLATOR_RECORDS	-1
 
+/* Return the pager and disk cache statistics with our options.  */
+static int report_stats;
+#define STATS				-2
+#define NO_STATS			-3
+
 /* Ext2fs-specific options.  */
 static const struct argp_option
 options[] =
@@ -109,6 +114,10 @@ options[] =
   },
   {"no-xattr-translator-records", NO_XATTR_TRANSLATOR_RECORDS, 0, 0,
    "Do not store translator records in extended attributes (legacy)"},
+  {"stats", STATS, "VALUES", OPTION_ARG_OPTIONAL,
+   "Show pager and disk cache statistics among the options fsysopts"
+   " prints; VALUES is ignored"},
+  {"no-stats", NO_STATS, 0, 0, "Stop showing statistics (the default)"},
 #ifdef ALTERNATE_SBLOCK
   /* XXX This is not implemented.  */
   {"sblock", 'S', "BLOCKNO", 0,
@@ -126,6 +135,7 @@ parse_opt (int key, char *arg, struct argp_state *state)
   struct
   {
     int debug_flag;
+    int report_stats;
     int use_xattr_translator_records;
 #ifdef ALTERNATE_SBLOCK
     unsigned int sb_block;
@@ -140,6 +150,12 @@ parse_opt (int key, char *arg, struct argp_state *state)
     case NO_XATTR_TRANSLATOR_RECORDS:
       values->use_xattr_translator_records = 0;
       break;
+    case STATS:
+      values->report_stats = 1;
+      break;
+    case NO_STATS:
+      values->report_stats = 0;
+      break;
 #ifdef ALTERNATE_SBLOCK
     case 'S':
       values->sb_block = strtoul (arg, &arg, 0);
@@ -159,6 +175,7 @@ parse_opt (int key, char *arg, struct argp_state *state)
       state->hook = values;
       memset (values, 0, sizeof *values);
       values->use_xattr_translator_records = use_xattr_translator_records;
+      values->report_stats = report_stats;
 #ifdef ALTERNATE_SBLOCK
       values->sb_block = SBLOCK_BLOCK;
 #endif
@@ -177,6 +194,7 @@ parse_opt (int key, char *arg, struct argp_state *state)
 	}
 
       use_xattr_translator_records = values->use_xattr_translator_records;
+      report_stats = values->report_stats;
       break;
 
     default:
@@ -201,6 +219,8 @@ diskfs_append_args (char **argz, size_t *argz_len)
   if (!err && ext2_debug_flag)
     err = argz_add (argz, argz_len, "--debug");
 #endif
+  if (!err && report_stats)
+    err = ext2fs_stats_append_args (argz, argz_len);
   if (! err)
     err = store_parsed_append_args (store_parsed, argz, argz_len);
 
@@ -601,6 +601,60 @@ extern void _ext2_panic (const char *, const char *, ...)
 extern void ext2_warning (const char *, ...)
      __attribute__ ((format (printf, 1, 2)));
 
+/* ---------------------------------------------------------------- */
+/* stats.c */
+
+/* Event counters.  */
+enum ext2fs_stat
+{
+  STAT_disk_pageins,
+  STAT_disk_pageouts,
+
+  STAT_file_pageins,
+  STAT_file_pagein_reads,	/* Device reads done by file pagein */
+  STAT_file_pagein_freed_bufs,	/* Discarded pages */
+  STAT_file_pagein_alloced_bufs, /* Allocated pages */
+
+  STAT_file_pageouts,
+
+  STAT_file_page_unlocks,
+  STAT_file_grows,
+
+  STAT_disk_cache_hits,		/* disk_cache_block_ref found the block */
+  STAT_disk_cache_misses,	/* ... and had to map it */
+  STAT_disk_cache_evictions,	/* Disk cache pages evicted by the kernel */
+  STAT_disk_cache_flushes,	/* Disk cache full, unused blocks returned */
+
+  STAT_MAX
+};
+
+/* Latency histograms.  */
+enum ext2fs_latency
+{
+  LATENCY_pagein,
+  LATENCY_pageout,
+
+  LATENCY_MAX
+};
+
+/* Bucket I of a latency histogram counts operations which took less
+   than 2^(I+1) microseconds; the last one counts all longer ones.  */
+#define LATENCY_BUCKETS 24
+
+/* Count one EVENT.  */
+#define STAT_INC(event) ext2fs_stat_add (STAT_##event, 1)
+void ext2fs_stat_add (enum ext2fs_stat stat, unsigned long n);
+
+/* Return a timestamp for ext2fs_latency_record.  */
+uint64_t ext2fs_latency_start (void);
+
+/* Record an operation of type LATENCY which started at START.  */
+void ext2fs_latency_record (enum ext2fs_latency latency, uint64_t start);
+
+/* Add the statistics gathered so far to the options in ARGZ, as a
+   --stats option.  */
+error_t ext2fs_stats_append_args (char **argz, size_t *argz_len);
+
 /* ---------------------------------------------------------------- */
 /* xattr.c */
 
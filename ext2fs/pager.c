@@ -48,38 +48,6 @@ pthread_spinlock_t node_to_page_lock = PTHREAD_SPINLOCK_INITIALIZER;
 #define MAY_CACHE 1
 #endif
 
-#define STATS
-
-#ifdef STATS
-struct ext2fs_pager_stats
-{
-  pthread_spinlock_t lock;
-
-  unsigned long disk_pageins;
-  unsigned long disk_pageouts;
-
-  unsigned long file_pageins;
-  unsigned long file_pagein_reads; /* Device reads done by file pagein */
-  unsigned long file_pagein_freed_bufs;	/* Discarded pages */
-  unsigned long file_pagein_alloced_bufs; /* Allocated pages */
-
-  unsigned long file_pageouts;
-
-  unsigned long file_page_unlocks;
-  unsigned long file_grows;
-};
-
-static struct ext2fs_pager_stats ext2s_pager_stats =
-  { .lock = PTHREAD_SPINLOCK_INITIALIZER };
-
-#define STAT_INC(field)							      \
-do { pthread_spin_lock (&ext2s_pager_stats.lock);			      \
-     ext2s_pager_stats.field++;						      \
-     pthread_spin_unlock (&ext2s_pager_stats.lock); } while (0)
-
-#else /* !STATS */
-#define STAT_INC(field) /* nop */0
-#endif /* STATS */
 
 static void
 disk_cache_info_free_push (struct disk_cache_info *p);
@@ -446,6 +414,8 @@ disk_pager_read_page (vm_offset_t page, void **buf, int *writelock)
 
   ext2_debug ("(%lld)", offset >> log2_block_size);
 
+  STAT_INC (disk_pageins);
+
   if (offset + vm_page_size > dev_end)
     length = dev_end - offset;
 
@@ -540,6 +510,8 @@ disk_pager_notify_evict (vm_offset_t page)
 
   ext2_debug ("(block %lu)", index);
 
+  STAT_INC (disk_cache_evictions);
+
   pthread_mutex_lock (&disk_cache_lock);
   disk_cache_info[index].flags &= ~DC_INCORE;
   if (disk_cache_info[index].ref_count == 0 &&
@@ -555,10 +527,16 @@ error_t
 pager_read_page (struct user_pager_info *pager, vm_offset_t page,
 		 vm_address_t *buf, int *writelock)
 {
+  uint64_t start = ext2fs_latency_start ();
+  error_t err;
+
   if (pager->type == DISK)
-    return disk_pager_read_page (page, (void **)buf, writelock);
+    err = disk_pager_read_page (page, (void **)buf, writelock);
   else
-    return file_pager_read_page (pager->node, page, (void **)buf, writelock);
+    err = file_pager_read_page (pager->node, page, (void **)buf, writelock);
+
+  ext2fs_latency_record (LATENCY_pagein, start);
+  return err;
 }
 
 /* Satisfy a pager write request for either the disk pager or file pager
@@ -567,10 +545,16 @@ error_t
 pager_write_page (struct user_pager_info *pager, vm_offset_t page,
 		  vm_address_t buf)
 {
+  uint64_t start = ext2fs_latency_start ();
+  error_t err;
+
   if (pager->type == DISK)
-    return disk_pager_write_page (page, (void *)buf);
+    err = disk_pager_write_page (page, (void *)buf);
   else
-    return file_pager_write_page (pager->node, page, (void *)buf);
+    err = file_pager_write_page (pager->node, page, (void *)buf);
+
+  ext2fs_latency_record (LATENCY_pageout, start);
+  return err;
 }
 
 void
@@ -1060,6 +1044,7 @@ retry_ref:
 
       pthread_mutex_unlock (&disk_cache_lock);
 
+      STAT_INC (disk_cache_hits);
       return bptr;
     }
 
@@ -1075,6 +1060,8 @@ retry_ref:
 
       pthread_mutex_unlock (&disk_cache_lock);
 
+      STAT_INC (disk_cache_flushes);
+
       disk_cache_return_unused ();
 
       goto retry_ref;
@@ -1115,8 +1102,8 @@ retry_ref:
   pthread_mutex_lock (&diskfs_disk_pager->interlock);
   int page = (bptr - disk_cache) / vm_page_size;
   assert_backtrace (page >= 0);
-  int is_incore = (page < diskfs_disk_pager->pagemapsize
-		   && (diskfs_disk_pager->pagemap[page] & PM_INCORE));
+  short *pm_entry = _pager_pagemap_get (diskfs_disk_pager, page, 0);
+  int is_incore = pm_entry && (*pm_entry & PM_INCORE);
   pthread_mutex_unlock (&diskfs_disk_pager->interlock);
   if (is_incore)
     {
@@ -1174,6 +1161,8 @@ retry_ref:
 
   pthread_mutex_unlock (&disk_cache_lock);
 
+  STAT_INC (disk_cache_misses);
+
   ext2_debug ("(%u) = %p", block, bptr);
   return bptr;
 }
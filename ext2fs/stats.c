@@ -0,0 +1,258 @@
+/* Pager and disk cache statistics for ext2fs
+
+   Copyright (C) 2026 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation; either version 2, or (at
+   your option) any later version.
+
+   This program is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA. */
+
+#include <argz.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "ext2fs.h"
+
+/* The counters are kept per thread, so that counting an event on the
+   paging path is a plain increment of a thread-private word.  Only the
+   owning thread ever writes to its counters; readers sum over all
+   threads and may see slightly stale values, which is fine for
+   statistics.  */
+
+struct ext2fs_stats
+{
+  unsigned long counters[STAT_MAX];
+  unsigned long latencies[LATENCY_MAX][LATENCY_BUCKETS];
+};
+
+struct stats_shard
+{
+  struct ext2fs_stats stats;
+  struct stats_shard *next, **prevp;
+};
+
+/* The counters of the calling thread, or NULL if it has not counted
+   anything yet.  */
+static __thread struct stats_shard *thread_shard;
+
+/* All shards of live threads, and the sum of those of threads which
+   have exited, protected by SHARDS_LOCK.  */
+static struct stats_shard *shards;
+static struct ext2fs_stats retired;
+static pthread_mutex_t shards_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/* Used to notice threads exiting.  */
+static pthread_key_t shard_key;
+static pthread_once_t shard_key_once = PTHREAD_ONCE_INIT;
+
+static void
+stats_sum (struct ext2fs_stats *to, const struct ext2fs_stats *from)
+{
+  int i, j;
+
+  for (i = 0; i < STAT_MAX; i++)
+    to->counters[i] += __atomic_load_n (&from->counters[i], __ATOMIC_RELAXED);
+  for (i = 0; i < LATENCY_MAX; i++)
+    for (j = 0; j < LATENCY_BUCKETS; j++)
+      to->latencies[i][j] += __atomic_load_n (&from->latencies[i][j],
+					      __ATOMIC_RELAXED);
+}
+
+/* Fold the counters of an exiting thread into RETIRED.  */
+static void
+shard_retire (void *arg)
+{
+  struct stats_shard *shard = arg;
+
+  pthread_mutex_lock (&shards_lock);
+  stats_sum (&retired, &shard->stats);
+  *shard->prevp = shard->next;
+  if (shard->next)
+    shard->next->prevp = shard->prevp;
+  pthread_mutex_unlock (&shards_lock);
+
+  free (shard);
+}
+
+static void
+shard_key_create (void)
+{
+  if (pthread_key_create (&shard_key, shard_retire))
+    ext2_panic ("can't create statistics key");
+}
+
+/* Return the counters of the calling thread, creating them if need be,
+   or NULL if that fails.  */
+static struct stats_shard *
+shard_get (void)
+{
+  struct stats_shard *shard = thread_shard;
+
+  if (shard)
+    return shard;
+
+  shard = calloc (1, sizeof *shard);
+  if (!shard)
+    return NULL;
+
+  pthread_once (&shard_key_once, shard_key_create);
+  pthread_setspecific (shard_key, shard);
+
+  pthread_mutex_lock (&shards_lock);
+  shard->next = shards;
+  if (shard->next)
+    shard->next->prevp = &shard->next;
+  shard->prevp = &shards;
+  shards = shard;
+  pthread_mutex_unlock (&shards_lock);
+
+  thread_shard = shard;
+  return shard;
+}
+
+/* Add N to the thread-private word at P.  */
+static inline void
+shard_add (unsigned long *p, unsigned long n)
+{
+  __atomic_store_n (p, *p + n, __ATOMIC_RELAXED);
+}
+
+void
+ext2fs_stat_add (enum ext2fs_stat stat, unsigned long n)
+{
+  struct stats_shard *shard = shard_get ();
+
+  if (shard)
+    shard_add (&shard->stats.counters[stat], n);
+}
+
+uint64_t
+ext2fs_latency_start (void)
+{
+  struct timespec ts;
+
+  clock_gettime (CLOCK_MONOTONIC, &ts);
+  return (uint64_t) ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+void
+ext2fs_latency_record (enum ext2fs_latency latency, uint64_t start)
+{
+  struct stats_shard *shard = shard_get ();
+  uint64_t usecs = ext2fs_latency_start () - start;
+  int bucket = 0;
+
+  if (!shard)
+    return;
+
+  while (usecs > 1 && bucket < LATENCY_BUCKETS - 1)
+    {
+      usecs >>= 1;
+      bucket++;
+    }
+  shard_add (&shard->stats.latencies[latency][bucket], 1);
+}
+
+static const char *const stat_names[STAT_MAX] =
+{
+  [STAT_disk_pageins] = "disk-pageins",
+  [STAT_disk_pageouts] = "disk-pageouts",
+  [STAT_file_pageins] = "file-pageins",
+  [STAT_file_pagein_reads] = "file-pagein-reads",
+  [STAT_file_pagein_freed_bufs] = "file-pagein-freed-bufs",
+  [STAT_file_pagein_alloced_bufs] = "file-pagein-alloced-bufs",
+  [STAT_file_pageouts] = "file-pageouts",
+  [STAT_file_page_unlocks] = "file-page-unlocks",
+  [STAT_file_grows] = "file-grows",
+  [STAT_disk_cache_hits] = "disk-cache-hits",
+  [STAT_disk_cache_misses] = "disk-cache-misses",
+  [STAT_disk_cache_evictions] = "disk-cache-evictions",
+  [STAT_disk_cache_flushes] = "disk-cache-flushes",
+};
+
+static const char *const latency_names[LATENCY_MAX] =
+{
+  [LATENCY_pagein] = "pagein",
+  [LATENCY_pageout] = "pageout",
+};
+
+/* The statistics are returned as the value of a single option, so that
+   fsysopts shows them along with the others, as
+   --stats=NAME=VALUE,NAME=VALUE,...  A latency histogram is a list of
+   LIMIT:COUNT pairs separated by slashes, LIMIT being the bucket's upper
+   bound in microseconds, or "more" for the last one.  */
+error_t
+ext2fs_stats_append_args (char **argz, size_t *argz_len)
+{
+  struct ext2fs_stats total;
+  struct ports_no_senders_stats ns;
+  struct stats_shard *shard;
+  unsigned long refs;
+  char *buf = NULL;
+  size_t len = 0;
+  FILE *stream;
+  error_t err;
+  int i, j;
+
+  pthread_mutex_lock (&shards_lock);
+  total = retired;
+  for (shard = shards; shard; shard = shard->next)
+    stats_sum (&total, &shard->stats);
+  pthread_mutex_unlock (&shards_lock);
+
+  stream = open_memstream (&buf, &len);
+  if (!stream)
+    return errno;
+
+  fputs ("--stats=", stream);
+  for (i = 0; i < STAT_MAX; i++)
+    fprintf (stream, "%s=%lu,", stat_names[i], total.counters[i]);
+
+  refs = total.counters[STAT_disk_cache_hits]
+    + total.counters[STAT_disk_cache_misses];
+  fprintf (stream, "disk-cache-hit-percent=%lu,",
+	   refs ? total.counters[STAT_disk_cache_hits] * 100 / refs : 0);
+
+  for (i = 0; i < LATENCY_MAX; i++)
+    {
+      const char *sep = "";
+
+      fprintf (stream, "%s-usecs=", latency_names[i]);
+      for (j = 0; j < LATENCY_BUCKETS; j++)
+	if (total.latencies[i][j])
+	  {
+	    if (j < LATENCY_BUCKETS - 1)
+	      fprintf (stream, "%s%lu:%lu", sep, 2UL << j,
+		       total.latencies[i][j]);
+	    else
+	      fprintf (stream, "%smore:%lu", sep, total.latencies[i][j]);
+	    sep = "/";
+	  }
+      putc (',', stream);
+    }
+
+  ports_get_no_senders_stats (&ns);
+  fprintf (stream, "no-senders-notifications=%lu,no-senders-freed=%lu,"
+	   "no-senders-batches=%lu,no-senders-max-batch=%lu,"
+	   "no-senders-backlog=%lu,no-senders-max-backlog=%lu",
+	   ns.notifications, ns.deallocated, ns.batches, ns.max_batch,
+	   ns.backlog, ns.max_backlog);
+
+  if (fclose (stream))
+    err = errno;
+  else
+    err = argz_add (argz, argz_len, buf);
+  free (buf);
+  return err;
+}
@@ -1,6 +1,6 @@
 /* Ftp connection management
 
-   Copyright (C) 1997,2002 Free Software Foundation, Inc.
+   Copyright (C) 1997,2002,2026 Free Software Foundation, Inc.
    Written by Miles Bader <miles@gnu.ai.mit.edu>
    This file is part of the GNU Hurd.
 
@@ -20,6 +20,7 @@
 
 #include <assert-backtrace.h>
 #include <stdint.h>
+#include <unistd.h>
 
 #include "ftpfs.h"
 
@@ -28,6 +29,10 @@ struct ftpfs_conn
 {
   struct ftp_conn *conn;
   struct ftpfs_conn *next;
+
+  /* When this connection was put on the free list, and when we last made
+     sure that the server still remembers it.  */
+  time_t idle_since, checked;
 };
 
 /* For debugging purposes, give each connection a unique integer id.  */
@@ -39,11 +44,23 @@ ftpfs_get_ftp_conn (struct ftpfs *fs, struct ftp_conn **conn)
 {
   struct ftpfs_conn *fsc;
 
-  pthread_spin_lock (&fs->conn_lock);
+  pthread_mutex_lock (&fs->conn_lock);
+  while (! fs->free_conns
+	 && fs->params.max_conns && fs->num_conns >= fs->params.max_conns)
+    /* Wait for another thread to give one back rather than hammering a
+       server which limits how many connections a client may have.  */
+    if (pthread_hurd_cond_wait_np (&fs->conn_free, &fs->conn_lock))
+      {
+	pthread_mutex_unlock (&fs->conn_lock);
+	return EINTR;
+      }
   fsc = fs->free_conns;
   if (fsc)
     fs->free_conns = fsc->next;
-  pthread_spin_unlock (&fs->conn_lock);
+  else
+    /* Reserve a slot for the connection we're about to make.  */
+    fs->num_conns++;
+  pthread_mutex_unlock (&fs->conn_lock);
 
   if (! fsc)
     {
@@ -51,12 +68,16 @@ ftpfs_get_ftp_conn (struct ftpfs *fs, struct ftp_conn **conn)
 
       fsc = malloc (sizeof (struct ftpfs_conn));
       if (! fsc)
-	return ENOMEM;
-
-      err = ftp_conn_create (fs->ftp_params, fs->ftp_hooks, &fsc->conn);
+	err = ENOMEM;
+      else
+	err = ftp_conn_create (fs->ftp_params, fs->ftp_hooks, &fsc->conn);
 
       if (! err)
 	{
+	  /* Get directory listings with exact stat information if the
+	     server can give them to us.  */
+	  fsc->conn->use_mlsd = 1;
+
 	  /* Set connection type to binary.  */
 	  err = ftp_conn_set_type (fsc->conn, "I");
 	  if (err)
@@ -66,6 +87,10 @@ ftpfs_get_ftp_conn (struct ftpfs *fs, struct ftp_conn **conn)
       if (err)
 	{
 	  free (fsc);
+	  pthread_mutex_lock (&fs->conn_lock);
+	  fs->num_conns--;
+	  pthread_cond_signal (&fs->conn_free);
+	  pthread_mutex_unlock (&fs->conn_lock);
 	  return err;
 	}
 
@@ -73,10 +98,10 @@ ftpfs_get_ftp_conn (struct ftpfs *fs, struct ftp_conn **conn)
       fsc->conn->hook = (void *)(uintptr_t)conn_id++;
     }
 
-  pthread_spin_lock (&fs->conn_lock);
+  pthread_mutex_lock (&fs->conn_lock);
   fsc->next = fs->conns;
   fs->conns = fsc;
-  pthread_spin_unlock (&fs->conn_lock);
+  pthread_mutex_unlock (&fs->conn_lock);
 
   *conn = fsc->conn;
 
@@ -89,7 +114,7 @@ ftpfs_release_ftp_conn (struct ftpfs *fs, struct ftp_conn *conn)
 {
   struct ftpfs_conn *fsc, *pfsc;
 
-  pthread_spin_lock (&fs->conn_lock);
+  pthread_mutex_lock (&fs->conn_lock);
   for (pfsc = 0, fsc = fs->conns; fsc; pfsc = fsc, fsc = fsc->next)
     if (fsc->conn == conn)
       {
@@ -97,10 +122,119 @@ ftpfs_release_ftp_conn (struct ftpfs *fs, struct ftp_conn *conn)
 	  pfsc->next = fsc->next;
 	else
 	  fs->conns = fsc->next;
+	/* The free list is kept in order of last use, so that busy periods
+	   keep reusing the same few connections and the rest age out.  */
 	fsc->next = fs->free_conns;
 	fs->free_conns = fsc;
+	fsc->idle_since = fsc->checked = NOW;
 	break;
       }
   assert_backtrace (fsc);
-  pthread_spin_unlock (&fs->conn_lock);
+  pthread_cond_signal (&fs->conn_free);
+  pthread_mutex_unlock (&fs->conn_lock);
+}
+
+/* Look through FS's free connections, closing those which have been idle
+   longer than FS's connection timeout, and sending a NOOP over those which
+   have been quiet for longer than its keepalive interval, so that the
+   server doesn't drop them and we don't have to log in again.  */
+static void
+check_idle_conns (struct ftpfs *fs)
+{
+  struct ftpfs_conn *fsc, **pfsc, *check = 0, *dead = 0;
+  time_t now = NOW;
+  time_t timeout = fs->params.conn_timeout;
+  time_t keepalive = fs->params.conn_keepalive;
+
+  pthread_mutex_lock (&fs->conn_lock);
+  pfsc = &fs->free_conns;
+  while ((fsc = *pfsc))
+    if (timeout && fsc->idle_since + timeout <= now)
+      {
+	*pfsc = fsc->next;
+	fsc->next = dead;
+	dead = fsc;
+	fs->num_conns--;
+      }
+    else if (keepalive && fsc->checked + keepalive <= now)
+      /* Take it off the free list while we talk to the server.  */
+      {
+	*pfsc = fsc->next;
+	fsc->next = check;
+	check = fsc;
+      }
+    else
+      pfsc = &fsc->next;
+  pthread_mutex_unlock (&fs->conn_lock);
+
+  while ((fsc = check))
+    {
+      int reply;
+      error_t err;
+
+      check = fsc->next;
+
+      /* Don't use ftp_conn_cmd_reopen here; a connection which the server
+	 has already dropped is just one less to keep alive.  */
+      err = ftp_conn_cmd (fsc->conn, "noop", 0, &reply, 0);
+
+      pthread_mutex_lock (&fs->conn_lock);
+      if (err || reply / 100 != 2)
+	{
+	  fsc->next = dead;
+	  dead = fsc;
+	  fs->num_conns--;
+	}
+      else
+	{
+	  fsc->checked = NOW;
+	  fsc->next = fs->free_conns;
+	  fs->free_conns = fsc;
+	}
+      pthread_cond_signal (&fs->conn_free);
+      pthread_mutex_unlock (&fs->conn_lock);
+    }
+
+  while ((fsc = dead))
+    {
+      dead = fsc->next;
+      ftp_conn_free (fsc->conn);
+      free (fsc);
+    }
+}
+
+/* Periodically check the idle connections in the ftpfs FS.  */
+static void *
+idle_conns_thread (void *arg)
+{
+  struct ftpfs *fs = arg;
+
+  for (;;)
+    {
+      time_t period = fs->params.conn_keepalive;
+
+      if (! period
+	  || (fs->params.conn_timeout && fs->params.conn_timeout < period))
+	period = fs->params.conn_timeout;
+
+      /* Wake up often enough to get within a few seconds of either.  */
+      sleep (period ? (period + 3) / 4 : 60);
+
+      check_idle_conns (fs);
+    }
+
+  return NULL;
+}
+
+/* Start the thread that keeps FS's idle connections alive.  */
+error_t
+ftpfs_start_idle_conns_thread (struct ftpfs *fs)
+{
+  pthread_t thread;
+  error_t err = pthread_create (&thread, NULL, idle_conns_thread, fs);
+
+  if (! err)
+    pthread_detach (thread);
+
+  return err;
 }
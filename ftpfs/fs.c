@@ -1,6 +1,6 @@
 /* Fs operations
 
-   Copyright (C) 1997, 2001, 2003 Free Software Foundation, Inc.
+   Copyright (C) 1997, 2001, 2003, 2026 Free Software Foundation, Inc.
    Written by Miles Bader <miles@gnu.org>
    This file is part of the GNU Hurd.
 
@@ -48,7 +48,9 @@ ftpfs_create (char *rmt_path, int fsid,
 
   new->free_conns = 0;
   new->conns = 0;
-  pthread_spin_init (&new->conn_lock, PTHREAD_PROCESS_PRIVATE);
+  new->num_conns = 0;
+  pthread_mutex_init (&new->conn_lock, NULL);
+  pthread_cond_init (&new->conn_free, NULL);
   new->node_cache_mru = new->node_cache_lru = 0;
   new->node_cache_len = 0;
   pthread_mutex_init (&new->node_cache_lock, NULL);
@@ -74,6 +76,9 @@ ftpfs_create (char *rmt_path, int fsid,
 	err = ftpfs_dir_null_lookup (super_root_dir, &new->root);
     }
 
+  if (! err)
+    err = ftpfs_start_idle_conns_thread (new);
+
   if (err)
     {
       hurd_ihash_destroy (&new->inode_mappings);
@@ -1,6 +1,6 @@
 /* Ftp filesystem
 
-   Copyright (C) 1997,98,2002 Free Software Foundation, Inc.
+   Copyright (C) 1997,98,2002,2026 Free Software Foundation, Inc.
    Written by Miles Bader <miles@gnu.org>
    This file is part of the GNU Hurd.
 
@@ -106,6 +106,10 @@ cntl_debug (struct ftp_conn *conn, int type, const char *txt)
 
 #define DEFAULT_NODE_CACHE_MAX	50
 
+#define DEFAULT_MAX_CONNS	0
+#define DEFAULT_CONN_TIMEOUT	600
+#define DEFAULT_CONN_KEEPALIVE	60
+
 /* Return a string corresponding to the printed rep of DEFAULT_what */
 #define ___D(what) #what
 #define __D(what) ___D(what)
@@ -120,6 +124,9 @@ cntl_debug (struct ftp_conn *conn, int type, const char *txt)
 #define OPT_NODE_CACHE_MAX      8
 #define OPT_BULK_STAT_PERIOD    9
 #define OPT_BULK_STAT_THRESHOLD 10
+#define OPT_MAX_CONNS           11
+#define OPT_CONN_TIMEOUT        12
+#define OPT_CONN_KEEPALIVE      13
 
 /* Options usable both at startup and at runtime.  */
 static const struct argp_option common_options[] =
@@ -142,6 +149,16 @@ static const struct argp_option common_options[] =
    "Number of stats within the bulk-stat-period that trigger a bulk stat"
    " (default " _D(BULK_STAT_THRESHOLD) ")"},
 
+  {"max-connections",    OPT_MAX_CONNS,      "NUM",  0,
+   "Maximum number of simultaneous ftp connections, 0 for no limit"
+   " (default " _D(MAX_CONNS) "); each partially read file holds one"},
+  {"connection-timeout", OPT_CONN_TIMEOUT,   "SECS", 0,
+   "Time an unused ftp connection is kept open (default "
+   _D(CONN_TIMEOUT) ")"},
+  {"keepalive",          OPT_CONN_KEEPALIVE, "SECS", 0,
+   "Period for keeping unused ftp connections alive, 0 to disable"
+   " (default " _D(CONN_KEEPALIVE) ")"},
+
   {0, 0}
 };
 
@@ -207,6 +224,12 @@ parse_common_opt (int key, char *arg, struct argp_state *state)
       params->name_timeout = atoi (arg); break;
     case OPT_STAT_TIMEOUT:
       params->stat_timeout = atoi (arg); break;
+    case OPT_MAX_CONNS:
+      params->max_conns = atoi (arg); break;
+    case OPT_CONN_TIMEOUT:
+      params->conn_timeout = atoi (arg); break;
+    case OPT_CONN_KEEPALIVE:
+      params->conn_keepalive = atoi (arg); break;
     default:
       return ARGP_ERR_UNKNOWN;
     }
@@ -363,6 +386,12 @@ netfs_append_args (char **argz, size_t *argz_len)
     FOPT ("--bulk-stat-period=%ld", ftpfs->params.bulk_stat_period);
   if (ftpfs->params.bulk_stat_threshold != DEFAULT_BULK_STAT_THRESHOLD)
     FOPT ("--bulk-stat-threshold=%d", ftpfs->params.bulk_stat_threshold);
+  if (ftpfs->params.max_conns != DEFAULT_MAX_CONNS)
+    FOPT ("--max-connections=%u", ftpfs->params.max_conns);
+  if (ftpfs->params.conn_timeout != DEFAULT_CONN_TIMEOUT)
+    FOPT ("--connection-timeout=%ld", ftpfs->params.conn_timeout);
+  if (ftpfs->params.conn_keepalive != DEFAULT_CONN_KEEPALIVE)
+    FOPT ("--keepalive=%ld", ftpfs->params.conn_keepalive);
 
   return argz_add (argz, argz_len, ftpfs_remote_fs);
 }
@@ -384,6 +413,9 @@ main (int argc, char **argv)
   ftpfs_params.node_cache_max = DEFAULT_NODE_CACHE_MAX;
   ftpfs_params.bulk_stat_period = DEFAULT_BULK_STAT_PERIOD;
   ftpfs_params.bulk_stat_threshold = DEFAULT_BULK_STAT_THRESHOLD;
+  ftpfs_params.max_conns = DEFAULT_MAX_CONNS;
+  ftpfs_params.conn_timeout = DEFAULT_CONN_TIMEOUT;
+  ftpfs_params.conn_keepalive = DEFAULT_CONN_KEEPALIVE;
 
   argp_parse (&argp, argc, argv, 0, 0, 0);
 
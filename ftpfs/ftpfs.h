@@ -1,6 +1,6 @@
 /* Ftp filesystem
 
-   Copyright (C) 1997 Free Software Foundation, Inc.
+   Copyright (C) 1997, 2026 Free Software Foundation, Inc.
    Written by Miles Bader <miles@gnu.ai.mit.edu>
    This file is part of the GNU Hurd.
 
@@ -145,6 +145,15 @@ struct ftpfs_params
 
   /* The size of the node cache.  */
   size_t node_cache_max;
+
+  /* The most ftp connections open at once, or 0 for no limit.  */
+  unsigned max_conns;
+
+  /* Idle ftp connections are closed after CONN_TIMEOUT seconds, and poked
+     every CONN_KEEPALIVE seconds until then so the server doesn't beat us
+     to it; either may be 0 to disable it.  */
+  time_t conn_timeout;
+  time_t conn_keepalive;
 };
 
 /* A particular filesystem.  */
@@ -156,7 +165,9 @@ struct ftpfs
   /* A pool of ftp connections for server threads to use.  */
   struct ftpfs_conn *free_conns;
   struct ftpfs_conn *conns;
-  pthread_spinlock_t conn_lock;
+  unsigned num_conns;		/* Total number, free or not.  */
+  pthread_mutex_t conn_lock;
+  pthread_cond_t conn_free;	/* Signalled when one becomes free.  */
 
   /* Parameters for making new ftp connections.  */
   struct ftp_conn_params *ftp_params;
@@ -181,8 +192,7 @@ struct ftpfs
 extern volatile struct mapped_time_value *ftpfs_maptime;
 
 /* The current time.  */
-#define NOW \
-  ({ struct timeval tv; maptime_read (ftpfs_maptime, &tv); tv.tv_sec; })
+#define NOW maptime_seconds (ftpfs_maptime)
 
 /* Create a new ftp filesystem with the given parameters.  */
 error_t ftpfs_create (char *rmt_root, int fsid,
@@ -214,6 +224,9 @@ error_t ftpfs_get_ftp_conn (struct ftpfs *fs, struct ftp_conn **conn);
 /* Return CONN to the pool of free connections in FS.  */
 void ftpfs_release_ftp_conn (struct ftpfs *fs, struct ftp_conn *conn);
 
+/* Start the thread that keeps FS's idle connections alive.  */
+error_t ftpfs_start_idle_conns_thread (struct ftpfs *fs);
+
 /* Return in DIR a new ftpfs directory, in the filesystem FS, with node NODE
    and remote path RMT_PATH.  RMT_PATH is *not copied*, so it shouldn't ever
    change while this directory is active.  */
@@ -19,6 +19,8 @@
    Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111, USA. */
 
 #include <unistd.h>
+#include <stddef.h>
+#include <stdlib.h>
 #include <argp.h>
 #include <argz.h>
 #include <error.h>
@@ -38,6 +40,12 @@ volatile struct mapped_time_value *hostmux_maptime;
 
 #define DEFAULT_HOST_PAT "${host}"
 
+#define DEFAULT_CACHE_TTL	300
+#define DEFAULT_NEGATIVE_TTL	30
+
+#define OPT_CACHE_TTL		-1
+#define OPT_NEGATIVE_TTL	-2
+
 /* Startup options.  */
 static const struct argp_option options[] =
 {
@@ -48,6 +56,10 @@ static const struct argp_option options[] =
   { "canonicalize", 'C', 0, 0,
     "Canonicalize hostname before passing it to TRANSLATOR, aliases will"
     " show up as symbolic links to the canonicalized entry" },
+  { "cache-ttl", OPT_CACHE_TTL, "SECS", 0,
+    "Reuse the canonical name of a host for SECS seconds (default 300)" },
+  { "negative-ttl", OPT_NEGATIVE_TTL, "SECS", 0,
+    "Remember that a host does not exist for SECS seconds (default 30)" },
   { 0 }
 };
 static const char args_doc[] = "TRANSLATOR [ARG...]";
@@ -78,6 +90,16 @@ netfs_append_args (char **argz, size_t *argz_len)
   if (strcmp (mux->host_pat, DEFAULT_HOST_PAT) != 0)
     FOPT ("--host-pattern=%s", mux->host_pat);
 
+  if (mux->canonicalize)
+    {
+      if (! err)
+	err = argz_add (argz, argz_len, "--canonicalize");
+      if (mux->cache_ttl != DEFAULT_CACHE_TTL)
+	FOPT ("--cache-ttl=%ld", (long) mux->cache_ttl);
+      if (mux->negative_ttl != DEFAULT_NEGATIVE_TTL)
+	FOPT ("--negative-ttl=%ld", (long) mux->negative_ttl);
+    }
+
   if (! err)
     err = argz_append (argz, argz_len,
 		       mux->trans_template, mux->trans_template_len);
@@ -91,7 +113,9 @@ main (int argc, char **argv)
   error_t err;
   struct stat ul_stat;
   mach_port_t bootstrap;
-  struct hostmux mux = { host_pat: DEFAULT_HOST_PAT, next_fileno: 10 };
+  struct hostmux mux = { host_pat: DEFAULT_HOST_PAT, next_fileno: 10,
+			 cache_ttl: DEFAULT_CACHE_TTL,
+			 negative_ttl: DEFAULT_NEGATIVE_TTL };
   struct netnode root_nn = { mux: &mux };
 
   error_t parse_opt (int key, char *arg, struct argp_state *state)
@@ -102,6 +126,10 @@ main (int argc, char **argv)
 	  mux.host_pat = arg; break;
 	case 'C':
 	  mux.canonicalize = 1; break;
+	case OPT_CACHE_TTL:
+	  mux.cache_ttl = atoi (arg); break;
+	case OPT_NEGATIVE_TTL:
+	  mux.negative_ttl = atoi (arg); break;
 	case ARGP_KEY_NO_ARGS:
 	  argp_usage (state);
 	case ARGP_KEY_ARGS:
@@ -118,6 +146,13 @@ main (int argc, char **argv)
   /* Parse our command line arguments.  */
   argp_parse (&argp, argc, argv, ARGP_IN_ORDER, 0, 0);
 
+  hurd_ihash_init (&mux.names_ht, offsetof (struct hostmux_name, locp));
+  hurd_ihash_set_gki (&mux.names_ht, hostmux_name_hash, hostmux_name_compare);
+  hurd_ihash_init (&mux.resolved,
+		   offsetof (struct hostmux_resolved, locp));
+  hurd_ihash_set_gki (&mux.resolved, hostmux_name_hash, hostmux_name_compare);
+  pthread_mutex_init (&mux.resolve_lock, NULL);
+
   task_get_bootstrap_port (mach_task_self (), &bootstrap);
   netfs_init ();
 
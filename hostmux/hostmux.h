@@ -1,6 +1,6 @@
 /* Multiplexing filesystems by host
 
-   Copyright (C) 1997 Free Software Foundation, Inc.
+   Copyright (C) 1997, 2026 Free Software Foundation, Inc.
    Written by Miles Bader <miles@gnu.ai.mit.edu>
    This file is part of the GNU Hurd.
 
@@ -22,6 +22,7 @@
 #define __HOSTMUX_H__
 
 #include <hurd/netfs.h>
+#include <hurd/ihash.h>
 #include <pthread.h>
 #include <maptime.h>
 #include <features.h>
@@ -42,6 +43,23 @@ struct hostmux
   struct hostmux_name *names;
   pthread_rwlock_t names_lock;
 
+  /* NAMES indexed by name, ignoring case; protected by NAMES_LOCK.  */
+  struct hurd_ihash names_ht;
+
+  /* The results of recent host name resolutions (struct
+     hostmux_resolved), indexed by name, ignoring case.  */
+  struct hurd_ihash resolved;
+  pthread_mutex_t resolve_lock;
+
+  /* The entries in RESOLVED, least recently resolved first; protected by
+     RESOLVE_LOCK.  */
+  struct hostmux_resolved *resolved_oldest, *resolved_newest;
+
+  /* How many seconds to use the result of resolving a name for, if the
+     name was found, and if it was not.  */
+  time_t cache_ttl;
+  time_t negative_ttl;
+
   /* The next inode number we'll use; protected by NAMES_LOCK.  */
   ino_t next_fileno;
 
@@ -80,9 +98,38 @@ struct hostmux_name
 
   ino_t fileno;			/* The inode number for this entry.  */
 
-  struct hostmux_name *next;
+  struct hostmux_name *next, **prevp;
+  hurd_ihash_locp_t locp;	/* Our slot in the mux's NAMES_HT.  */
 };
 
+/* The result of resolving a host name.  A name is resolved by a single
+   thread at a time; other threads wanting the same name wait for it,
+   but never for the resolution of other names.  */
+struct hostmux_resolved
+{
+  struct hostmux *mux;
+  char *name;			/* The name that was resolved.  */
+  char *canon;			/* Its canonical name, or 0 if ERR is set.  */
+  error_t err;			/* Why NAME could not be resolved.  */
+  time_t expires;		/* When the result must be thrown away.  */
+
+  int resolving;		/* True while a thread is resolving NAME.  */
+  pthread_cond_t resolved;	/* Signalled when RESOLVING is cleared.  */
+  int users;			/* Threads using this entry; not expired.  */
+
+  /* Our neighbours in the mux's list of resolutions by age.  */
+  struct hostmux_resolved *older, *newer;
+
+  hurd_ihash_locp_t locp;	/* Our slot in the mux's RESOLVED.  */
+};
+
+/* Hash and comparison functions for the names of hosts.  */
+hurd_ihash_key_t hostmux_name_hash (const void *name);
+int hostmux_name_compare (const void *name1, const void *name2);
+
+/* Remove NM, whose node has gone away, from MUX and free it.  */
+void hostmux_drop_name (struct hostmux *mux, struct hostmux_name *nm);
+
 /* The fs specific storage that libnetfs associates with each filesystem
    node.  */
 struct netnode
@@ -1,6 +1,6 @@
 /* Root hostmux node
 
-   Copyright (C) 1997,99,2002 Free Software Foundation, Inc.
+   Copyright (C) 1997,99,2002,2026 Free Software Foundation, Inc.
    Written by Miles Bader <miles@gnu.org>
    This file is part of the GNU Hurd.
 
@@ -20,6 +20,7 @@
 
 #include <stddef.h>
 #include <string.h>
+#include <ctype.h>
 #include <dirent.h>
 #include <netdb.h>
 #include <sys/socket.h>
@@ -213,6 +214,25 @@ netfs_get_dirents (struct iouser *cred, struct node *dir,
 
 /* Host lookup.  */
 
+/* Hash NAME, ignoring case.  */
+hurd_ihash_key_t
+hostmux_name_hash (const void *name)
+{
+  const unsigned char *p;
+  uint32_t hash = 0;
+
+  for (p = name; *p; p++)
+    hash = hash * 31 + tolower (*p);
+  return (hurd_ihash_key_t) hash;
+}
+
+/* Return true if NAME1 and NAME2 are the same, ignoring case.  */
+int
+hostmux_name_compare (const void *name1, const void *name2)
+{
+  return strcasecmp (name1, name2) == 0;
+}
+
 /* Free storage allocated consumed by the host mux name NM, but not the node
    it points to.  */
 static void
@@ -226,65 +246,64 @@ free_name (struct hostmux_name *nm)
 
 /* See if there's an existing entry for the name HOST, and if so, return its
    node in NODE with an additional references.  True is returned iff the
-   lookup succeeds.  If PURGE is true, then any nodes with a null node are
-   removed.  */
+   lookup succeeds.  */
 static int
-lookup_cached (struct hostmux *mux, const char *host, int purge,
-	       struct node **node)
+lookup_cached (struct hostmux *mux, const char *host, struct node **node)
 {
-  struct hostmux_name *nm = mux->names, **prevl = &mux->names;
+  struct hostmux_name *nm =
+    hurd_ihash_find (&mux->names_ht, (hurd_ihash_key_t) host);
 
-  while (nm)
+  if (nm && nm->node)
     {
-      struct hostmux_name *next = nm->next;
-
-      if (strcasecmp (host, nm->name) == 0)
-	{
-          if (nm->node)
-            netfs_nref (nm->node);
-
-	  if (nm->node)
-	    {
-	      *node = nm->node;
-	      return 1;
-	    }
-	}
-
-      if (purge && !nm->node)
-	{
-	  *prevl = nm->next;
-	  free_name (nm);
-	}
-      else
-	prevl = &nm->next;
-
-      nm = next;
+      netfs_nref (nm->node);
+      *node = nm->node;
+      return 1;
     }
 
   return 0;
 }
-
+
+/* Remove NM, whose node has gone away, from MUX and free it.  */
+void
+hostmux_drop_name (struct hostmux *mux, struct hostmux_name *nm)
+{
+  pthread_rwlock_wrlock (&mux->names_lock);
+  *nm->prevp = nm->next;
+  if (nm->next)
+    nm->next->prevp = nm->prevp;
+  hurd_ihash_locp_remove (&mux->names_ht, nm->locp);
+  pthread_rwlock_unlock (&mux->names_lock);
+  free_name (nm);
+}
+
 /* See if there's an existing entry for the name HOST, and if so, return its
    node in NODE, with an additional reference, otherwise, create a new node
-   for the host HE as referred to by HOST, and return that instead, with a
-   single reference.  The type of node created is either a translator node,
-   if HOST refers to the official name of the host, or a symlink node to the
-   official name, if it doesn't.  */
+   for the host whose canonical name is CANON, as referred to by HOST, and
+   return that instead, with a single reference.  The type of node created
+   is either a translator node, if HOST refers to the official name of the
+   host, or a symlink node to the official name, if it doesn't.  CANON is
+   consumed.  */
 static error_t
-lookup_addrinfo (struct hostmux *mux, const char *host, struct addrinfo *he,
-		 struct node **node)
+lookup_canon (struct hostmux *mux, const char *host, char *canon,
+	      struct node **node)
 {
   error_t err;
   struct hostmux_name *nm = malloc (sizeof (struct hostmux_name));
 
   if (! nm)
-    return ENOMEM;
+    {
+      free (canon);
+      return ENOMEM;
+    }
 
   nm->name = strdup (host);
-  if (!he || strcmp (host, he->ai_canonname) == 0)
-    nm->canon = nm->name;
+  if (!canon || strcmp (host, canon) == 0)
+    {
+      nm->canon = nm->name;
+      free (canon);
+    }
   else
-    nm->canon = strdup (he->ai_canonname);
+    nm->canon = canon;
 
   err = create_host_node (mux, nm, node);
   if (err)
@@ -294,7 +313,7 @@ lookup_addrinfo (struct hostmux *mux, const char *host, struct addrinfo *he,
     }
 
   pthread_rwlock_wrlock (&mux->names_lock);
-  if (lookup_cached (mux, host, 1, node))
+  if (lookup_cached (mux, host, node))
     /* An entry for HOST has already been created between the time we last
        looked and now (which is possible because we didn't lock MUX).
        Just throw away our version and return the one already in the cache.  */
@@ -307,8 +326,22 @@ lookup_addrinfo (struct hostmux *mux, const char *host, struct addrinfo *he,
   else
     /* Enter NM into MUX's list of names, and return the new node.  */
     {
+      err = hurd_ihash_add (&mux->names_ht, (hurd_ihash_key_t) nm->name, nm);
+      if (err)
+	{
+	  pthread_rwlock_unlock (&mux->names_lock);
+	  nm->node->nn->name = 0;
+	  netfs_nrele (nm->node);
+	  free_name (nm);
+	  *node = 0;
+	  return err;
+	}
+
       nm->fileno = mux->next_fileno++; /* Now that we hold the lock...  */
       nm->next = mux->names;
+      nm->prevp = &mux->names;
+      if (mux->names)
+	mux->names->prevp = &nm->next;
       mux->names = nm;
       pthread_rwlock_unlock (&mux->names_lock);
     }
@@ -316,23 +349,246 @@ lookup_addrinfo (struct hostmux *mux, const char *host, struct addrinfo *he,
   return 0;
 }
 
-/* Lookup the host HOST in MUX, and return the resulting node in NODE, with
-   an additional reference, or an error.  */
-static error_t
-lookup_host (struct hostmux *mux, const char *host, struct node **node)
+/* Return the current time in seconds.  */
+static time_t
+now (void)
 {
-  int was_cached;
-  int h_err;
+  struct timeval tv;
+  maptime_read (hostmux_maptime, &tv);
+  return tv.tv_sec;
+}
+
+/* Take R out of its mux's list of resolutions by age.  The mux's
+   RESOLVE_LOCK must be held.  */
+static void
+unlink_resolved (struct hostmux_resolved *r)
+{
+  struct hostmux *mux = r->mux;
+
+  if (r->older)
+    r->older->newer = r->newer;
+  else
+    mux->resolved_oldest = r->newer;
+  if (r->newer)
+    r->newer->older = r->older;
+  else
+    mux->resolved_newest = r->older;
+  r->older = r->newer = 0;
+}
+
+/* Put R at the new end of its mux's list of resolutions by age.  The
+   mux's RESOLVE_LOCK must be held.  */
+static void
+link_resolved (struct hostmux_resolved *r)
+{
+  struct hostmux *mux = r->mux;
+
+  r->newer = 0;
+  r->older = mux->resolved_newest;
+  if (r->older)
+    r->older->newer = r;
+  else
+    mux->resolved_oldest = r;
+  mux->resolved_newest = r;
+}
+
+/* Resolve the name of R, which must have been marked as being resolved
+   by the caller, and record the result in R.  */
+static void
+resolve (struct hostmux_resolved *r)
+{
+  struct hostmux *mux = r->mux;
   struct addrinfo *ai;
   struct addrinfo hints;
+  char *canon = NULL;
+  error_t err;
+  int h_err;
 
+  memset (&hints, 0, sizeof hints);
   hints.ai_flags = AI_CANONNAME;
   hints.ai_family = PF_INET;
   hints.ai_socktype = SOCK_DGRAM;
   hints.ai_protocol  = IPPROTO_IP;
 
+  /* This may take a long time, so don't hold any locks.  */
+  h_err = getaddrinfo (r->name, NULL, &hints, &ai);
+  switch (h_err)
+    {
+    case 0:
+      canon = strdup (ai->ai_canonname ?: r->name);
+      err = canon ? 0 : ENOMEM;
+      freeaddrinfo (ai);
+      break;
+    case EAI_NONAME:
+#ifdef EAI_NODATA
+    case EAI_NODATA:
+#endif
+      err = ENOENT;
+      break;
+    case EAI_MEMORY:
+      err = ENOMEM;
+      break;
+    case EAI_SYSTEM:
+      err = errno;
+      break;
+    default:
+      err = EAGAIN;
+      break;
+    }
+
+  pthread_mutex_lock (&mux->resolve_lock);
+  if (! err)
+    {
+      free (r->canon);
+      r->canon = canon;
+      r->err = 0;
+      r->expires = now () + mux->cache_ttl;
+    }
+  else if (err == ENOENT)
+    {
+      free (r->canon);
+      r->canon = NULL;
+      r->err = err;
+      r->expires = now () + mux->negative_ttl;
+    }
+  else if (r->canon)
+    /* A transient failure; keep using the name we had for a while.  */
+    r->expires = now () + mux->negative_ttl;
+  else
+    {
+      /* A transient failure, and nothing to fall back on.  Report it,
+	 but don't remember it.  */
+      r->err = err;
+      r->expires = 0;
+    }
+  r->resolving = 0;
+  unlink_resolved (r);
+  link_resolved (r);
+  pthread_cond_broadcast (&r->resolved);
+  pthread_mutex_unlock (&mux->resolve_lock);
+}
+
+/* Thread body refreshing a cached resolution in the background.  */
+static void *
+refresh_thread (void *arg)
+{
+  resolve (arg);
+  return NULL;
+}
+
+/* Forget the resolutions in MUX that have expired, starting with the
+   oldest and stopping at the first one that is still good, so this takes
+   time in proportion to the number forgotten.  Negative answers expire
+   sooner than positive ones, so a few may linger behind an older positive
+   one until that expires as well.  MUX's RESOLVE_LOCK must be held.  */
+static void
+expire_resolved (struct hostmux *mux, time_t t)
+{
+  struct hostmux_resolved *r, *newer;
+
+  for (r = mux->resolved_oldest; r && r->expires <= t; r = newer)
+    {
+      newer = r->newer;
+      if (! r->resolving && ! r->users)
+	{
+	  unlink_resolved (r);
+	  hurd_ihash_locp_remove (&mux->resolved, r->locp);
+	  free (r->canon);
+	  free (r->name);
+	  free (r);
+	}
+    }
+}
+
+/* Return the canonical name of HOST in CANON, in malloced storage, using a
+   recent result from MUX's resolution cache if possible.  Entries that are
+   still used close to their expiry are refreshed in the background, so
+   names that are used often do not stall when they expire.  */
+static error_t
+resolve_host (struct hostmux *mux, const char *host, char **canon)
+{
+  struct hostmux_resolved *r;
+  error_t err;
+  time_t t = now ();
+
+  pthread_mutex_lock (&mux->resolve_lock);
+
+  r = hurd_ihash_find (&mux->resolved, (hurd_ihash_key_t) host);
+  if (! r)
+    {
+      expire_resolved (mux, t);
+
+      r = calloc (1, sizeof *r);
+      if (r)
+	r->name = strdup (host);
+      if (! r || ! r->name
+	  || hurd_ihash_add (&mux->resolved, (hurd_ihash_key_t) r->name, r))
+	{
+	  pthread_mutex_unlock (&mux->resolve_lock);
+	  if (r)
+	    free (r->name);
+	  free (r);
+	  return ENOMEM;
+	}
+      r->mux = mux;
+      pthread_cond_init (&r->resolved, NULL);
+      link_resolved (r);
+    }
+
+  r->users++;
+
+  if (! r->resolving)
+    {
+      if (r->expires <= t)
+	{
+	  /* We have no usable answer; resolve the name ourselves.  */
+	  r->resolving = 1;
+	  pthread_mutex_unlock (&mux->resolve_lock);
+	  resolve (r);
+	  pthread_mutex_lock (&mux->resolve_lock);
+	}
+      else if (r->canon && r->expires - t <= mux->cache_ttl / 4)
+	{
+	  /* This name is still being used, and is about to expire.  */
+	  pthread_t thread;
+
+	  r->resolving = 1;
+	  if (pthread_create (&thread, NULL, refresh_thread, r) == 0)
+	    pthread_detach (thread);
+	  else
+	    r->resolving = 0;
+	}
+    }
+
+  /* Wait if a resolution is in progress, unless there is an answer we
+     can use meanwhile.  */
+  while (r->resolving && !(r->expires > t && (r->canon || r->err)))
+    pthread_cond_wait (&r->resolved, &mux->resolve_lock);
+
+  if (r->canon)
+    {
+      *canon = strdup (r->canon);
+      err = *canon ? 0 : ENOMEM;
+    }
+  else
+    err = r->err;
+
+  r->users--;
+  pthread_mutex_unlock (&mux->resolve_lock);
+  return err;
+}
+
+/* Lookup the host HOST in MUX, and return the resulting node in NODE, with
+   an additional reference, or an error.  */
+static error_t
+lookup_host (struct hostmux *mux, const char *host, struct node **node)
+{
+  error_t err;
+  int was_cached;
+  char *canon = NULL;
+
   pthread_rwlock_rdlock (&mux->names_lock);
-  was_cached = lookup_cached (mux, host, 0, node);
+  was_cached = lookup_cached (mux, host, node);
   pthread_rwlock_unlock (&mux->names_lock);
 
   if (was_cached)
@@ -340,19 +596,14 @@ lookup_host (struct hostmux *mux, const char *host, struct node **node)
 
   if (mux->canonicalize)
     {
-      h_err = getaddrinfo (host, NULL, &hints, &ai);
-      if (! h_err)
-	{
-	  h_err = lookup_addrinfo (mux, host, ai, node);
-	  freeaddrinfo (ai);
-	}
+      err = resolve_host (mux, host, &canon);
+      if (err)
+	return err;
     }
-  else
-    h_err = lookup_addrinfo (mux, host, NULL, node);
 
-  return h_err;
+  return lookup_canon (mux, host, canon, node);
 }
-
+
 /* This should sync the entire remote filesystem.  If WAIT is set, return
    only after sync is completely finished.  */
 error_t
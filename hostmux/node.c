@@ -1,6 +1,6 @@
 /* General fs node functions
 
-   Copyright (C) 1997, 1999, 2007 Free Software Foundation, Inc.
+   Copyright (C) 1997, 1999, 2007, 2026 Free Software Foundation, Inc.
 
    Written by Miles Bader <miles@gnu.ai.mit.edu>
 
@@ -31,9 +31,8 @@ void
 netfs_node_norefs (struct node *node)
 {
   if (node->nn->name)
-    /* Remove our name's pointer to us; the name itself will eventually be
-       freed by another party.  */
-    node->nn->name->node = 0;
+    /* Our name goes with us.  */
+    hostmux_drop_name (node->nn->mux, node->nn->name);
   free (node->nn);
   free (node);
 }
@@ -1,5 +1,5 @@
 /* C declarations for Hurd default pager interface
-   Copyright (C) 2001 Free Software Foundation, Inc.
+   Copyright (C) 2001, 2026 Free Software Foundation, Inc.
 
 This file is part of the GNU Hurd.
 
@@ -29,4 +29,28 @@ typedef const recnum_t *const_recnum_array_t;
 typedef vm_size_t *vm_size_array_t;
 typedef const vm_size_t *const_vm_size_array_t;
 
+/* Indices into the array returned by default_pager_server_stats.  The
+   counters come in two groups, one for the threads serving internal
+   objects (those the kernel pages out) and one for those serving
+   objects made by default_pager_object_create.  */
+enum default_pager_stat
+  {
+    DPS_INTERNAL_THREADS,	/* Threads started.  */
+    DPS_INTERNAL_BUSY,		/* Requests being handled right now.  */
+    DPS_INTERNAL_BUSY_MAX,	/* Most requests ever handled at once.  */
+    DPS_INTERNAL_SATURATED,	/* Requests that found every thread busy
+				   and no more to be started.  */
+    DPS_INTERNAL_REQUESTS,	/* Requests handled.  */
+    DPS_EXTERNAL_THREADS,
+    DPS_EXTERNAL_BUSY,
+    DPS_EXTERNAL_BUSY_MAX,
+    DPS_EXTERNAL_SATURATED,
+    DPS_EXTERNAL_REQUESTS,
+    DPS_SEQNO_WAITS,		/* Requests that queued behind an earlier
+				   one for the same object.  */
+    DPS_READ_WAITS,		/* Waits for reads to finish.  */
+    DPS_WRITE_WAITS,		/* Waits for writes to finish.  */
+    DPS_MAX
+  };
+
 #endif
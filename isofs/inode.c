@@ -1,5 +1,5 @@
 /*
-   Copyright (C) 1997, 1998, 2002, 2007 Free Software Foundation, Inc.
+   Copyright (C) 1997, 1998, 2002, 2007, 2026 Free Software Foundation, Inc.
    Written by Thomas Bushnell, n/BSG.
 
    This file is part of the GNU Hurd.
@@ -245,6 +245,23 @@ diskfs_user_read_node (struct node *np, struct lookup_context *ctx)
     /* XXX ??? */
     st->st_size = 0;
 
+  np->dn->zf_block_log2 = 0;
+#ifdef HAVE_ZISOFS
+  /* Only believe ZF if the data starts with the zisofs header; if it
+     does not, we serve the data as it is.  */
+  if ((rl->valid & VALID_ZF) && S_ISREG (st->st_mode)
+      && rl->zfheader_size >= 16
+      && st->st_size >= rl->zfheader_size
+      && !memcmp (disk_image + (np->dn->file_start << store->log2_block_size),
+		  ZF_MAGIC, 8))
+    {
+      np->dn->zf_block_log2 = rl->zfblock_log2;
+      np->dn->zf_header_size = rl->zfheader_size;
+      np->dn->zf_disk_size = st->st_size;
+      st->st_size = rl->zfsize;
+    }
+#endif
+
   /* Calculate these if we'll need them */
   if (!(rl->valid & VALID_TF)
       || ((rl->tfflags & (TF_CREATION|TF_ACCESS|TF_MODIFY))
@@ -269,7 +286,9 @@ diskfs_user_read_node (struct node *np, struct lookup_context *ctx)
     }
 
   st->st_blksize = logical_block_size;
-  st->st_blocks = (st->st_size - 1) / 512 + 1;
+  /* A compressed file takes up only its compressed size on disk.  */
+  st->st_blocks = ((np->dn->zf_block_log2 ? np->dn->zf_disk_size
+		    : st->st_size) - 1) / 512 + 1;
 
   if (rl->valid & VALID_FL)
     st->st_flags = rl->flags;
@@ -1,5 +1,5 @@
 /* 
-   Copyright (C) 1997 Free Software Foundation, Inc.
+   Copyright (C) 1997, 2026 Free Software Foundation, Inc.
    Written by Thomas Bushnell, n/BSG.
 
    This file is part of the GNU Hurd.
@@ -99,6 +99,13 @@ struct dirrect
 
 #include <endian.h>
 
+static inline unsigned int
+isonum_731 (unsigned char *addr)
+{
+  return addr[0] | (addr[1] << 8) | (addr[2] << 16) |
+    (((unsigned int) addr[3]) << 24);
+}
+
 static inline unsigned int 
 isonum_733 (unsigned char *addr)
 {
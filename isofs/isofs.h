@@ -1,5 +1,5 @@
 /*
-   Copyright (C) 1997, 1999 Free Software Foundation, Inc.
+   Copyright (C) 1997, 1999, 2026 Free Software Foundation, Inc.
    Written by Thomas Bushnell, n/BSG.
 
    This file is part of the GNU Hurd.
@@ -43,6 +43,12 @@ struct disknode
 
   size_t translen;
   char *translator;
+
+  /* If the data is compressed with zisofs, log2 of the size of its
+     blocks, else zero.  ST_SIZE is then the uncompressed size.  */
+  int zf_block_log2;
+  size_t zf_header_size;	/* Bytes before the block pointers */
+  off_t zf_disk_size;		/* Compressed size on disk */
 };
 
 struct user_pager_info
@@ -102,5 +108,12 @@ error_t cache_id (struct dirrect *record, struct rrip_lookup *rr, ino_t *idp);
 
 error_t calculate_file_start (struct dirrect *, off_t *, struct rrip_lookup *);
 
+#ifdef HAVE_ZISOFS
+/* Fill *BUF with a new page holding the data at PAGE of the
+   zisofs-compressed file NP.  */
+error_t zisofs_read_page (struct node *np, vm_offset_t page,
+			  vm_address_t *buf);
+#endif
+
 char *isodate_915 (char *, struct timespec *);
 char *isodate_84261 (char *, struct timespec *);
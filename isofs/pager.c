@@ -1,5 +1,5 @@
 /* 
-   Copyright (C) 1997, 1999 Free Software Foundation, Inc.
+   Copyright (C) 1997, 1999, 2026 Free Software Foundation, Inc.
    Written by Thomas Bushnell, n/BSG.
 
    This file is part of the GNU Hurd.
@@ -59,6 +59,11 @@ pager_read_page (struct user_pager_info *upi,
 	  return 0;
 	}
 
+#ifdef HAVE_ZISOFS
+      if (np->dn->zf_block_log2)
+	return zisofs_read_page (np, page, buf);
+#endif
+
       if (page + vm_page_size > np->dn_stat.st_size)
 	overrun = page + vm_page_size - np->dn_stat.st_size;
     }
@@ -1,5 +1,5 @@
 /*
-   Copyright (C) 1997,99,2002 Free Software Foundation, Inc.
+   Copyright (C) 1997,99,2002,2026 Free Software Foundation, Inc.
    Written by Thomas Bushnell, n/BSG.
 
    This file is part of the GNU Hurd.
@@ -548,6 +548,25 @@ rrip_work (struct dirrect *dr, struct rrip_lookup *rr,
 	  goto next_field;
 	}
 
+      /* ZF says the file data is compressed with zisofs.  */
+      if (susp->sig[0] == 'Z'
+	  && susp->sig[1] == 'F'
+	  && susp->version == 1)
+	{
+	  struct rr_zf *zf = body;
+
+	  if (zf->algorithm[0] == 'p' && zf->algorithm[1] == 'z'
+	      && zf->block_log2 >= ZF_BLOCK_LOG2_MIN
+	      && zf->block_log2 <= ZF_BLOCK_LOG2_MAX)
+	    {
+	      rr->zfblock_log2 = zf->block_log2;
+	      rr->zfheader_size = zf->header_size << 2;
+	      rr->zfsize = isonum_733 (zf->size);
+	      rr->valid |= VALID_ZF;
+	    }
+	  goto next_field;
+	}
+
       /* The rest are GNU ext. */
       if (!gnuext_live)
 	goto next_field;
@@ -1,5 +1,5 @@
 /*
-   Copyright (C) 1997, 1999 Free Software Foundation, Inc.
+   Copyright (C) 1997, 1999, 2026 Free Software Foundation, Inc.
    Written by Thomas Bushnell, n/BSG.
 
    This file is part of the GNU Hurd.
@@ -67,6 +67,11 @@ struct rrip_lookup
   /* FL */
   long flags;
 
+  /* ZF */
+  int zfblock_log2;		/* log2 of the compression block size */
+  size_t zfheader_size;		/* bytes before the block pointers */
+  off_t zfsize;			/* uncompressed size of the file */
+
   int valid;
 };
 
@@ -83,6 +88,7 @@ struct rrip_lookup
 #define VALID_TR	0x0200
 #define VALID_MD	0x0400
 #define VALID_FL	0x0800
+#define VALID_ZF	0x1000
 
 
 /* Definitions for System Use Sharing Protocol.
@@ -222,6 +228,25 @@ struct rr_sf
 };
 
 
+/* The ZF (zisofs compressed file) field, as written by mkisofs -z.
+   The file data then starts with a header giving the same
+   information, followed by a table of little-endian 32 bit offsets
+   from the start of the file, one for each block and one for the end
+   of the last one.  Each block is a zlib stream; an empty one stands
+   for a block of zeros.  */
+struct rr_zf
+{
+  char algorithm[2];		/* "pz" */
+  u_char header_size;		/* in 4 byte units */
+  u_char block_log2;
+  unsigned char size[8];	/* uncompressed size */
+};
+
+#define ZF_MAGIC	"\x37\xe4\x53\x96\xc9\xdb\xd6\x07"
+#define ZF_BLOCK_LOG2_MIN	15
+#define ZF_BLOCK_LOG2_MAX	17
+
+
 /* GNU extensions */
 
 #define GNUEXT_VERS	1
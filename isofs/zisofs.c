@@ -0,0 +1,232 @@
+/* Reading zisofs-compressed files
+   Copyright (C) 2026 Free Software Foundation, Inc.
+
+   This file is part of the GNU Hurd.
+
+   The GNU Hurd is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation; either version 2, or (at
+   your option) any later version.
+
+   The GNU Hurd is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with the GNU Hurd.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/param.h>
+#include <zlib.h>
+#include "isofs.h"
+
+/* A compression block is at least 32K, so it holds several pages, and
+   the kernel asks for them one at a time.  We keep the last few blocks
+   we decompressed, so that reading a file through only decompresses
+   each block once.  Blocks are at most 128K, which bounds the cache at
+   4M.  */
+#define ZCACHE_BLOCKS 32
+
+struct zcache_entry
+{
+  off_t file_start;		/* Identifies the file, ...  */
+  unsigned long block;		/* ... and this the block in it.  */
+  char *data;			/* Decompressed data, or NULL if unused.  */
+  size_t len;
+  unsigned long used;		/* ZCACHE_CLOCK when last used.  */
+};
+
+static struct zcache_entry zcache[ZCACHE_BLOCKS];
+static unsigned long zcache_clock;
+static pthread_mutex_t zcache_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/* Return the cached data of BLOCK of the file at FILE_START, or NULL.
+   ZCACHE_LOCK must be held.  */
+static struct zcache_entry *
+zcache_lookup (off_t file_start, unsigned long block)
+{
+  int i;
+
+  for (i = 0; i < ZCACHE_BLOCKS; i++)
+    if (zcache[i].data
+	&& zcache[i].file_start == file_start && zcache[i].block == block)
+      {
+	zcache[i].used = ++zcache_clock;
+	return &zcache[i];
+      }
+  return NULL;
+}
+
+/* Add the LEN bytes at DATA, which is malloced, to the cache as BLOCK
+   of the file at FILE_START, evicting the least recently used block if
+   the cache is full.  ZCACHE_LOCK must be held.  */
+static void
+zcache_enter (off_t file_start, unsigned long block, char *data, size_t len)
+{
+  struct zcache_entry *victim = &zcache[0];
+  int i;
+
+  if (zcache_lookup (file_start, block))
+    {
+      /* Somebody else decompressed it meanwhile.  */
+      free (data);
+      return;
+    }
+
+  for (i = 0; i < ZCACHE_BLOCKS; i++)
+    {
+      if (!zcache[i].data)
+	{
+	  victim = &zcache[i];
+	  break;
+	}
+      if (zcache[i].used < victim->used)
+	victim = &zcache[i];
+    }
+
+  free (victim->data);
+  victim->file_start = file_start;
+  victim->block = block;
+  victim->data = data;
+  victim->len = len;
+  victim->used = ++zcache_clock;
+}
+
+/* Decompress BLOCK of the zisofs file DN into a malloced buffer
+   returned in *DATA, and its length in *LEN.  A block of zeros is
+   returned as a NULL *DATA.  */
+static error_t
+zisofs_decompress (struct disknode *dn, unsigned long block,
+		   char **data, size_t *len)
+{
+  size_t block_size = (size_t) 1 << dn->zf_block_log2;
+  unsigned char *file = disk_image + (dn->file_start
+				      << store->log2_block_size);
+  off_t ptr = dn->zf_header_size + 4 * (off_t) block;
+  unsigned int start, end;
+  void *in;
+  char *out;
+  z_stream z;
+  error_t err;
+  int zerr;
+
+  *data = NULL;
+  *len = 0;
+
+  if (ptr + 8 > dn->zf_disk_size)
+    return EIO;
+
+  err = diskfs_catch_exception ();
+  if (err)
+    return err;
+  start = isonum_731 (file + ptr);
+  end = isonum_731 (file + ptr + 4);
+  diskfs_end_catch_exception ();
+
+  /* zlib never grows data by more than a few bytes per 16K.  */
+  if (end < start || end > dn->zf_disk_size
+      || end - start > block_size + block_size / 128 + 64)
+    return EIO;
+  if (start == end)
+    return 0;
+
+  in = malloc (end - start);
+  out = malloc (block_size);
+  if (!in || !out)
+    {
+      free (in);
+      free (out);
+      return ENOMEM;
+    }
+
+  /* Copy the compressed data out of the disk image first, so that a
+     fault while reading it cannot leave zlib half done.  */
+  err = diskfs_catch_exception ();
+  if (err)
+    {
+      free (in);
+      free (out);
+      return err;
+    }
+  memcpy (in, file + start, end - start);
+  diskfs_end_catch_exception ();
+
+  memset (&z, 0, sizeof z);
+  zerr = inflateInit (&z);
+  if (zerr == Z_OK)
+    {
+      z.next_in = in;
+      z.avail_in = end - start;
+      z.next_out = (Bytef *) out;
+      z.avail_out = block_size;
+      zerr = inflate (&z, Z_FINISH);
+      *len = block_size - z.avail_out;
+      inflateEnd (&z);
+    }
+  free (in);
+
+  if (zerr != Z_STREAM_END)
+    {
+      free (out);
+      *len = 0;
+      return zerr == Z_MEM_ERROR ? ENOMEM : EIO;
+    }
+
+  *data = out;
+  return 0;
+}
+
+error_t
+zisofs_read_page (struct node *np, vm_offset_t page, vm_address_t *buf)
+{
+  struct disknode *dn = np->dn;
+  unsigned long block = page >> dn->zf_block_log2;
+  size_t offset = page & (((size_t) 1 << dn->zf_block_log2) - 1);
+  struct zcache_entry *e;
+  char *data;
+  size_t len;
+  void *p;
+  error_t err;
+
+  p = mmap (0, vm_page_size, PROT_READ|PROT_WRITE, MAP_ANON, 0, 0);
+  if (p == MAP_FAILED)
+    return errno;
+
+  pthread_mutex_lock (&zcache_lock);
+  e = zcache_lookup (dn->file_start, block);
+  if (e)
+    {
+      if (offset < e->len)
+	memcpy (p, e->data + offset, MIN (vm_page_size, e->len - offset));
+      pthread_mutex_unlock (&zcache_lock);
+      *buf = (vm_address_t) p;
+      return 0;
+    }
+  pthread_mutex_unlock (&zcache_lock);
+
+  /* Decompress without holding the lock, so that pageins of other
+     blocks can go on meanwhile.  */
+  err = zisofs_decompress (dn, block, &data, &len);
+  if (err)
+    {
+      munmap (p, vm_page_size);
+      return err;
+    }
+
+  /* Anything past the end of the data is already zero.  */
+  if (data)
+    {
+      if (offset < len)
+	memcpy (p, data + offset, MIN (vm_page_size, len - offset));
+
+      pthread_mutex_lock (&zcache_lock);
+      zcache_enter (dn->file_start, block, data, len);
+      pthread_mutex_unlock (&zcache_lock);
+    }
+
+  *buf = (vm_address_t) p;
+  return 0;
+}
@@ -1,6 +1,6 @@
 /* Definitions for fileserver helper functions
 
-   Copyright (C) 1994-1999, 2001, 2002, 2007-2009, 2013-2019
+   Copyright (C) 1994-1999, 2001, 2002, 2007-2009, 2013-2019, 2026
    Free Software Foundation, Inc.
 
    This program is free software; you can redistribute it and/or
@@ -584,6 +584,16 @@ extern error_t (*diskfs_create_symlink_hook)(struct node *np, const char *target
    used.  If it returns any other error, it is returned to the user. */
 extern error_t (*diskfs_read_symlink_hook)(struct node *np, char *target);
 
+/* If this function is nonzero it is called to read (DIR clear) or write
+   (DIR set) *AMT bytes of locked file NP at OFFSET from or into DATA.
+   The file size already permits the access.  On success it sets *AMT
+   to the number of bytes transferred.  If it returns EINVAL or isn't
+   set, then the normal method (copying through the memory object
+   returned by diskfs_get_filemap) is used.  If it returns any other
+   error, it is returned to the user.  */
+extern error_t (*diskfs_rdwr_hook)(struct node *np, char *data, off_t offset,
+				   size_t *amt, int dir);
+
 /* The user may define this function.  The function must set source to
    the source of the translator. The function may return an EOPNOTSUPP
    to indicate that the concept of a source device is not
@@ -1,5 +1,5 @@
 /* libdiskfs implementation of fs.defs: file_set_size
-   Copyright (C) 1992, 1993, 1994, 1995 Free Software Foundation
+   Copyright (C) 1992, 1993, 1994, 1995, 2026 Free Software Foundation
 
    This program is free software; you can redistribute it and/or
    modify it under the terms of the GNU General Public License as
@@ -28,28 +28,35 @@ diskfs_S_file_set_size (struct protid *cred,
 		     ({
 		       if (!(cred->po->openstat & O_WRITE) || (size < 0))
 			 err = EINVAL;
-		       else if (size < np->dn_stat.st_size)
-			 {
-			   err = diskfs_truncate (np, size);
-			   if (!err && np->filemod_reqs)
-			     diskfs_notice_filechange (np, 
-						       FILE_CHANGED_TRUNCATE, 
-						       0, size);
-			 }
-		       else if (size > np->dn_stat.st_size)
+		       else
 			 {
-			   err = diskfs_grow (np, size, cred);
-			   if (! err)
+			   /* A user holding the conch would otherwise put
+			      back its idea of the size later.  */
+			   iohelp_get_conch (&np->conch);
+
+			   if (size < np->dn_stat.st_size)
 			     {
-			       np->dn_stat.st_size = size;
-			       np->dn_set_ctime = np->dn_set_mtime = 1;
-			       if (np->filemod_reqs)
-				 diskfs_notice_filechange (np, 
-							   FILE_CHANGED_EXTEND,
+			       err = diskfs_truncate (np, size);
+			       if (!err && np->filemod_reqs)
+				 diskfs_notice_filechange (np,
+							   FILE_CHANGED_TRUNCATE,
 							   0, size);
 			     }
+			   else if (size > np->dn_stat.st_size)
+			     {
+			       err = diskfs_grow (np, size, cred);
+			       if (! err)
+				 {
+				   np->dn_stat.st_size = size;
+				   np->dn_set_ctime = np->dn_set_mtime = 1;
+				   if (np->filemod_reqs)
+				     diskfs_notice_filechange (np,
+							       FILE_CHANGED_EXTEND,
+							       0, size);
+				 }
+			     }
+			   else
+			     err = 0; /* Setting to same size.  */
 			 }
-		       else
-			 err = 0; /* Setting to same size.  */
 		     }));
 }
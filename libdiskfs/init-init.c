@@ -1,5 +1,5 @@
 /*
-   Copyright (C) 1994, 95, 96, 97, 98, 99, 2001 Free Software Foundation, Inc.
+   Copyright (C) 1994, 95, 96, 97, 98, 99, 2001, 2026 Free Software Foundation, Inc.
 
    This file is part of the GNU Hurd.
 
@@ -74,11 +74,7 @@ diskfs_init_diskfs (void)
 	return err;
     }
 
-  /* First try to use /dev/time...  */
-  err = maptime_map (0, NULL, &diskfs_mtime);
-  if (err)
-    /* ... and fall back to the Mach time device.  */
-    err = maptime_map (1, NULL, &diskfs_mtime);
+  err = maptime_map_any (&diskfs_mtime);
   if (err)
     return err;
 
@@ -1,5 +1,5 @@
 /* 
-   Copyright (C) 1994, 1995, 1996, 2001 Free Software Foundation
+   Copyright (C) 1994, 1995, 1996, 2001, 2026 Free Software Foundation
 
    This program is free software; you can redistribute it and/or
    modify it under the terms of the GNU General Public License as
@@ -64,6 +64,13 @@ diskfs_S_io_prenotify (struct protid *cred,
   err = diskfs_grow (np, end, cred);
   if (diskfs_synchronous)
     diskfs_node_update (np, 1);
+  if (!err)
+    {
+      /* Tell the user how far it may now write without asking.  */
+      pthread_spin_lock (&cred->mapped->lock);
+      iohelp_put_shared_data (cred);
+      pthread_spin_unlock (&cred->mapped->lock);
+    }
   if (!err && np->filemod_reqs)
     diskfs_notice_filechange (np, FILE_CHANGED_EXTEND, 0, end);
  out:
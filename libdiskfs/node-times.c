@@ -1,7 +1,7 @@
 /* Process st_?tim updates marked for a diskfs node.
 
-   Copyright (C) 1994, 1996, 1999, 2000, 2007, 2009 Free Software Foundation,
-   Inc.
+   Copyright (C) 1994, 1996, 1999, 2000, 2007, 2009, 2026 Free Software
+   Foundation, Inc.
 
    This file is part of the GNU Hurd.
 
@@ -32,8 +32,6 @@
 int
 atime_should_update (struct node *np)
 {
-  struct timeval t;
-
   if (_diskfs_noatime)
     return 0;
 
@@ -46,8 +44,8 @@ atime_should_update (struct node *np)
       if (np->dn_stat.st_ctim.tv_sec >= np->dn_stat.st_atim.tv_sec)
         return 1;
       /* Update atime if current atime is more than 24 hours old. */
-      maptime_read (diskfs_mtime, &t);
-      if ((long)(t.tv_sec - np->dn_stat.st_atim.tv_sec) >= 24 * 60 * 60)
+      if ((long)(maptime_seconds (diskfs_mtime) - np->dn_stat.st_atim.tv_sec)
+	  >= 24 * 60 * 60)
           return 1;
       return 0;
     }
@@ -71,12 +69,12 @@ diskfs_set_node_atime (struct node *np)
 void
 diskfs_set_node_times (struct node *np)
 {
-  struct timeval t;
+  struct timespec t;
 
   if (!np->dn_set_mtime && !np->dn_set_atime && !np->dn_set_ctime)
     return;
 
-  maptime_read (diskfs_mtime, &t);
+  maptime_read_timespec (diskfs_mtime, &t);
 
   /* We are careful to test and reset each of these individually, so there
      is no race condition where a dn_set_?time flag setting gets lost.  It
@@ -85,22 +83,19 @@ diskfs_set_node_times (struct node *np)
      the update will happen at the next call.  */
   if (np->dn_set_mtime)
     {
-      np->dn_stat.st_mtim.tv_sec = t.tv_sec;
-      np->dn_stat.st_mtim.tv_nsec = t.tv_usec * 1000;
+      np->dn_stat.st_mtim = t;
       np->dn_stat_dirty = 1;
       np->dn_set_mtime = 0;
     }
   if (np->dn_set_atime)
     {
-      np->dn_stat.st_atim.tv_sec = t.tv_sec;
-      np->dn_stat.st_atim.tv_nsec = t.tv_usec * 1000;
+      np->dn_stat.st_atim = t;
       np->dn_stat_dirty = 1;
       np->dn_set_atime = 0;
     }
   if (np->dn_set_ctime)
     {
-      np->dn_stat.st_ctim.tv_sec = t.tv_sec;
-      np->dn_stat.st_ctim.tv_nsec = t.tv_usec * 1000;
+      np->dn_stat.st_ctim = t;
       np->dn_stat_dirty = 1;
       np->dn_set_ctime = 0;
     }
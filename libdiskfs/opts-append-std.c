@@ -1,6 +1,6 @@
 /* Get standard diskfs run-time options
 
-   Copyright (C) 1995, 96,97,98,99,2002 Free Software Foundation, Inc.
+   Copyright (C) 1995, 96,97,98,99,2002,2026 Free Software Foundation, Inc.
 
    Written by Miles Bader <miles@gnu.org>
 
@@ -64,5 +64,23 @@ diskfs_append_std_options (char **argz, size_t *argz_len)
 	}
     }
 
+  if (! err)
+    {
+      /* Report the translators started for our nodes, passive ones
+	 included.  */
+      struct fshelp_start_totals totals;
+
+      fshelp_start_translator_totals (&totals);
+      if (totals.starts > 0)
+	{
+	  char buf[200];
+	  snprintf (buf, sizeof buf,
+		    "--translator-start-times=%lu:%llu/%llu/%llu/%llu",
+		    totals.starts, totals.lookup, totals.task,
+		    totals.exec, totals.startup);
+	  err = argz_add (argz, argz_len, buf);
+	}
+    }
+
   return err;
 }
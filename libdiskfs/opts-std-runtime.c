@@ -1,6 +1,6 @@
 /* Parse standard run-time options
 
-   Copyright (C) 1995, 1996, 1997, 1998, 1999 Free Software Foundation, Inc.
+   Copyright (C) 1995, 1996, 1997, 1998, 1999, 2026 Free Software Foundation, Inc.
 
    This file is part of the GNU Hurd.
 
@@ -22,11 +22,17 @@
 
 #include "priv.h"
 
+#define OPT_TRANSLATOR_START_TIMES	(-1)
+
 static const struct argp_option
 std_runtime_options[] =
 {
   {"update", 'u',  0, 0, "Flush any meta-data cached in core"},
   {"remount", 0, 0, OPTION_HIDDEN | OPTION_ALIAS}, /* deprecated */
+  {"translator-start-times", OPT_TRANSLATOR_START_TIMES, "TIMES",
+   OPTION_ARG_OPTIONAL, "Ignored; fsysopts shows here how many translators"
+   " were started and how long they took, as"
+   " STARTS:LOOKUP/TASK/EXEC/STARTUP microseconds in total"},
   {0, 0}
 };
 
@@ -100,6 +106,7 @@ parse_opt (int opt, char *arg, struct argp_state *state)
     case 'r': h->readonly = 1; break;
     case 'w': h->readonly = 0; break;
     case 'u': h->remount = 1; break;
+    case OPT_TRANSLATOR_START_TIMES: break;
     case 'S': h->nosuid = 1; break;
     case 'E': h->noexec = 1; break;
     case 'A':
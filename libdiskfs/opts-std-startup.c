@@ -1,6 +1,6 @@
 /* Standard startup-time command line parser
 
-   Copyright (C) 1995, 1996, 1997, 1998, 1999, 2001, 2007
+   Copyright (C) 1995, 1996, 1997, 1998, 1999, 2001, 2007, 2026
      Free Software Foundation, Inc.
 
    Written by Miles Bader <miles@gnu.org>
@@ -47,6 +47,7 @@ mach_port_t diskfs_kernel_task = MACH_PORT_NULL;
 #define OPT_BOOT_INIT_PROGRAM	(-6)
 #define OPT_BOOT_PAUSE		(-7)
 #define OPT_KERNEL_TASK		(-8)
+#define OPT_TRANSLATOR_SPARES	(-9)
 
 static const struct argp_option
 startup_options[] =
@@ -55,6 +56,9 @@ startup_options[] =
    "Use DIRECTORY as the root of the filesystem"},
   {"virtual-root",	 0, 0, OPTION_ALIAS},
   {"chroot",		 0, 0, OPTION_ALIAS},
+  {"translator-spares",	 OPT_TRANSLATOR_SPARES,	 "N", 0,
+   "Keep N empty tasks ready for starting passive translators, so that"
+   " the first lookup of a translated node waits less"},
 
   {0,0,0,0, "Boot options:", -2},
   {"multiboot-command-line", OPT_BOOT_CMDLINE, "ARGS", 0,
@@ -131,6 +135,13 @@ parse_startup_opt (int opt, char *arg, struct argp_state *state)
       _diskfs_boot_pause = 1; break;
     case 'C':
       _diskfs_chroot_directory = arg; break;
+    case OPT_TRANSLATOR_SPARES:
+      {
+	error_t err = fshelp_set_spare_tasks (atoi (arg));
+	if (err)
+	  argp_failure (state, 1, err, "%s", arg);
+      }
+      break;
 
     case OPT_BOOT_COMMAND:
       if (state->next == state->argc)
@@ -1,5 +1,5 @@
 /* Default values for weak variables
-   Copyright (C) 1996 Free Software Foundation, Inc.
+   Copyright (C) 1996, 2026 Free Software Foundation, Inc.
    Written by Thomas Bushnell, n/BSG.
 
    This file is part of the GNU Hurd.
@@ -31,3 +31,6 @@ error_t (*diskfs_create_symlink_hook)(struct node *np, const char *target)
   __attribute__ ((weak));
 error_t (*diskfs_read_symlink_hook)(struct node *np, char *target)
   __attribute__ ((weak));
+error_t (*diskfs_rdwr_hook)(struct node *np, char *data, off_t offset,
+			    size_t *amt, int dir)
+  __attribute__ ((weak));
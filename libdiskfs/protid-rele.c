@@ -1,5 +1,5 @@
 /* 
-   Copyright (C) 1994, 1999 Free Software Foundation
+   Copyright (C) 1994, 1999, 2026 Free Software Foundation
 
    This program is free software; you can redistribute it and/or
    modify it under the terms of the GNU General Public License as
@@ -30,6 +30,13 @@ diskfs_protid_rele (void *arg)
   if (cred->shared_object)
     mach_port_deallocate (mach_task_self (), cred->shared_object);
   if (cred->mapped)
-    munmap (cred->mapped, vm_page_size);
+    {
+      /* Take back the conch, and whatever the user left in the shared
+	 page, before it goes away.  */
+      pthread_mutex_lock (&cred->po->np->lock);
+      iohelp_handle_io_release_conch (&cred->po->np->conch, cred);
+      pthread_mutex_unlock (&cred->po->np->lock);
+      munmap (cred->mapped, vm_page_size);
+    }
   diskfs_release_peropen (cred->po);
 }
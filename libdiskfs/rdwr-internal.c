@@ -1,5 +1,5 @@
 /*
-   Copyright (C) 1994,95,96,97,99,2000 Free Software Foundation, Inc.
+   Copyright (C) 1994,95,96,97,99,2000,26 Free Software Foundation, Inc.
 
    This program is free software; you can redistribute it and/or
    modify it under the terms of the GNU General Public License as
@@ -49,6 +49,19 @@ _diskfs_rdwr_internal (struct node *np, char *data, off_t offset,
 	np->dn_set_atime = 1;
     }
 
+  if (diskfs_rdwr_hook)
+    {
+      size_t amount = *amt;
+      err = (*diskfs_rdwr_hook) (np, data, offset, &amount, dir);
+      if (err != EINVAL)
+	{
+	  if (!err)
+	    *amt = amount;
+	  return err;
+	}
+      err = 0;
+    }
+
   memobj = diskfs_get_filemap (np, prot);
 
   if (memobj == MACH_PORT_NULL)
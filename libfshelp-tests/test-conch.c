@@ -0,0 +1,189 @@
+/* test-conch.c: Test the hand-off of the shared I/O page conch
+
+   Copyright (C) 2026 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation; either version 2, or (at
+   your option) any later version.
+
+   This program is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with the GNU Hurd.  If not, see <http://www.gnu.org/licenses/>.  */
+
+/* This plays both the server, using libiohelp's conch routines as
+   libdiskfs does, and two users of the shared page, A and B.  It exits
+   with status 0 if every hand-off went as <hurd/shared.h> says.  */
+
+#include <error.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <hurd/iohelp.h>
+
+/* The server's lock and conch, and its notion of the file pointer.  */
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+static struct conch conch;
+static off_t file_pointer;
+
+/* The users' shared pages.  */
+static struct shared_io page_a, page_b;
+#define USER_A ((void *) &page_a)
+#define USER_B ((void *) &page_b)
+
+static int fetches, failures;
+
+void
+iohelp_fetch_shared_data (void *user)
+{
+  struct shared_io *sh = user;
+  file_pointer = sh->xx_file_pointer;
+  fetches++;
+}
+
+void
+iohelp_put_shared_data (void *user)
+{
+  struct shared_io *sh = user;
+  sh->xx_file_pointer = file_pointer;
+}
+
+static void
+check (int ok, const char *what)
+{
+  printf ("%s: %s\n", ok ? "PASS" : "FAIL", what);
+  if (! ok)
+    failures++;
+}
+
+static double
+now (void)
+{
+  struct timespec ts;
+  clock_gettime (CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static int
+status (struct shared_io *sh)
+{
+  int st;
+  pthread_spin_lock (&sh->lock);
+  st = sh->conch_status;
+  pthread_spin_unlock (&sh->lock);
+  return st;
+}
+
+static void
+set_status (struct shared_io *sh, int st)
+{
+  pthread_spin_lock (&sh->lock);
+  sh->conch_status = st;
+  pthread_spin_unlock (&sh->lock);
+}
+
+/* Give the conch to USER, as io_get_conch does.  */
+static void
+get_conch (void *user)
+{
+  pthread_mutex_lock (&lock);
+  iohelp_handle_io_get_conch (&conch, user, user);
+  pthread_mutex_unlock (&lock);
+}
+
+/* Take the conch back for the server, and return how long it took.  */
+static double
+server_take (void)
+{
+  double start = now ();
+  pthread_mutex_lock (&lock);
+  iohelp_get_conch (&conch);
+  pthread_mutex_unlock (&lock);
+  return now () - start;
+}
+
+/* User A, while the server waits for the conch: notice USER_RELEASE_CONCH
+   the way a client does when it is done with the shared page, and call
+   io_release_conch.  */
+static void *
+polite_user (void *arg)
+{
+  (void) arg;
+
+  while (status (&page_a) != USER_RELEASE_CONCH)
+    usleep (10000);
+  page_a.xx_file_pointer = 42;
+
+  pthread_mutex_lock (&lock);
+  iohelp_handle_io_release_conch (&conch, USER_A);
+  pthread_mutex_unlock (&lock);
+  return NULL;
+}
+
+int
+main (void)
+{
+  pthread_t thread;
+  double t;
+
+  pthread_spin_init (&page_a.lock, PTHREAD_PROCESS_PRIVATE);
+  pthread_spin_init (&page_b.lock, PTHREAD_PROCESS_PRIVATE);
+  set_status (&page_a, USER_HAS_NOT_CONCH);
+  set_status (&page_b, USER_HAS_NOT_CONCH);
+  iohelp_initialize_conch (&conch, &lock);
+
+  /* A user keeping the conch between calls gives it up at once.  */
+  get_conch (USER_A);
+  check (status (&page_a) == USER_HAS_CONCH, "A gets the conch");
+  page_a.xx_file_pointer = 10;
+  set_status (&page_a, USER_COULD_HAVE_CONCH);
+  fetches = 0;
+  t = server_take ();
+  check (t < 1, "idle holder loses the conch at once");
+  check (status (&page_a) == USER_HAS_NOT_CONCH && conch.holder == 0,
+	 "server holds the conch");
+  check (fetches == 1 && file_pointer == 10, "A's file pointer was fetched");
+
+  /* A busy user is asked to release it, and does.  */
+  get_conch (USER_A);
+  check (page_a.xx_file_pointer == 10, "A's page was refreshed");
+  pthread_create (&thread, NULL, polite_user, NULL);
+  fetches = 0;
+  t = server_take ();
+  pthread_join (thread, NULL);
+  check (t < 4, "released conch is handed over before the timeout");
+  check (status (&page_a) == USER_HAS_NOT_CONCH, "A no longer has it");
+  check (fetches == 1 && file_pointer == 42, "A's release was fetched");
+
+  /* A user which never lets go has the conch taken away, and B gets
+     it.  */
+  get_conch (USER_A);
+  page_a.xx_file_pointer = 7;
+  fetches = 0;
+  t = now ();
+  get_conch (USER_B);
+  t = now () - t;
+  check (t >= 4.5 && t < 10, "stuck holder loses the conch after 5 s");
+  check (status (&page_a) == USER_HAS_NOT_CONCH, "A's page says so");
+  check (fetches == 1, "A's page was fetched once");
+  check (conch.holder == USER_B && status (&page_b) == USER_HAS_CONCH,
+	 "B has the conch");
+  check (page_b.xx_file_pointer == 7, "B sees what A left");
+
+  /* A's late release must not take the conch from B.  */
+  pthread_mutex_lock (&lock);
+  iohelp_handle_io_release_conch (&conch, USER_A);
+  pthread_mutex_unlock (&lock);
+  check (conch.holder == USER_B && status (&page_b) == USER_HAS_CONCH,
+	 "late release by A leaves B alone");
+
+  if (failures)
+    error (1, 0, "%d checks failed", failures);
+  return 0;
+}
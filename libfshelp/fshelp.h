@@ -1,6 +1,6 @@
 /* FS helper library definitions
 
-   Copyright (C) 1994-2002, 2013-2019 Free Software Foundation, Inc.
+   Copyright (C) 1994-2002, 2013-2019, 2026 Free Software Foundation, Inc.
 
    This program is free software; you can redistribute it and/or
    modify it under the terms of the GNU General Public License as
@@ -122,6 +122,38 @@ fshelp_start_translator_long (fshelp_open_fn_t underlying_open_fn,
 			      int timeout, fsys_t *control);
 
 
+/* How long the phases of starting a translator took, in microseconds.
+   A phase that was not reached because of an error is zero.  */
+struct fshelp_start_times
+{
+  unsigned long lookup;		/* Looking up the executable.  */
+  unsigned long task;		/* Getting and setting up the task.  */
+  unsigned long exec;		/* file_exec.  */
+  unsigned long startup;	/* Waiting for fsys_startup.  */
+};
+
+/* Return in *TIMES how long the phases of the last translator start
+   done by the calling thread took.  */
+void fshelp_start_translator_times (struct fshelp_start_times *times);
+
+/* The sums of the phase times of all the translator starts that
+   succeeded, in microseconds, whichever thread did them and however they
+   were asked for.  */
+struct fshelp_start_totals
+{
+  unsigned long starts;		/* How many starts are summed up.  */
+  unsigned long long lookup, task, exec, startup;
+};
+
+/* Return in *TOTALS the sums of the phase times of all the translator
+   starts that succeeded so far.  */
+void fshelp_start_translator_totals (struct fshelp_start_totals *totals);
+
+/* Keep up to N empty tasks ready, so that fshelp_start_translator_long
+   does not have to create one.  The tasks are created in the
+   background, each time one is used.  N is zero initially.  */
+error_t fshelp_set_spare_tasks (int n);
+
 /* Same as fshelp_start_translator_long, except the initports and ints
    are copied from our own state, fd[2] is copied from our own stderr,
    and the other fds are cleared.  */
@@ -1,5 +1,5 @@
 /*
-   Copyright (C) 1995, 1996, 1999, 2000, 2002, 2004, 2010
+   Copyright (C) 1995, 1996, 1999, 2000, 2002, 2004, 2010, 2026
    Free Software Foundation, Inc.
    Written by Miles Bader and Michael I. Bushnell.
 
@@ -28,6 +28,8 @@
 #include <fcntl.h>
 #include <stdint.h>
 #include <string.h>
+#include <time.h>
+#include <pthread.h>
 #include <assert-backtrace.h>
 #include "fshelp.h"
 
@@ -190,6 +192,193 @@ service_fsys_startup (fshelp_open_fn_t underlying_open_fn, void *cookie,
 }
 
 
+/* Empty tasks made ahead of time by fshelp_set_spare_tasks, protected
+   by SPARE_TASKS_LOCK.  */
+static task_t *spare_tasks;
+static int nspare_tasks, spare_tasks_max;
+static int spare_tasks_refilling;
+static pthread_mutex_t spare_tasks_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/* Create a new task for a translator in *TASK.  */
+static error_t
+create_task (task_t *task)
+{
+  error_t err;
+
+  err = task_create (mach_task_self (),
+#ifdef KERN_INVALID_LEDGER
+		     NULL, 0,	/* OSF Mach */
+#endif
+		     0, task);
+  if (err)
+    return err;
+
+  /* XXX 25 is BASEPRI_USER, which isn't exported by the kernel.  Ideally,
+     nice values should be used, perhaps with a simple wrapper to convert
+     them to Mach priorities.  */
+  err = task_priority (*task, 25, FALSE);
+  if (err)
+    {
+      task_terminate (*task);
+      mach_port_deallocate (mach_task_self (), *task);
+      *task = MACH_PORT_NULL;
+    }
+  return err;
+}
+
+static void
+discard_task (task_t task)
+{
+  task_terminate (task);
+  mach_port_deallocate (mach_task_self (), task);
+}
+
+static void *
+refill_spare_tasks (void *arg)
+{
+  task_t task;
+  error_t err;
+
+  pthread_mutex_lock (&spare_tasks_lock);
+  while (nspare_tasks < spare_tasks_max)
+    {
+      pthread_mutex_unlock (&spare_tasks_lock);
+      err = create_task (&task);
+      pthread_mutex_lock (&spare_tasks_lock);
+      if (err)
+	break;
+
+      if (nspare_tasks < spare_tasks_max)
+	spare_tasks[nspare_tasks++] = task;
+      else
+	discard_task (task);
+    }
+  spare_tasks_refilling = 0;
+  pthread_mutex_unlock (&spare_tasks_lock);
+
+  return NULL;
+}
+
+/* Start a thread to bring the spare tasks up to SPARE_TASKS_MAX, unless
+   there is one already.  SPARE_TASKS_LOCK must be held.  */
+static void
+refill_spare_tasks_async (void)
+{
+  pthread_t thread;
+
+  if (spare_tasks_refilling || nspare_tasks >= spare_tasks_max)
+    return;
+
+  spare_tasks_refilling = 1;
+  if (pthread_create (&thread, NULL, refill_spare_tasks, NULL) == 0)
+    pthread_detach (thread);
+  else
+    spare_tasks_refilling = 0;
+}
+
+/* Return a task for a translator in *TASK, a spare one if we have one.  */
+static error_t
+get_task (task_t *task)
+{
+  pthread_mutex_lock (&spare_tasks_lock);
+  if (nspare_tasks > 0)
+    {
+      *task = spare_tasks[--nspare_tasks];
+      refill_spare_tasks_async ();
+      pthread_mutex_unlock (&spare_tasks_lock);
+      return 0;
+    }
+  refill_spare_tasks_async ();
+  pthread_mutex_unlock (&spare_tasks_lock);
+
+  return create_task (task);
+}
+
+error_t
+fshelp_set_spare_tasks (int n)
+{
+  task_t *new;
+
+  if (n < 0)
+    return EINVAL;
+
+  pthread_mutex_lock (&spare_tasks_lock);
+
+  while (nspare_tasks > n)
+    discard_task (spare_tasks[--nspare_tasks]);
+
+  if (n == 0)
+    {
+      free (spare_tasks);
+      spare_tasks = NULL;
+    }
+  else
+    {
+      new = realloc (spare_tasks, n * sizeof *new);
+      if (! new)
+	{
+	  pthread_mutex_unlock (&spare_tasks_lock);
+	  return ENOMEM;
+	}
+      spare_tasks = new;
+    }
+  spare_tasks_max = n;
+
+  refill_spare_tasks_async ();
+  pthread_mutex_unlock (&spare_tasks_lock);
+  return 0;
+}
+
+
+/* The phases of the last translator start of each thread.  */
+static __thread struct fshelp_start_times start_times;
+
+void
+fshelp_start_translator_times (struct fshelp_start_times *times)
+{
+  *times = start_times;
+}
+
+/* The sums of START_TIMES over all the starts that succeeded, protected
+   by START_TOTALS_LOCK.  */
+static struct fshelp_start_totals start_totals;
+static pthread_mutex_t start_totals_lock = PTHREAD_MUTEX_INITIALIZER;
+
+void
+fshelp_start_translator_totals (struct fshelp_start_totals *totals)
+{
+  pthread_mutex_lock (&start_totals_lock);
+  *totals = start_totals;
+  pthread_mutex_unlock (&start_totals_lock);
+}
+
+/* Add this thread's START_TIMES to START_TOTALS.  */
+static void
+add_start_times (void)
+{
+  pthread_mutex_lock (&start_totals_lock);
+  start_totals.starts++;
+  start_totals.lookup += start_times.lookup;
+  start_totals.task += start_times.task;
+  start_totals.exec += start_times.exec;
+  start_totals.startup += start_times.startup;
+  pthread_mutex_unlock (&start_totals_lock);
+}
+
+/* Return the time in microseconds since START, and set START to now.  */
+static unsigned long
+lap (struct timespec *start)
+{
+  struct timespec now;
+  unsigned long usecs;
+
+  clock_gettime (CLOCK_MONOTONIC, &now);
+  usecs = ((now.tv_sec - start->tv_sec) * 1000000
+	   + (now.tv_nsec - start->tv_nsec) / 1000);
+  *start = now;
+  return usecs;
+}
+
 error_t
 fshelp_start_translator_long (fshelp_open_fn_t underlying_open_fn,
                               void *cookie, char *name, char *argz,
@@ -211,6 +400,7 @@ fshelp_start_translator_long (fshelp_open_fn_t underlying_open_fn,
   mach_port_t task = MACH_PORT_NULL;
   mach_port_t prev_notify, proc, saveport;
   int deallocate_proc;
+  struct timespec t;
 
   /* While from our function signature it appears that we support passing
      incomplete port arrays of any type, this is what the implementation
@@ -219,11 +409,15 @@ fshelp_start_translator_long (fshelp_open_fn_t underlying_open_fn,
   assert_backtrace (ports_type == MACH_MSG_TYPE_COPY_SEND);
   assert_backtrace (fds_type == MACH_MSG_TYPE_COPY_SEND);
 
+  memset (&start_times, 0, sizeof start_times);
+  clock_gettime (CLOCK_MONOTONIC, &t);
+
   /* Find the translator itself.  Since argz has zero-separated elements, we
      can use it as a normal string representing the first element.  */
   executable = file_name_lookup (name, O_EXEC, 0);
   if (executable == MACH_PORT_NULL)
     return errno;
+  start_times.lookup = lap (&t);
 
   /* Create a bootstrap port for the translator.  */
   err = mach_port_allocate (mach_task_self (),
@@ -238,23 +432,11 @@ fshelp_start_translator_long (fshelp_open_fn_t underlying_open_fn,
   if (err)
     goto lose;
 
-  /* Create the task for the translator.  */
-  err = task_create (mach_task_self (),
-#ifdef KERN_INVALID_LEDGER
-		     NULL, 0,	/* OSF Mach */
-#endif
-		     0, &task);
+  /* Get the task for the translator.  */
+  err = get_task (&task);
   if (err)
     goto lose;
 
-  /* XXX 25 is BASEPRI_USER, which isn't exported by the kernel.  Ideally,
-     nice values should be used, perhaps with a simple wrapper to convert
-     them to Mach priorities.  */
-  err = task_priority (task, 25, FALSE);
-
-  if (err)
-    goto lose_task;
-
   /* Designate TASK as our child, fill in its proc port, and set its owner
      accordingly.  */
   if (ports[INIT_PORT_PROC] == MACH_PORT_NULL)
@@ -319,6 +501,8 @@ fshelp_start_translator_long (fshelp_open_fn_t underlying_open_fn,
       ports[INIT_PORT_PROC] = newport;
     }
 
+  start_times.task = lap (&t);
+
   saveport = ports[INIT_PORT_BOOTSTRAP];
   ports[INIT_PORT_BOOTSTRAP] = bootstrap;
 
@@ -340,6 +524,7 @@ fshelp_start_translator_long (fshelp_open_fn_t underlying_open_fn,
 
   mach_port_deallocate (mach_task_self (), bootstrap);
   ports[INIT_PORT_BOOTSTRAP] = saveport;
+  start_times.exec = lap (&t);
 
   if (err)
     goto lose_task;
@@ -363,6 +548,9 @@ fshelp_start_translator_long (fshelp_open_fn_t underlying_open_fn,
   err = service_fsys_startup (underlying_open_fn,
                               cookie, bootstrap,
                               timeout, control, task);
+  start_times.startup = lap (&t);
+  if (! err)
+    add_start_times ();
 
  lose_task:
   if (err)
@@ -1,5 +1,5 @@
 /* 
-   Copyright (C) 1999, 2007 Free Software Foundation, Inc.
+   Copyright (C) 1999, 2007, 2026 Free Software Foundation, Inc.
 
    Written by Thomas Bushnell, BSG.
 
@@ -27,23 +27,20 @@ void
 fshelp_touch (struct stat *st, unsigned what,
 	      volatile struct mapped_time_value *maptime)
 {
-  struct timeval tv;
+  struct timespec ts;
 
-  maptime_read (maptime, &tv);
+  maptime_read_timespec (maptime, &ts);
 
   if (what & TOUCH_ATIME)
     {
-      st->st_atim.tv_sec = tv.tv_sec;
-      st->st_atim.tv_nsec = tv.tv_usec * 1000;
+      st->st_atim = ts;
     }
   if (what & TOUCH_CTIME)
     {
-      st->st_ctim.tv_sec = tv.tv_sec;
-      st->st_ctim.tv_nsec = tv.tv_usec * 1000;
+      st->st_ctim = ts;
     }
   if (what & TOUCH_MTIME)
     {
-      st->st_mtim.tv_sec = tv.tv_sec;
-      st->st_mtim.tv_nsec = tv.tv_usec * 1000;
+      st->st_mtim = ts;
     }
 }
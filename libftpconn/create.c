@@ -1,6 +1,6 @@
 /* Create a new ftp connection
 
-   Copyright (C) 1997 Free Software Foundation, Inc.
+   Copyright (C) 1997, 2026 Free Software Foundation, Inc.
 
    Written by Miles Bader <miles@gnu.ai.mit.edu>
 
@@ -51,6 +51,8 @@ ftp_conn_create (const struct ftp_conn_params *params,
   new->hooks = hooks;
   new->syshooks_valid = 0;
   new->use_passive = 1;
+  new->has_mlsd = 0;
+  new->use_mlsd = 0;
   new->actv_data_addr = 0;
   new->cwd = 0;
   new->type = 0;
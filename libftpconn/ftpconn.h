@@ -1,6 +1,6 @@
 /* Manage an ftp connection
 
-   Copyright (C) 1997,2001,02 Free Software Foundation, Inc.
+   Copyright (C) 1997,2001,02,2026 Free Software Foundation, Inc.
 
    Written by Miles Bader <miles@gnu.org>
 
@@ -187,6 +187,10 @@ struct ftp_conn
 
   int use_passive : 1;		/* If true, first try passive data conns.  */
 
+  int has_mlsd : 1;		/* True if the server advertises MLST/MLSD. */
+  int use_mlsd : 1;		/* If true, list directories with MLSD when
+				   the server supports it.  */
+
   struct sockaddr *actv_data_addr;/* Address of port for active data conns.  */
 };
 
@@ -342,14 +346,17 @@ error_t ftp_conn_start_get_stats (struct ftp_conn *conn,
    is passed to ADD_STAT).  FD and STATE should be returned from
    start_get_stats.  If this function returns EAGAIN, then it should be
    called again to finish the job (possibly after calling select on FD); if
-   it returns 0, then it is finishe,d and FD and STATE are deallocated.  */
+   it returns 0, then it is finishe,d and FD and STATE are deallocated.  If
+   it returns ERESTART, FD and STATE are deallocated too, and the whole
+   operation should be started over.  */
 error_t ftp_conn_cont_get_stats (struct ftp_conn *conn, int fd, void *state,
 				 ftp_conn_add_stat_fun_t add_stat, void *hook);
 
 /* Get a list of file-stat structures for NAME, calling ADD_STAT for each one
    (HOOK is passed to ADD_STAT).  If CONTENTS is true, NAME must refer to a
    directory, and the contents will be returned, otherwise, the (single)
-   result will refer to NAME.  This function may block.  */
+   result will refer to NAME.  This function may block.  ADD_STAT may be
+   called more than once for the same name.  */
 error_t ftp_conn_get_stats (struct ftp_conn *conn,
 			    const char *name, int contents,
 			    ftp_conn_add_stat_fun_t add_stat, void *hook);
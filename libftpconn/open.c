@@ -1,6 +1,6 @@
 /* Connection initiation
 
-   Copyright (C) 1997, 1998, 1999 Free Software Foundation, Inc.
+   Copyright (C) 1997, 1998, 1999, 2026 Free Software Foundation, Inc.
 
    Written by Miles Bader <miles@gnu.ai.mit.edu>
 
@@ -165,6 +165,33 @@ ftp_conn_sysify (struct ftp_conn *conn)
   return err;
 }
 
+/* Asks the server which extensions it supports, and records the ones we
+   care about in CONN.  A server which doesn't understand FEAT just doesn't
+   get to use any of them.  */
+static error_t
+ftp_conn_feat (struct ftp_conn *conn)
+{
+  int reply;
+  const char *txt;
+  error_t err = ftp_conn_cmd (conn, "feat", 0, &reply, &txt);
+
+  conn->has_mlsd = 0;
+
+  if (!err && reply == REPLY_STATUS)
+    /* Each feature is on its own line of the reply, preceded by a space;
+       RFC 3659 says that MLSD comes with MLST.  */
+    while (txt && *txt)
+      {
+	while (isspace (*txt))
+	  txt++;
+	if (strncasecmp (txt, "MLST", 4) == 0 && !isalnum (txt[4]))
+	  conn->has_mlsd = 1;
+	txt = strchr (txt, '\n');
+      }
+
+  return err;
+}
+
 error_t
 ftp_conn_open (struct ftp_conn *conn)
 {
@@ -226,6 +253,10 @@ ftp_conn_open (struct ftp_conn *conn)
     /* Try again now. */
     err = ftp_conn_sysify (conn);
 
+  if (!err && conn->use_mlsd)
+    /* See if the server can give us machine-readable listings.  */
+    err = ftp_conn_feat (conn);
+
   if (!err && conn->type)
     /* Set the connection type.  */
     {
@@ -1,6 +1,6 @@
 /* libftpconn private definitions
 
-   Copyright (C) 1997 Free Software Foundation, Inc.
+   Copyright (C) 1997, 2026 Free Software Foundation, Inc.
 
    Written by Miles Bader <miles@gnu.ai.mit.edu>
 
@@ -33,6 +33,7 @@
 #define REPLY_DELAY	120	/* Service ready in nnn minutes */
 
 #define REPLY_OK	200	/* Command OK */
+#define REPLY_STATUS	211	/* System status, or system help reply */
 #define REPLY_SYSTYPE	215	/* NAME version */
 #define REPLY_HELLO	220	/* Service ready for new user */
 #define REPLY_ABORT_OK	225	/* ABOR command successful */
@@ -1,6 +1,6 @@
 /* Fetch file stats
 
-   Copyright (C) 1997 Free Software Foundation, Inc.
+   Copyright (C) 1997, 2026 Free Software Foundation, Inc.
 
    Written by Miles Bader <miles@gnu.ai.mit.edu>
 
@@ -67,14 +67,22 @@ ftp_conn_get_stats (struct ftp_conn *conn,
 {
   int fd;
   void *state;
-  error_t err = ftp_conn_start_get_stats (conn, name, contents, &fd, &state);
-
-  if (err)
-    return err;
+  error_t err;
 
   do
-    err = ftp_conn_cont_get_stats (conn, fd, state, add_stat, hook);
-  while (err == EAGAIN);
+    {
+      err = ftp_conn_start_get_stats (conn, name, contents, &fd, &state);
+      if (err)
+	return err;
+
+      do
+	err = ftp_conn_cont_get_stats (conn, fd, state, add_stat, hook);
+      while (err == EAGAIN);
+    }
+  /* The syshooks found out part way through that they can't do the job the
+     way they started it, and have arranged to do it differently next time;
+     entries already passed to ADD_STAT will be passed to it again.  */
+  while (err == ERESTART);
 
   return err;
 }
@@ -1,6 +1,6 @@
 /* Unix-specific ftpconn hooks
 
-   Copyright (C) 1997, 1998, 2002 Free Software Foundation, Inc.
+   Copyright (C) 1997, 1998, 2002, 2026 Free Software Foundation, Inc.
    Written by Miles Bader <miles@gnu.org>
 
    This program is free software; you can redistribute it and/or
@@ -32,6 +32,7 @@
 #endif
 
 #include <ftpconn.h>
+#include "priv.h"
 
 /* Uid/gid to use when we don't know about a particular user name.  */
 #define DEFAULT_UID 65535
@@ -150,6 +151,9 @@ struct get_stats_state
 
   int added_slash;		/* Did we prefix the name with `./'?  */
 
+  int mlsd;			/* Is this MLSD output rather than ls's?  */
+  char *symlink_target;		/* Target of the last read MLSD symlink.  */
+
   struct stat stat;		/* Last read stat info.  */
 
   int start;			/* True if at beginning of output.  */
@@ -204,6 +208,21 @@ ftp_conn_unix_start_get_stats (struct ftp_conn *conn,
 	goto out;
     }
 
+  if (conn->use_mlsd && conn->has_mlsd)
+    /* MLSD (RFC 3659) takes a plain pathname and gives back exact
+       attributes, so none of the ls guesswork below is needed.  Like
+       above, look in the parent directory if we're not after its
+       contents.  */
+    {
+      req = strdup (contents ? name : dirname (strdupa (name)));
+      if (! req)
+	err = ENOMEM;
+      else
+	err = ftp_conn_start_transfer (conn, "mlsd", req,
+				       ftp_conn_poss_file_errs, fd);
+      goto out;
+    }
+
   if (strcspn (name, "*? \t\n{}$`\\\"'") < strlen (name))
     /* NAME contains some metacharacters, which makes the behavior of various
        ftp servers unpredictable, so punt.  */
@@ -263,6 +282,8 @@ ftp_conn_unix_start_get_stats (struct ftp_conn *conn,
       s->contents = contents;
       s->searched_name = searched_name;
       s->added_slash = !slash;
+      s->mlsd = conn->use_mlsd && conn->has_mlsd;
+      s->symlink_target = 0;
       s->name = 0;
       s->name_len = s->name_alloced = 0;
       s->name_partial = 0;
@@ -522,6 +543,194 @@ drwxrwxrwt   7 34       archive       512 May  1 14:28 /tmp
   return 0;
 }
 
+/* Translate the facts of the MLSD entry in *LINE, which ends at END, into
+   STAT, and update *LINE to point to the filename following them.  If the
+   entry is a symlink and the server said where it points, a malloced copy
+   of the target is returned in *SYMLINK_TARGET, otherwise that is set to 0.
+   If *LINE should be ignored, EAGAIN is returned.  */
+static error_t
+parse_mlsx_entry (char **line, const char *end, struct stat *stat,
+		  char **symlink_target)
+{
+  char *p = *line, *e;
+  const char *perm = 0;
+  size_t perm_len = 0;
+  int have_mode = 0;
+  struct tm tm;
+
+  /*
+type=file;size=4711;modify=20020405123456;unix.mode=0644; README
+type=dir;modify=20020405123456;perm=flcdmpe; pub
+type=OS.unix=slink:/etc/motd;unix.mode=0777; motd
+  */
+
+  *symlink_target = 0;
+
+  memset (stat, 0, sizeof *stat);
+
+#ifdef FSTYPE_FTP
+  stat->st_fstype = FSTYPE_FTP;
+#endif
+
+  stat->st_nlink = 1;
+  stat->st_uid = DEFAULT_UID;
+  stat->st_gid = DEFAULT_GID;
+
+  /* Each fact is `NAME=VALUE;', and a single space separates the last one
+     from the filename.  */
+  while (p < end && *p != ' ')
+    {
+      char *fact = p, *val;
+      size_t fact_len, val_len;
+
+      while (p < end && *p != '=' && *p != ';' && *p != ' ')
+	p++;
+      if (p == end || *p != '=')
+	return EGRATUITOUS;
+      fact_len = p - fact;
+
+      val = ++p;
+      while (p < end && *p != ';')
+	p++;
+      if (p == end)
+	return EGRATUITOUS;
+      val_len = p++ - val;
+
+#define FACT_IS(str) \
+  (fact_len == sizeof str - 1 && strncasecmp (fact, str, fact_len) == 0)
+#define VAL_HAS_PREFIX(str) \
+  (val_len >= sizeof str - 1 && strncasecmp (val, str, sizeof str - 1) == 0)
+#define VAL_IS(str) (val_len == sizeof str - 1 && VAL_HAS_PREFIX (str))
+#define PARSE_NUM(base) ({						      \
+    unsigned long long u = strtoull (val, &e, base);			      \
+    if (e == val || e != val + val_len)					      \
+      return EGRATUITOUS;						      \
+    u;									      \
+  })
+
+      if (FACT_IS ("type"))
+	{
+	  stat->st_mode &= ~S_IFMT;
+	  if (VAL_IS ("cdir") || VAL_IS ("pdir"))
+	    /* `.' and `..', which ls -A wouldn't have shown either.  */
+	    return EAGAIN;
+	  else if (VAL_IS ("dir"))
+	    stat->st_mode |= S_IFDIR;
+	  else if (VAL_HAS_PREFIX ("OS.unix=slink")
+		   || VAL_HAS_PREFIX ("OS.unix=symlink"))
+	    {
+	      char *colon = memchr (val, ':', val_len);
+
+	      stat->st_mode |= S_IFLNK;
+	      if (colon)
+		{
+		  *symlink_target = strndup (colon + 1, val + val_len - colon - 1);
+		  if (! *symlink_target)
+		    return ENOMEM;
+		}
+	    }
+	  else if (VAL_HAS_PREFIX ("OS.unix=chr"))
+	    stat->st_mode |= S_IFCHR;
+	  else if (VAL_HAS_PREFIX ("OS.unix=blk"))
+	    stat->st_mode |= S_IFBLK;
+	  else
+	    /* `file', or some OS-specific type we don't know about.  */
+	    stat->st_mode |= S_IFREG;
+	}
+      else if (FACT_IS ("size"))
+	stat->st_size = PARSE_NUM (10);
+      else if (FACT_IS ("modify"))
+	/* YYYYMMDDHHMMSS[.sss], always in GMT.  */
+	{
+	  memset (&tm, 0, sizeof tm);
+	  if (val_len < 14
+	      || sscanf (val, "%4d%2d%2d%2d%2d%2d", &tm.tm_year, &tm.tm_mon,
+			 &tm.tm_mday, &tm.tm_hour, &tm.tm_min, &tm.tm_sec) != 6)
+	    return EGRATUITOUS;
+	  tm.tm_year -= 1900;
+	  tm.tm_mon--;
+	  stat->st_mtim.tv_sec = timegm (&tm);
+	  if (stat->st_mtim.tv_sec == (time_t)-1)
+	    return EGRATUITOUS;
+	}
+      else if (FACT_IS ("unix.mode"))
+	{
+	  stat->st_mode |= PARSE_NUM (8) & 07777;
+	  have_mode = 1;
+	}
+      else if (FACT_IS ("unix.uid")
+	       || (FACT_IS ("unix.owner") && isdigit (*val)))
+	stat->st_uid = PARSE_NUM (10);
+      else if (FACT_IS ("unix.gid")
+	       || (FACT_IS ("unix.group") && isdigit (*val)))
+	stat->st_gid = PARSE_NUM (10);
+      else if (FACT_IS ("unix.owner"))
+	{
+	  struct passwd *pw = getpwnam (strndupa (val, val_len));
+	  stat->st_uid = pw ? pw->pw_uid : DEFAULT_UID;
+	}
+      else if (FACT_IS ("unix.group"))
+	{
+	  struct group *gr = getgrnam (strndupa (val, val_len));
+	  stat->st_gid = gr ? gr->gr_gid : DEFAULT_GID;
+	}
+      else if (FACT_IS ("perm"))
+	{
+	  perm = val;
+	  perm_len = val_len;
+	}
+      /* Anything else (unique, lang, ...) is of no use to us.  */
+    }
+
+  if (p == end)
+    /* No filename.  */
+    {
+      free (*symlink_target);
+      *symlink_target = 0;
+      return EGRATUITOUS;
+    }
+
+  if (! (stat->st_mode & S_IFMT))
+    stat->st_mode |= S_IFREG;
+
+  if (S_ISLNK (stat->st_mode))
+    /* Like ls, the size of a symlink is the length of its target.  */
+    stat->st_size = *symlink_target ? strlen (*symlink_target) : 0;
+
+  if (! have_mode)
+    /* Without unix.mode, all we know is what the logged in user may do
+       (according to PERM), which is what everyone gets.  */
+    {
+      if (! perm)
+	stat->st_mode |= S_ISDIR (stat->st_mode) ? 0755 : 0644;
+      else
+	{
+	  if (memchr (perm, 'r', perm_len) || memchr (perm, 'l', perm_len))
+	    stat->st_mode |= S_IRUSR | S_IRGRP | S_IROTH;
+	  if (memchr (perm, 'w', perm_len) || memchr (perm, 'a', perm_len)
+	      || memchr (perm, 'c', perm_len) || memchr (perm, 'm', perm_len))
+	    stat->st_mode |= S_IWUSR;
+	  if (S_ISDIR (stat->st_mode) && memchr (perm, 'e', perm_len))
+	    stat->st_mode |= S_IXUSR | S_IXGRP | S_IXOTH;
+	}
+    }
+
+#ifdef HAVE_STAT_ST_AUTHOR
+  stat->st_author = stat->st_uid;
+#endif
+
+  stat->st_blocks = stat->st_size >> 9;
+
+  /* atime and ctime are the same as mtime.  */
+  stat->st_atim.tv_sec  = stat->st_ctim.tv_sec  = stat->st_mtim.tv_sec;
+  stat->st_atim.tv_nsec = stat->st_ctim.tv_nsec = stat->st_mtim.tv_nsec = 0;
+
+  /* Update *LINE to point to the filename.  */
+  *line = p + 1;
+
+  return 0;
+}
+
 /* Read stats information from FD, calling ADD_STAT for each new stat (HOOK
    is passed to ADD_STAT).  FD and STATE should be returned from
    start_get_stats.  If this function returns EAGAIN, then it should be
@@ -595,12 +804,26 @@ ftp_conn_unix_cont_get_stats (struct ftp_conn *conn, int fd, void *state,
 	{
 	  /* Parse the directory entry info, updating P to point to the
 	     beginning of the name.  */
-	  err = parse_dir_entry (&p, &s->stat);
+	  if (s->mlsd)
+	    err = parse_mlsx_entry (&p, nl ?: s->buf + s->buf_len, &s->stat,
+				    &s->symlink_target);
+	  else
+	    err = parse_dir_entry (&p, &s->stat);
 	  if (err == EAGAIN)
 	    /* This line isn't a real entry and should be ignored.  */
 	    goto skip_line;
 	  if (err)
 	    goto finished;
+
+	  if (s->mlsd && S_ISLNK (s->stat.st_mode) && !s->symlink_target)
+	    /* The server doesn't tell us where its symlinks point, which only
+	       ls output will; don't use MLSD on this connection anymore, and
+	       have our caller start over.  */
+	    {
+	      conn->use_mlsd = 0;
+	      err = ERESTART;
+	      goto finished;
+	    }
 	}
 
       /* Now fill in S->last_stat's name field, possibly extending it from a
@@ -631,9 +854,9 @@ ftp_conn_unix_cont_get_stats (struct ftp_conn *conn, int fd, void *state,
       if (nl)
 	{
 	  char *name = s->name;
-	  char *symlink_target = 0;
+	  char *symlink_target = s->symlink_target;
 
-	  if (S_ISLNK (s->stat.st_mode))
+	  if (S_ISLNK (s->stat.st_mode) && !s->mlsd)
 	    /* A symlink, see if we can find the link target.  */
 	    {
 	      symlink_target = strstr (name, " -> ");
@@ -644,7 +867,7 @@ ftp_conn_unix_cont_get_stats (struct ftp_conn *conn, int fd, void *state,
 		}
 	    }
 
-	  if (strchr (name, '/'))
+	  if (!s->mlsd && strchr (name, '/'))
 	    {
 	      if (s->contents)
 		/* We know that the name originally request had a slash in
@@ -677,6 +900,9 @@ ftp_conn_unix_cont_get_stats (struct ftp_conn *conn, int fd, void *state,
 		goto finished;
 	    }
 
+	  free (s->symlink_target);
+	  s->symlink_target = 0;
+
 	  s->name_len = 0;
 	  s->name_partial = 0;
 
@@ -715,6 +941,7 @@ finished:
     free (s->name);
   if (s->searched_name)
     free (s->searched_name);
+  free (s->symlink_target);
   free (s);
   close (fd);
 
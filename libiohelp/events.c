@@ -0,0 +1,95 @@
+/* Readiness events for io_event_register
+   Copyright (C) 2026 Free Software Foundation, Inc.
+
+   This file is part of the GNU Hurd.
+
+   The GNU Hurd is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation; either version 2, or (at
+   your option) any later version.
+
+   The GNU Hurd is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with the GNU Hurd.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include <stdlib.h>
+#include <errno.h>
+
+#include "iohelp.h"
+#include "io_event_notify_U.h"
+
+void
+iohelp_post_event (mach_port_t port, vm_address_t cookie, int ready)
+{
+  error_t err = io_event_ready (port, cookie, ready);
+  if (err == MACH_SEND_INVALID_DEST || err == MACH_SEND_TIMED_OUT)
+    /* The message was not sent, so the right is still ours.  */
+    mach_port_deallocate (mach_task_self (), port);
+}
+
+/* Send the event for E, reporting READY, and free E.  */
+static void
+post (struct iohelp_event *e, int ready)
+{
+  iohelp_post_event (e->port, e->cookie, ready);
+  free (e);
+}
+
+error_t
+iohelp_register_event (struct iohelp_event **events,
+		       mach_port_t port, vm_address_t cookie,
+		       int select_type, int ready)
+{
+  struct iohelp_event *e;
+
+  if (! MACH_PORT_VALID (port) || select_type == 0)
+    return EINVAL;
+
+  if (select_type & ready)
+    {
+      iohelp_post_event (port, cookie, select_type & ready);
+      return 0;
+    }
+
+  e = malloc (sizeof *e);
+  if (! e)
+    return ENOMEM;
+
+  e->port = port;
+  e->cookie = cookie;
+  e->select_type = select_type;
+  e->next = *events;
+  *events = e;
+  return 0;
+}
+
+void
+iohelp_post_events (struct iohelp_event **events, int ready)
+{
+  struct iohelp_event **ep = events, *e;
+
+  while ((e = *ep))
+    if (e->select_type & ready)
+      {
+	*ep = e->next;
+	post (e, e->select_type & ready);
+      }
+    else
+      ep = &e->next;
+}
+
+void
+iohelp_cancel_events (struct iohelp_event **events)
+{
+  struct iohelp_event *e;
+
+  while ((e = *events))
+    {
+      *events = e->next;
+      post (e, 0);
+    }
+}
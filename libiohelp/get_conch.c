@@ -1,5 +1,5 @@
 /* 
-   Copyright (C) 1993, 1994, 1996 Free Software Foundation
+   Copyright (C) 1993, 1994, 1996, 2026 Free Software Foundation
 
    This program is free software; you can redistribute it and/or
    modify it under the terms of the GNU General Public License as
@@ -16,6 +16,12 @@
    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA. */
 
 #include "iohelp.h"
+#include <errno.h>
+#include <time.h>
+
+/* How many seconds a user asked to release the conch may keep it before
+   we take it away.  */
+#define CONCH_RELEASE_TIMEOUT 5
 
 /* The conch must be locked when calling this routine. */
 /* Remove any current holder of conch C. */
@@ -23,6 +29,7 @@ void
 iohelp_get_conch (struct conch *c)
 {
   struct shared_io *user_sh;
+  struct timespec deadline = { 0, 0 };
   
  again:
   user_sh = c->holder_shared_page;
@@ -37,7 +44,23 @@ iohelp_get_conch (struct conch *c)
 	  /* fall through ... */
 	case USER_RELEASE_CONCH:
 	  pthread_spin_unlock (&user_sh->lock);
-	  pthread_cond_wait (&c->wait, c->lock);
+	  if (deadline.tv_sec == 0)
+	    {
+	      clock_gettime (CLOCK_REALTIME, &deadline);
+	      deadline.tv_sec += CONCH_RELEASE_TIMEOUT;
+	    }
+	  if (pthread_cond_timedwait (&c->wait, c->lock, &deadline)
+	      == ETIMEDOUT
+	      && c->holder_shared_page == user_sh)
+	    {
+	      /* The user has not let go; take the conch anyway, with
+		 whatever the shared page says now.  */
+	      pthread_spin_lock (&user_sh->lock);
+	      user_sh->conch_status = USER_HAS_NOT_CONCH;
+	      pthread_spin_unlock (&user_sh->lock);
+	      iohelp_fetch_shared_data (c->holder);
+	      break;
+	    }
 	  /* Anything can have happened */
 	  goto again;
 	  
@@ -1,5 +1,5 @@
 /* 
-   Copyright (C) 1993, 1994, 1996 Free Software Foundation
+   Copyright (C) 1993, 1994, 1996, 2026 Free Software Foundation
 
    This program is free software; you can redistribute it and/or
    modify it under the terms of the GNU General Public License as
@@ -25,19 +25,22 @@ iohelp_handle_io_release_conch (struct conch *c, void *user)
 {
   struct shared_io *user_sh = c->holder_shared_page;
 
+  if (c->holder != user)
+    /* Someone else has it, or nobody; leave it alone.  */
+    return;
+
   pthread_spin_lock (&user_sh->lock);
-  if (c->holder_shared_page->conch_status != USER_HAS_NOT_CONCH)
+  if (user_sh->conch_status != USER_HAS_NOT_CONCH)
     {
-      c->holder_shared_page->conch_status = USER_HAS_NOT_CONCH;
-      iohelp_fetch_shared_data (c->holder);
+      user_sh->conch_status = USER_HAS_NOT_CONCH;
+      pthread_spin_unlock (&user_sh->lock);
+      iohelp_fetch_shared_data (user);
     }
-  pthread_spin_unlock (&user_sh->lock);
+  else
+    pthread_spin_unlock (&user_sh->lock);
 
-  if (c->holder == user)
-    {
-      c->holder = 0;
-      c->holder_shared_page = 0;
-    }
+  c->holder = 0;
+  c->holder_shared_page = 0;
 
   pthread_cond_broadcast (&c->wait);
 }
@@ -1,5 +1,5 @@
 /* Library providing helper functions for io servers.
-   Copyright (C) 1993,94,96,98,2001,02 Free Software Foundation, Inc.
+   Copyright (C) 1993,94,96,98,2001,02,26 Free Software Foundation, Inc.
 
    This program is free software; you can redistribute it and/or
    modify it under the terms of the GNU General Public License as
@@ -43,10 +43,13 @@ void iohelp_initialize_conch (struct conch *, pthread_mutex_t *);
 void iohelp_handle_io_get_conch (struct conch *, void *,
 				      struct shared_io *);
 
-/* Obtain the conch for the server */
+/* Obtain the conch for the server.  A user asked to release it who
+   does not do so within a few seconds has it taken away.  */
 void iohelp_get_conch (struct conch *);
 
-/* Handle a user request to release the conch (io_release_conch). */
+/* Handle a user request to release the conch (io_release_conch).  This
+   does nothing if the user does not hold the conch.  The server should
+   also call it when the user goes away.  */
 void iohelp_handle_io_release_conch (struct conch *, void *);
 
 /* Check if the user is allowed to make a shared-data notification
@@ -64,6 +67,49 @@ void iohelp_fetch_shared_data (void *);
 void iohelp_put_shared_data (void *);
 
 
+
+/* Readiness events (io_event_register) */
+
+/* An outstanding io_event_register registration.  */
+struct iohelp_event
+{
+  struct iohelp_event *next;
+  mach_port_t port;		/* Send-once right to post the event to.  */
+  vm_address_t cookie;
+  int select_type;		/* What the client is waiting for.  */
+};
+
+/* These routines do no locking; the server must serialize all calls on
+   one list with the lock protecting the state that decides readiness,
+   so that no change can slip in between computing READY and recording a
+   registration.  */
+
+/* Send the event READY for COOKIE to PORT, a send-once right given to
+   io_event_register, consuming PORT.  */
+void iohelp_post_event (mach_port_t port, vm_address_t cookie, int ready);
+
+/* Handle io_event_register on an object with the registrations in
+   *EVENTS, which currently is ready for the kinds of i/o in READY.  PORT,
+   COOKIE and SELECT_TYPE are as passed to io_event_register; PORT is
+   consumed unless an error is returned.  If SELECT_TYPE is satisfied
+   right now, the event is posted at once; otherwise the registration is
+   recorded in *EVENTS until a later call to iohelp_post_events satisfies
+   it.  */
+error_t iohelp_register_event (struct iohelp_event **events,
+			       mach_port_t port, vm_address_t cookie,
+			       int select_type, int ready);
+
+/* Tell all the clients in *EVENTS which are waiting for any of the kinds
+   of i/o in READY that they can go ahead, and forget them.  This is cheap
+   when *EVENTS is empty, so it can be called on every change.  */
+void iohelp_post_events (struct iohelp_event **events, int ready);
+
+/* Send an empty event to all registrations in *EVENTS and forget them,
+   as when the object they are on goes away.  */
+void iohelp_cancel_events (struct iohelp_event **events);
+
+
+
 
 /* User identification */
 
@@ -1,5 +1,5 @@
 /* 
-   Copyright (C) 1995, 1996, 1999 Free Software Foundation, Inc.
+   Copyright (C) 1995, 1996, 1999, 2026 Free Software Foundation, Inc.
    Written by Michael I. Bushnell, p/BSG.
 
    This file is part of the GNU Hurd.
@@ -53,19 +53,19 @@ netfs_S_file_utimens (struct protid *user,
 		     struct timespec mtimein)
 {
   error_t err;
-  struct timeval t;
+  struct timespec t;
 
   if (!user)
     return EOPNOTSUPP;
 
   if (atimein.tv_nsec == UTIME_NOW || mtimein.tv_nsec == UTIME_NOW)
     {
-      maptime_read (netfs_mtime, &t);
+      maptime_read_timespec (netfs_mtime, &t);
 
       if (atimein.tv_nsec == UTIME_NOW)
-        TIMEVAL_TO_TIMESPEC (&t, &atimein);
+        atimein = t;
       if (mtimein.tv_nsec == UTIME_NOW)
-        TIMEVAL_TO_TIMESPEC (&t, &mtimein);
+        mtimein = t;
     }
 
   pthread_mutex_lock (&user->po->np->lock);
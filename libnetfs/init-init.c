@@ -1,5 +1,5 @@
 /* 
-   Copyright (C) 1995, 1996 Free Software Foundation, Inc.
+   Copyright (C) 1995, 1996, 2026 Free Software Foundation, Inc.
    Written by Michael I. Bushnell, p/BSG.
 
    This file is part of the GNU Hurd.
@@ -38,9 +38,7 @@ void
 netfs_init (void)
 {
   error_t err;
-  err = maptime_map (0, 0, &netfs_mtime);
-  if (err)
-    err = maptime_map (1, 0, &netfs_mtime);
+  err = maptime_map_any (&netfs_mtime);
   if (err)
     error (2, err, "mapping time");
 
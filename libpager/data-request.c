@@ -67,8 +67,8 @@ _pager_S_memory_object_data_request (struct pager *p,
       goto allow_release_out;
     }
 
-  err = _pager_pagemap_resize (p, offset + length);
-  if (err)
+  pm_entry = _pager_pagemap_get (p, offset / __vm_page_size, 1);
+  if (!pm_entry)
     goto allow_release_out;	/* Can't do much about the actual error.  */
 
   /* If someone is paging this out right now, the disk contents are
@@ -76,7 +76,6 @@ _pager_S_memory_object_data_request (struct pager *p,
      find the data and return it, and then interrupt the write, so we just
      mark the page and have the writing thread do m_o_data_supply when it
      gets around to it.  */
-  pm_entry = &p->pagemap[offset / __vm_page_size];
   if (*pm_entry & PM_PAGINGOUT)
     {
       doread = 0;
@@ -35,7 +35,8 @@ _pager_do_write_request (struct pager *p,
 			 int kcopy,
 			 int initializing)
 {
-  short *pm_entries;
+  short **pm_entries;
+  short *scratch;
   int npages, i;
   char *notified;
   error_t *pagerrs;
@@ -86,9 +87,21 @@ _pager_do_write_request (struct pager *p,
   _pager_block_termination (p);	/* until we are done with the pagemap
 				   when the write completes. */
 
-  _pager_pagemap_resize (p, offset + length);
-
-  pm_entries = &p->pagemap[offset / __vm_page_size];
+  /* Leaves of the pagemap are not freed until the pager terminates, so
+     these pointers remain valid across the unlock below.  If we can't
+     allocate an entry, track that page's state in a scratch slot; it
+     is forgotten afterwards, just as if the page had never been seen.  */
+  pm_entries = alloca (npages * sizeof *pm_entries);
+  scratch = alloca (npages * sizeof *scratch);
+  for (i = 0; i < npages; i++)
+    {
+      pm_entries[i] = _pager_pagemap_get (p, offset / __vm_page_size + i, 1);
+      if (! pm_entries[i])
+	{
+	  scratch[i] = 0;
+	  pm_entries[i] = &scratch[i];
+	}
+    }
 
   if (! dirty)
     {
@@ -97,7 +110,7 @@ _pager_do_write_request (struct pager *p,
         /* Prepare notified array.  */
         for (i = 0; i < npages; i++)
           notified[i] = (p->notify_on_evict
-                         && ! (pm_entries[i] & PM_PAGEINWAIT));
+                         && ! (*pm_entries[i] & PM_PAGEINWAIT));
 
         goto notify;
       }
@@ -115,9 +128,9 @@ _pager_do_write_request (struct pager *p,
   /* XXX: Is this still needed?  */
  retry:
   for (i = 0; i < npages; i++)
-    if (pm_entries[i] & PM_PAGINGOUT)
+    if (*pm_entries[i] & PM_PAGINGOUT)
       {
-	pm_entries[i] |= PM_WRITEWAIT;
+	*pm_entries[i] |= PM_WRITEWAIT;
 	pthread_cond_wait (&p->wakeup, &p->interlock);
 	goto retry;
       }
@@ -128,15 +141,15 @@ _pager_do_write_request (struct pager *p,
       assert_backtrace (npages < 32);
       for (i = 0; i < npages; i++)
 	{
-	  if (pm_entries[i] & PM_INIT)
+	  if (*pm_entries[i] & PM_INIT)
 	    omitdata |= 1U << i;
 	  else
-	    pm_entries[i] |= PM_PAGINGOUT | PM_INIT;
+	    *pm_entries[i] |= PM_PAGINGOUT | PM_INIT;
 	}
     }
   else
     for (i = 0; i < npages; i++)
-      pm_entries[i] |= PM_PAGINGOUT | PM_INIT;
+      *pm_entries[i] |= PM_PAGINGOUT | PM_INIT;
 
   /* If this write occurs while a lock is pending, record
      it.  We have to keep this list because a lock request
@@ -169,8 +182,6 @@ _pager_do_write_request (struct pager *p,
 
   /* Acquire the right to meddle with the pagemap */
   pthread_mutex_lock (&p->interlock);
-  _pager_pagemap_resize (p, offset + length);
-  pm_entries = &p->pagemap[offset / __vm_page_size];
 
   wakeup = 0;
   for (i = 0; i < npages; i++)
@@ -181,10 +192,10 @@ _pager_do_write_request (struct pager *p,
 	  continue;
 	}
 
-      if (pm_entries[i] & PM_WRITEWAIT)
+      if (*pm_entries[i] & PM_WRITEWAIT)
 	wakeup = 1;
 
-      if (pagerrs[i] && ! (pm_entries[i] & PM_PAGEINWAIT))
+      if (pagerrs[i] && ! (*pm_entries[i] & PM_PAGEINWAIT))
 	/* The only thing we can do here is mark the page, and give
 	   errors from now on when it is to be read.  This is
 	   imperfect, because if all users go away, the pagemap will
@@ -192,9 +203,9 @@ _pager_do_write_request (struct pager *p,
 	   better than Un*x.  Of course, if we are about to hand this
 	   data to the kernel, the error isn't a problem, hence the
 	   check for pageinwait.  */
-	pm_entries[i] |= PM_INVALID;
+	*pm_entries[i] |= PM_INVALID;
 
-      if (pm_entries[i] & PM_PAGEINWAIT)
+      if (*pm_entries[i] & PM_PAGEINWAIT)
 	{
 	  memory_object_data_supply (p->memobjcntl,
 				     offset + (vm_page_size * i),
@@ -209,10 +220,10 @@ _pager_do_write_request (struct pager *p,
 		  vm_page_size);
 	  notified[i] = (! kcopy && p->notify_on_evict);
 	  if (! kcopy)
-	    pm_entries[i] &= ~PM_INCORE;
+	    *pm_entries[i] &= ~PM_INCORE;
 	}
 
-      pm_entries[i] &= ~(PM_PAGINGOUT | PM_PAGEINWAIT | PM_WRITEWAIT);
+      *pm_entries[i] &= ~(PM_PAGINGOUT | PM_PAGEINWAIT | PM_WRITEWAIT);
     }
 
   for (ll = lock_list; ll; ll = ll->next)
@@ -231,16 +242,19 @@ _pager_do_write_request (struct pager *p,
       assert_backtrace (notified[i] == 0 || notified[i] == 1);
       if (notified[i])
 	{
-	  short *pm_entry = &pm_entries[i];
+	  short *pm_entry;
 
 	  /* Do notify user.  */
 	  pager_notify_evict (p->upi, offset + (i * vm_page_size));
 
 	  /* Clear any error that is left.  Notification on eviction
 	     is used only to change association of page, so any
-	     error may no longer be valid.  */
+	     error may no longer be valid.  The pager may have been
+	     terminated meanwhile, so look the entry up again.  */
 	  pthread_mutex_lock (&p->interlock);
-	  *pm_entry = SET_PM_ERROR (SET_PM_NEXTERROR (*pm_entry, 0), 0);
+	  pm_entry = _pager_pagemap_get (p, offset / __vm_page_size + i, 0);
+	  if (pm_entry)
+	    *pm_entry = SET_PM_ERROR (SET_PM_NEXTERROR (*pm_entry, 0), 0);
 	  pthread_mutex_unlock (&p->interlock);
 	}
     }
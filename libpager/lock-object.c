@@ -30,7 +30,6 @@ _pager_lock_object (struct pager *p,
 		    vm_prot_t lock_value,
 		    int sync)
 {
-  vm_size_t i;
   struct lock_request *lr = 0;
 
   pthread_mutex_lock (&p->interlock);
@@ -86,20 +85,13 @@ _pager_lock_object (struct pager *p,
 
       if (should_flush)
 	{
-	  vm_offset_t pm_offs = offset / __vm_page_size;
+	  vm_offset_t page = offset / __vm_page_size;
+	  vm_offset_t end = page + size / __vm_page_size;
+	  short *pm_entry;
 
-	  _pager_pagemap_resize (p, offset + size);
-	  if (p->pagemapsize > pm_offs)
-	    {
-	      short *pm_entries = &p->pagemap[pm_offs];
-	      vm_size_t bound = size / vm_page_size;
-
-	      if (bound > p->pagemapsize)
-		bound = p->pagemapsize;
-
-	      for (i = 0; i < bound; i++)
-		pm_entries[i] &= ~PM_INCORE;
-	    }
+	  /* Pages with no pagemap entry are not in core anyway.  */
+	  for (; (pm_entry = _pager_pagemap_next (p, &page, end)); page++)
+	    *pm_entry &= ~PM_INCORE;
 	}
     }
 
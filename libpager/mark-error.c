@@ -33,9 +33,11 @@ _pager_mark_next_request_error(struct pager *pager,
 {
   int page_error;
   short *p;
+  vm_offset_t page, end;
 
   offset /= __vm_page_size;
   length /= __vm_page_size;
+  end = offset + length;
   
   switch (error)
     {
@@ -54,8 +56,18 @@ _pager_mark_next_request_error(struct pager *pager,
       break;
     }
   
-  for (p = pager->pagemap + offset; p < pager->pagemap + offset + length; p++)
-    *p = SET_PM_NEXTERROR (*p, page_error);
+  /* A missing entry means no error, so only allocate entries to
+     record an actual error.  */
+  if (page_error == PAGE_NOERR)
+    for (page = offset; (p = _pager_pagemap_next (pager, &page, end)); page++)
+      *p = SET_PM_NEXTERROR (*p, page_error);
+  else
+    for (page = offset; page < end; page++)
+      {
+	p = _pager_pagemap_get (pager, page, 1);
+	if (p)
+	  *p = SET_PM_NEXTERROR (*p, page_error);
+      }
 }
 
 /* We are returning a pager error to the kernel.  Write down
@@ -71,9 +83,11 @@ _pager_mark_object_error(struct pager *pager,
 {
   int page_error = 0;
   short *p;
+  vm_offset_t page, end;
 
   offset /= __vm_page_size;
   length /= __vm_page_size;
+  end = offset + length;
   
   switch (error)
     {
@@ -92,8 +106,18 @@ _pager_mark_object_error(struct pager *pager,
       break;
     }
   
-  for (p = pager->pagemap + offset; p < pager->pagemap + offset + length; p++)
-    *p = SET_PM_ERROR (*p, page_error);
+  /* A missing entry means no error, so only allocate entries to
+     record an actual error.  */
+  if (page_error == PAGE_NOERR)
+    for (page = offset; (p = _pager_pagemap_next (pager, &page, end)); page++)
+      *p = SET_PM_ERROR (*p, page_error);
+  else
+    for (page = offset; page < end; page++)
+      {
+	p = _pager_pagemap_get (pager, page, 1);
+	if (p)
+	  *p = SET_PM_ERROR (*p, page_error);
+      }
 }
 
 /* Tell us what the error (set with mark_object_error) for 
@@ -102,19 +126,13 @@ error_t
 pager_get_error (struct pager *p, vm_address_t addr)
 {
   error_t err;
+  short *pm_entry;
   
   pthread_mutex_lock (&p->interlock);
 
-  addr /= vm_page_size;
-
-  /* If there really is no error for ADDR, we should be able to exted the
-     pagemap table; otherwise, if some previous operation failed because it
-     couldn't extend the table, this attempt will *probably* (heh) fail for
-     the same reason.  */
-  err = _pager_pagemap_resize (p, addr);
-
-  if (! err)
-    err = _pager_page_errors[PM_ERROR(p->pagemap[addr])];
+  /* Pages without a pagemap entry have never had an error.  */
+  pm_entry = _pager_pagemap_get (p, addr / vm_page_size, 0);
+  err = pm_entry ? _pager_page_errors[PM_ERROR (*pm_entry)] : 0;
 
   pthread_mutex_unlock (&p->interlock);
 
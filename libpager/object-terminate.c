@@ -117,12 +117,7 @@ _pager_free_structure (struct pager *p)
     }
 
   /* Free the pagemap */
-  if (p->pagemapsize)
-    {
-      free (p->pagemap);
-      p->pagemapsize = 0;
-      p->pagemap = 0;
-    }
+  _pager_pagemap_free (p);
 
   p->pager_state = NOTINIT;
 }
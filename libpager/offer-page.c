@@ -30,10 +30,10 @@ pager_offer_page (struct pager *p,
 {
   pthread_mutex_lock (&p->interlock);
 
-  if (_pager_pagemap_resize (p, offset + vm_page_size))
+  short *pm_entry = _pager_pagemap_get (p, offset / vm_page_size, 1);
+  if (! pm_entry)
     goto release_out;
 
-  short *pm_entry = &p->pagemap[offset / vm_page_size];
   *pm_entry |= PM_INCORE;
 
   memory_object_data_supply (p->memobjcntl, offset, buf, vm_page_size, 0,
@@ -1,5 +1,5 @@
 /* Pagemap manipulation for pager library
-   Copyright (C) 1994, 1997, 1999, 2000 Free Software Foundation
+   Copyright (C) 1994, 1997, 1999, 2000, 2026 Free Software Foundation
 
    This program is free software; you can redistribute it and/or
    modify it under the terms of the GNU General Public License as
@@ -19,24 +19,165 @@
 #include <stdlib.h>
 #include <string.h>
 
-/* Grow the pagemap of pager P as necessary to deal with address OFF */
-error_t
-_pager_pagemap_resize (struct pager *p, vm_address_t off)
+/* An interior node of the pagemap radix tree.  */
+struct pagemap_node
 {
-  off /= __vm_page_size;
+  void *slots[PAGEMAP_NODE_SIZE];
+};
 
-  if (p->pagemapsize < off)
+/* Return the number of leaves covered by a tree with LEVELS interior
+   levels, or 0 if that is more than a vm_offset_t can count.  */
+static inline vm_offset_t
+pagemap_capacity (int levels)
+{
+  int shift = levels * PAGEMAP_NODE_SHIFT;
+  return shift < (int) (sizeof (vm_offset_t) * 8) ? (vm_offset_t) 1 << shift : 0;
+}
+
+/* Return the pagemap entry of page number PAGE (an offset divided by
+   the page size) in pager P.  If that part of the map has not been
+   allocated, allocate it if CREATE is set, and otherwise return NULL;
+   NULL is also returned if the allocation fails.  P must be locked.  */
+short *
+_pager_pagemap_get (struct pager *p, vm_offset_t page, int create)
+{
+  vm_offset_t leaf = page >> PAGEMAP_LEAF_SHIFT, capacity;
+  void **slot;
+  int level;
+
+  /* Add levels at the top until the tree covers LEAF.  */
+  while ((capacity = pagemap_capacity (p->pagemap_levels)) != 0
+	 && leaf >= capacity)
+    {
+      if (! create)
+	return NULL;
+
+      if (p->pagemap)
+	{
+	  struct pagemap_node *node = calloc (1, sizeof *node);
+	  if (! node)
+	    return NULL;
+	  node->slots[0] = p->pagemap;
+	  p->pagemap = node;
+	}
+      p->pagemap_levels++;
+    }
+
+  slot = &p->pagemap;
+  for (level = p->pagemap_levels; level > 0; level--)
+    {
+      if (! *slot)
+	{
+	  if (! create)
+	    return NULL;
+	  *slot = calloc (1, sizeof (struct pagemap_node));
+	  if (! *slot)
+	    return NULL;
+	}
+      slot = &((struct pagemap_node *) *slot)->slots
+	[(leaf >> ((level - 1) * PAGEMAP_NODE_SHIFT)) & (PAGEMAP_NODE_SIZE - 1)];
+    }
+
+  if (! *slot)
+    {
+      if (! create)
+	return NULL;
+      *slot = calloc (PAGEMAP_LEAF_SIZE, sizeof (short));
+      if (! *slot)
+	return NULL;
+    }
+
+  return &((short *) *slot)[page & (PAGEMAP_LEAF_SIZE - 1)];
+}
+
+/* Return the first allocated leaf at or after *LEAF and before END in
+   the subtree NODE, which has LEVEL interior levels and starts at leaf
+   BASE, and set *LEAF to its number; or return NULL if there is none.  */
+static short *
+pagemap_next_leaf (void *node, int level, vm_offset_t base,
+		   vm_offset_t *leaf, vm_offset_t end)
+{
+  vm_offset_t span;
+  int i;
+
+  if (! node)
+    return NULL;
+  if (level == 0)
+    return node;
+
+  span = pagemap_capacity (level - 1);
+  for (i = (*leaf - base) / span; i < PAGEMAP_NODE_SIZE; i++)
     {
-      void *newaddr = reallocarray (p->pagemap, off,
-                                    sizeof (*p->pagemap));
-      if (!newaddr)
-        return errno;
-
-      memset ((short *) newaddr + p->pagemapsize, 0,
-              (off - p->pagemapsize) * sizeof (*p->pagemap));
-      p->pagemap = newaddr;
-      p->pagemapsize = off;
+      vm_offset_t child = base + i * span;
+      short *found;
+
+      if (child >= end)
+	break;
+      if (*leaf < child)
+	*leaf = child;
+
+      found = pagemap_next_leaf (((struct pagemap_node *) node)->slots[i],
+				 level - 1, child, leaf, end);
+      if (found)
+	return found;
     }
 
-  return 0;
+  return NULL;
+}
+
+/* Return the pagemap entry of the first page at or after *PAGE and
+   before END in pager P which lies in an allocated part of the map, and
+   set *PAGE to its number; or return NULL if there is none.  This skips
+   the unallocated parts of the map, whose pages all have state 0,
+   without looking at them.  P must be locked.  */
+short *
+_pager_pagemap_next (struct pager *p, vm_offset_t *page, vm_offset_t end)
+{
+  vm_offset_t leaf = *page >> PAGEMAP_LEAF_SHIFT, found = leaf;
+  vm_offset_t end_leaf = (end + PAGEMAP_LEAF_SIZE - 1) >> PAGEMAP_LEAF_SHIFT;
+  vm_offset_t capacity = pagemap_capacity (p->pagemap_levels);
+  short *entries;
+
+  if (*page >= end)
+    return NULL;
+  if (capacity && end_leaf > capacity)
+    end_leaf = capacity;
+  if (leaf >= end_leaf)
+    return NULL;
+
+  entries = pagemap_next_leaf (p->pagemap, p->pagemap_levels, 0,
+			       &found, end_leaf);
+  if (! entries)
+    return NULL;
+
+  if (found != leaf)
+    {
+      *page = found << PAGEMAP_LEAF_SHIFT;
+      if (*page >= end)
+	return NULL;
+    }
+
+  return &entries[*page & (PAGEMAP_LEAF_SIZE - 1)];
+}
+
+static void
+pagemap_free (void *node, int level)
+{
+  int i;
+
+  if (! node)
+    return;
+  if (level > 0)
+    for (i = 0; i < PAGEMAP_NODE_SIZE; i++)
+      pagemap_free (((struct pagemap_node *) node)->slots[i], level - 1);
+  free (node);
+}
+
+/* Free the pagemap of pager P.  P must be locked.  */
+void
+_pager_pagemap_free (struct pager *p)
+{
+  pagemap_free (p->pagemap, p->pagemap_levels);
+  p->pagemap = NULL;
+  p->pagemap_levels = 0;
 }
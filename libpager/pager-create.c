@@ -45,7 +45,7 @@ _pager_create (size_t size,
   p->noterm = 0;
   p->termwaiting = 0;
   p->pagemap = 0;
-  p->pagemapsize = 0;
+  p->pagemap_levels = 0;
 
   return p;
 }
@@ -65,10 +65,21 @@ struct pager
   struct pending_init *init_head, *init_tail;
 #endif
 
-  short *pagemap;
-  vm_size_t pagemapsize;	/* number of elements in PAGEMAP */
+  /* The state of each page (PM_* below), kept in a radix tree of
+     PAGEMAP_LEAF_SIZE entry leaves so that only the parts of the object
+     which were actually touched take up memory.  Pages outside the
+     allocated leaves have state 0.  PAGEMAP_LEVELS is the number of
+     interior levels above the leaves; if it is 0, PAGEMAP points to
+     the leaf for the first PAGEMAP_LEAF_SIZE pages.  */
+  void *pagemap;
+  int pagemap_levels;
 };
 
+#define PAGEMAP_LEAF_SHIFT 8
+#define PAGEMAP_LEAF_SIZE (1 << PAGEMAP_LEAF_SHIFT)
+#define PAGEMAP_NODE_SHIFT 6
+#define PAGEMAP_NODE_SIZE (1 << PAGEMAP_NODE_SHIFT)
+
 struct lock_request
 {
   struct lock_request *next, **prevp;
@@ -133,7 +144,9 @@ extern struct port_class *_pager_class;
 
 void _pager_block_termination (struct pager *);
 void _pager_allow_termination (struct pager *);
-error_t _pager_pagemap_resize (struct pager *, vm_address_t);
+short *_pager_pagemap_get (struct pager *, vm_offset_t, int);
+short *_pager_pagemap_next (struct pager *, vm_offset_t *, vm_offset_t);
+void _pager_pagemap_free (struct pager *);
 void _pager_mark_next_request_error (struct pager *, vm_address_t,
 				     vm_size_t, error_t);
 void _pager_mark_object_error (struct pager *, vm_address_t,
@@ -1,6 +1,6 @@
 /* Generic one-way pipes
 
-   Copyright (C) 1995, 1998 Free Software Foundation, Inc.
+   Copyright (C) 1995, 1998, 2026 Free Software Foundation, Inc.
 
    Written by Miles Bader <miles@gnu.ai.mit.edu>
 
@@ -26,6 +26,7 @@
 #include <mach/mach_host.h>
 
 #include <hurd/hurd_types.h>
+#include <hurd/iohelp.h>
 
 #include "pipe.h"
 
@@ -66,6 +67,7 @@ pipe_create (struct pipe_class *class, struct pipe **pipe)
   pthread_cond_init (&new->pending_writes, NULL);
   pthread_cond_init (&new->pending_write_selects, NULL);
   new->pending_selects = NULL;
+  new->events = NULL;
   pthread_mutex_init (&new->lock, NULL);
 
   pq_create (&new->queue);
@@ -77,10 +79,73 @@ pipe_create (struct pipe_class *class, struct pipe **pipe)
   return 0;
 }
 
+/* ---------------------------------------------------------------- */
+
+/* An io_event_register registration, linked on the one or two pipes
+   whose change would satisfy it.  */
+struct pipe_event
+{
+  mach_port_t port;		/* The send-once right to post to.  */
+  vm_address_t cookie;
+
+  int nlinks;			/* How many of LINKS are in use.  */
+  struct pipe_event_link links[2];
+};
+
+/* Since a registration on two pipes is posted by whichever of them
+   changes first, with only that one locked, the EVENTS lists of all
+   pipes are protected by this lock.  It is taken with pipes locked, and
+   nothing else is locked while holding it.  */
+static pthread_mutex_t pipe_event_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/* Post E with READY as the kinds of i/o ready, take all its links off
+   their pipes, and free it.  PIPE_EVENT_LOCK should be held.  */
+static void
+pipe_event_deliver (struct pipe_event *e, int ready)
+{
+  int i;
+
+  iohelp_post_event (e->port, e->cookie, ready);
+  for (i = 0; i < e->nlinks; i++)
+    {
+      struct pipe_event_link *l = &e->links[i];
+
+      *l->prevp = l->next;
+      if (l->next)
+	l->next->prevp = l->prevp;
+    }
+  free (e);
+}
+
+/* Post the registrations on PIPE, which should be locked, that wait for
+   any of the kinds of i/o in READY.  If CANCEL is true, post all of them
+   as having nothing ready.  A registration also linked on another pipe
+   is taken off that one too.  */
+static void
+pipe_post_events (struct pipe *pipe, int ready, int cancel)
+{
+  struct pipe_event_link **lp = &pipe->events, *l;
+
+  /* Other pipes only ever remove links from our list, and adding them
+     takes our lock, so an empty list stays empty.  */
+  if (! *lp)
+    return;
+
+  pthread_mutex_lock (&pipe_event_lock);
+  while ((l = *lp))
+    if (cancel || (l->select_type & ready))
+      /* This unlinks L, and so sets *LP to what follows.  */
+      pipe_event_deliver (l->event, cancel ? 0 : l->select_type & ready);
+    else
+      lp = &l->next;
+  pthread_mutex_unlock (&pipe_event_lock);
+}
+
 /* Free PIPE and any resources it holds.  */
 void
 pipe_free (struct pipe *pipe)
 {
+  pipe_post_events (pipe, 0, 1);
   pq_free (pipe->queue);
   free (pipe);
 }
@@ -173,6 +238,7 @@ void _pipe_no_readers (struct pipe *pipe)
 	  pthread_cond_broadcast (&pipe->pending_writes);
 	  pthread_cond_broadcast (&pipe->pending_write_selects);
 	  pipe_select_cond_broadcast (pipe);
+	  pipe_post_events (pipe, SELECT_WRITE, 0);
 	}
       pthread_mutex_unlock (&pipe->lock);
     }
@@ -195,6 +261,7 @@ void _pipe_no_writers (struct pipe *pipe)
 	      pthread_cond_broadcast (&pipe->pending_reads);
 	      pthread_cond_broadcast (&pipe->pending_read_selects);
 	      pipe_select_cond_broadcast (pipe);
+	      pipe_post_events (pipe, SELECT_READ, 0);
 	    }
 	}
       pthread_mutex_unlock (&pipe->lock);
@@ -214,6 +281,7 @@ void _pipe_wake_writers (struct pipe *pipe)
     {
       pthread_cond_broadcast (&pipe->pending_write_selects);
       pipe_select_cond_broadcast (pipe);
+      pipe_post_events (pipe, SELECT_WRITE, 0);
       /* We leave PIPE locked here, assuming the caller will soon unlock
 	 it and allow others access.  */
     }
@@ -321,6 +389,99 @@ pipe_pair_select (struct pipe *rpipe, struct pipe *wpipe,
 
   return err;
 }
+
+/* Record on PIPE, which should be locked, that E waits for SELECT_TYPE.
+   PIPE_EVENT_LOCK should be held.  */
+static void
+pipe_link_event (struct pipe *pipe, struct pipe_event *e, int select_type)
+{
+  struct pipe_event_link *l = &e->links[e->nlinks++];
+
+  l->event = e;
+  l->select_type = select_type;
+  l->next = pipe->events;
+  if (l->next)
+    l->next->prevp = &l->next;
+  l->prevp = &pipe->events;
+  pipe->events = l;
+}
+
+/* Handle io_event_register for RPIPE becoming readable (if SELECT_READ is
+   set in SELECT_TYPE) or WPIPE becoming writable (if SELECT_WRITE is set),
+   as pipe_pair_select would wait for, with the send-once right PORT and
+   COOKIE.  Rather than blocking, this records the registration on the
+   pipes, which post it when they change; PORT is consumed unless an error
+   is returned.  A pipe which is not selected may be NULL.  Neither RPIPE
+   or WPIPE should be locked when calling this function.  */
+error_t
+pipe_pair_event_register (struct pipe *rpipe, struct pipe *wpipe,
+			  mach_port_t port, vm_address_t cookie,
+			  int select_type, int data_only)
+{
+  struct pipe_event *e;
+  int multiple;
+  int ready = 0;
+
+  select_type &= SELECT_READ | SELECT_WRITE;
+  if (! (select_type & SELECT_READ))
+    rpipe = NULL;
+  if (! (select_type & SELECT_WRITE))
+    wpipe = NULL;
+  if (! rpipe && ! wpipe)
+    return EINVAL;
+
+  e = malloc (sizeof (struct pipe_event));
+  if (e == NULL)
+    return ENOMEM;
+
+  multiple = rpipe && wpipe && rpipe != wpipe;
+  if (multiple)
+    {
+      pthread_mutex_lock (&pipe_multiple_lock);
+      pthread_mutex_lock (&rpipe->lock);
+      pthread_mutex_lock (&wpipe->lock);
+    }
+  else
+    pthread_mutex_lock (&(rpipe ?: wpipe)->lock);
+
+  if (rpipe
+      && ((rpipe->flags & PIPE_BROKEN) || pipe_is_readable (rpipe, data_only)))
+    ready |= SELECT_READ;
+  if (wpipe
+      && ((wpipe->flags & PIPE_BROKEN)
+	  || pipe_readable (wpipe, 1) < wpipe->write_limit))
+    ready |= SELECT_WRITE;
+
+  if (ready)
+    /* No need to wait.  */
+    {
+      iohelp_post_event (port, cookie, ready);
+      free (e);
+    }
+  else
+    {
+      e->port = port;
+      e->cookie = cookie;
+      e->nlinks = 0;
+      pthread_mutex_lock (&pipe_event_lock);
+      if (rpipe)
+	pipe_link_event (rpipe, e, SELECT_READ);
+      if (wpipe)
+	pipe_link_event (wpipe, e, SELECT_WRITE);
+      pthread_mutex_unlock (&pipe_event_lock);
+    }
+
+  if (multiple)
+    {
+      pthread_mutex_unlock (&rpipe->lock);
+      pthread_mutex_unlock (&wpipe->lock);
+      pthread_mutex_unlock (&pipe_multiple_lock);
+    }
+  else
+    pthread_mutex_unlock (&(rpipe ?: wpipe)->lock);
+
+  return 0;
+}
 
 /* Writes up to LEN bytes of DATA, to PIPE, which should be locked, and
    returns the amount written in AMOUNT.  If present, the information in
@@ -414,6 +575,7 @@ pipe_send (struct pipe *pipe, int noblock, void *source,
 	    {
 	      pthread_cond_broadcast (&pipe->pending_read_selects);
 	      pipe_select_cond_broadcast (pipe);
+	      pipe_post_events (pipe, SELECT_READ, 0);
 	    }
 
 	  if (!noblock && done < data_len)
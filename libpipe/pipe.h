@@ -1,6 +1,6 @@
 /* Generic one-way pipes
 
-   Copyright (C) 1995, 1996 Free Software Foundation, Inc.
+   Copyright (C) 1995, 1996, 2026 Free Software Foundation, Inc.
 
    Written by Miles Bader <miles@gnu.ai.mit.edu>
 
@@ -69,6 +69,15 @@ struct pipe_select_cond
   pthread_cond_t cond;
 };
 
+/* One of the pipes an io_event_register registration is waiting on; see
+   pipe_pair_event_register.  */
+struct pipe_event_link
+{
+  struct pipe_event_link *next, **prevp;
+  struct pipe_event *event;
+  int select_type;		/* SELECT_READ or SELECT_WRITE.  */
+};
+
 /* A unidirectional data pipe; it transfers data from READER to WRITER.  */
 struct pipe
 {
@@ -97,6 +106,10 @@ struct pipe
 
   struct pipe_select_cond *pending_selects;
 
+  /* Registrations waiting for this pipe to become readable or writable,
+     protected by a lock private to pipe.c rather than by LOCK.  */
+  struct pipe_event_link *events;
+
   /* The maximum number of characters that this pipe will hold without
      further writes blocking.  */
   size_t write_limit;
@@ -436,6 +449,17 @@ extern pthread_mutex_t pipe_multiple_lock;
 error_t pipe_pair_select (struct pipe *rpipe, struct pipe *wpipe,
 			  struct timespec *tsp, int *select_type,
 			  int data_only);
+
+/* Handle io_event_register for RPIPE becoming readable (if SELECT_READ is
+   set in SELECT_TYPE) or WPIPE becoming writable (if SELECT_WRITE is set),
+   as pipe_pair_select would wait for, with the send-once right PORT and
+   COOKIE.  Rather than blocking, this records the registration on the
+   pipes, which post it when they change; PORT is consumed unless an error
+   is returned.  A pipe which is not selected may be NULL.  Neither RPIPE
+   or WPIPE should be locked when calling this function.  */
+error_t pipe_pair_event_register (struct pipe *rpipe, struct pipe *wpipe,
+				  mach_port_t port, vm_address_t cookie,
+				  int select_type, int data_only);
 
 /* ---------------------------------------------------------------- */
 /* User-provided functions.  */
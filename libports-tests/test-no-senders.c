@@ -0,0 +1,140 @@
+/* test-no-senders.c: Test the batched deallocation of ports whose
+   senders went away
+
+   Copyright (C) 2026 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation; either version 2, or (at
+   your option) any later version.
+
+   This program is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with the GNU Hurd.  If not, see <http://www.gnu.org/licenses/>.  */
+
+/* This serves NPORTS ports, each with a single send right, drops all the
+   send rights, and checks that the no-senders notifications deallocate
+   every port, in batches.  It exits with status 0 if all checks pass.  */
+
+#include <errno.h>
+#include <error.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <hurd.h>
+#include <hurd/ports.h>
+
+#define NPORTS	1000
+
+static struct port_bucket *bucket;
+static struct port_class *class;
+static mach_port_t rights[NPORTS];
+
+static int cleaned, failures;
+static pthread_mutex_t cleaned_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static void
+clean (void *port)
+{
+  (void) port;
+
+  pthread_mutex_lock (&cleaned_lock);
+  cleaned++;
+  pthread_mutex_unlock (&cleaned_lock);
+}
+
+static void
+check (int ok, const char *what)
+{
+  printf ("%s: %s\n", ok ? "PASS" : "FAIL", what);
+  if (! ok)
+    failures++;
+}
+
+static int
+demuxer (mach_msg_header_t *inp, mach_msg_header_t *outp)
+{
+  return ports_notify_server (inp, outp);
+}
+
+static void *
+serve (void *arg)
+{
+  (void) arg;
+
+  ports_manage_port_operations_multithread (bucket, demuxer, 0, 0, NULL);
+  return NULL;
+}
+
+int
+main (void)
+{
+  struct ports_no_senders_stats before, after;
+  pthread_t thread;
+  error_t err;
+  int i, done;
+
+  bucket = ports_create_bucket ();
+  class = ports_create_class (clean, NULL);
+  if (! bucket || ! class)
+    error (1, errno, "ports_create_bucket");
+
+  for (i = 0; i < NPORTS; i++)
+    {
+      struct port_info *pi;
+
+      err = ports_create_port (class, bucket, sizeof *pi, &pi);
+      if (err)
+	error (1, err, "ports_create_port");
+      rights[i] = ports_get_right (pi);
+      err = mach_port_insert_right (mach_task_self (), rights[i], rights[i],
+				    MACH_MSG_TYPE_MAKE_SEND);
+      if (err)
+	error (1, err, "mach_port_insert_right");
+      /* Only the send right keeps PI now.  */
+      ports_port_deref (pi);
+    }
+
+  ports_get_no_senders_stats (&before);
+  err = pthread_create (&thread, NULL, serve, NULL);
+  if (err)
+    error (1, err, "pthread_create");
+  pthread_detach (thread);
+
+  /* A dying client: all its send rights go away at once.  */
+  for (i = 0; i < NPORTS; i++)
+    mach_port_deallocate (mach_task_self (), rights[i]);
+
+  for (i = 0; i < 1000; i++)
+    {
+      pthread_mutex_lock (&cleaned_lock);
+      done = cleaned;
+      pthread_mutex_unlock (&cleaned_lock);
+      if (done == NPORTS)
+	break;
+      usleep (10000);
+    }
+  ports_get_no_senders_stats (&after);
+
+  printf ("%d ports: %lu batches, largest %lu, largest backlog %lu\n",
+	  NPORTS, after.batches - before.batches, after.max_batch,
+	  after.max_backlog);
+  check (after.notifications - before.notifications == NPORTS,
+	 "every notification arrived");
+  check (done == NPORTS, "every port was cleaned");
+  check (after.deallocated - before.deallocated == NPORTS,
+	 "every port went through a batch");
+  check (after.batches > before.batches
+	 && after.batches - before.batches <= NPORTS,
+	 "batches were counted");
+  check (after.backlog == 0, "nothing is left waiting");
+  check (ports_count_class (class) == 0, "the class is empty");
+
+  if (failures)
+    error (1, 0, "%d checks failed", failures);
+  return 0;
+}
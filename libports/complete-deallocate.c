@@ -1,5 +1,5 @@
 /* 
-   Copyright (C) 1995, 1996 Free Software Foundation, Inc.
+   Copyright (C) 1995, 1996, 2026 Free Software Foundation, Inc.
    Written by Michael I. Bushnell.
 
    This file is part of the GNU Hurd.
@@ -22,8 +22,11 @@
 #include <assert-backtrace.h>
 #include <hurd/ihash.h>
 
-void
-_ports_complete_deallocate (struct port_info *pi)
+/* Remove PI, which has no references left, from the hash tables, so
+   that no lookup can find it any more.  Return nonzero if PI may now be
+   deallocated, zero if a reference was reacquired meanwhile.  */
+int
+_ports_unhash_dead_port (struct port_info *pi)
 {
   assert_backtrace ((pi->flags & PORT_HAS_SENDRIGHTS) == 0);
 
@@ -40,29 +43,59 @@ _ports_complete_deallocate (struct port_info *pi)
           /* XXX: This really shouldn't happen.  */
           assert_backtrace (! "reacquired reference w/o send rights");
           pthread_rwlock_unlock (&_ports_htable_lock);
-          return;
+          return 0;
         }
 
       hurd_ihash_locp_remove (&_ports_htable, pi->ports_htable_entry);
       hurd_ihash_locp_remove (&pi->bucket->htable, pi->hentry);
       pthread_rwlock_unlock (&_ports_htable_lock);
-
-      mach_port_mod_refs (mach_task_self (), pi->port_right,
-			  MACH_PORT_RIGHT_RECEIVE, -1);
-      pi->port_right = MACH_PORT_NULL;
     }
 
-  pthread_mutex_lock (&_ports_lock);
+  return 1;
+}
 
-  pi->bucket->count--;
-  pi->class->count--;
+/* Deallocate the NUM ports in PORTS, which _ports_unhash_dead_port has
+   already removed from the hash tables.  Doing many at once takes
+   _ports_lock only once.  */
+void
+_ports_complete_deallocate_many (struct port_info **ports, size_t num)
+{
+  size_t i;
+
+  for (i = 0; i < num; i++)
+    if (MACH_PORT_VALID (ports[i]->port_right))
+      {
+	mach_port_mod_refs (mach_task_self (), ports[i]->port_right,
+			    MACH_PORT_RIGHT_RECEIVE, -1);
+	ports[i]->port_right = MACH_PORT_NULL;
+      }
 
+  pthread_mutex_lock (&_ports_lock);
+  for (i = 0; i < num; i++)
+    {
+      ports[i]->bucket->count--;
+      ports[i]->class->count--;
+    }
   pthread_mutex_unlock (&_ports_lock);
 
-  if (pi->class->clean_routine)
-    (*pi->class->clean_routine)(pi);
-  
-  assert_backtrace (pi->current_rpcs == NULL);
+  for (i = 0; i < num; i++)
+    {
+      struct port_info *pi = ports[i];
+
+      if (pi->class->clean_routine)
+	(*pi->class->clean_routine)(pi);
+
+      assert_backtrace (pi->current_rpcs == NULL);
+
+      free (pi);
+    }
+}
 
-  free (pi);
+void
+_ports_complete_deallocate (struct port_info *pi)
+{
+  if (pi->flags & PORT_NO_SENDERS)
+    _ports_deallocate_batched (pi);
+  else if (_ports_unhash_dead_port (pi))
+    _ports_complete_deallocate_many (&pi, 1);
 }
@@ -1,5 +1,5 @@
 /*
-   Copyright (C) 1995,96,2000 Free Software Foundation, Inc.
+   Copyright (C) 1995,96,2000,2026 Free Software Foundation, Inc.
    Written by Michael I. Bushnell.
 
    This file is part of the GNU Hurd.
@@ -41,6 +41,7 @@ ports_get_right (void *port)
   if ((pi->flags & PORT_HAS_SENDRIGHTS) == 0)
     {
       pi->flags |= PORT_HAS_SENDRIGHTS;
+      pi->flags &= ~PORT_NO_SENDERS;
       refcounts_ref (&pi->refcounts, NULL);
       err = mach_port_request_notification (mach_task_self (),
 					    pi->port_right,
@@ -1,5 +1,5 @@
 /* 
-   Copyright (C) 1995, 1996 Free Software Foundation, Inc.
+   Copyright (C) 1995, 1996, 2026 Free Software Foundation, Inc.
    Written by Michael I. Bushnell.
 
    This file is part of the GNU Hurd.
@@ -19,8 +19,98 @@
    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA. */
 
 #include "ports.h"
+#include <stdlib.h>
+#include <hurd.h>
 #include <mach/notify.h>
 
+/* Ports whose senders went away, already removed from the hash tables
+   and waiting to be deallocated, and whether some thread is doing that
+   right now; all protected by BATCH_LOCK, as is STATS.  The draining
+   thread swaps BATCH with SPARE, so that both buffers are kept for the
+   next time instead of being freed after every batch.  */
+static struct port_info **batch, **spare;
+static size_t batch_len, batch_alloced, spare_alloced;
+static int draining;
+static struct ports_no_senders_stats stats;
+static pthread_mutex_t batch_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/* Deallocate PI, which ports_no_senders marked PORT_NO_SENDERS and
+   which has no references left.  If another thread is already
+   deallocating ports, just leave PI for it to do.  Otherwise, deallocate
+   it along with any others that pile up meanwhile.  */
+void
+_ports_deallocate_batched (struct port_info *pi)
+{
+  /* Nothing must find PI while it waits in the batch.  */
+  if (! _ports_unhash_dead_port (pi))
+    return;
+
+  pthread_mutex_lock (&batch_lock);
+
+  if (batch_len == batch_alloced)
+    {
+      size_t alloced = batch_alloced ? 2 * batch_alloced : 16;
+      struct port_info **new = realloc (batch, alloced * sizeof *new);
+
+      if (! new)
+	/* Do it ourselves right away.  */
+	{
+	  stats.deallocated++;
+	  pthread_mutex_unlock (&batch_lock);
+	  _ports_complete_deallocate_many (&pi, 1);
+	  return;
+	}
+
+      batch = new;
+      batch_alloced = alloced;
+    }
+
+  batch[batch_len++] = pi;
+  if (batch_len > stats.max_backlog)
+    stats.max_backlog = batch_len;
+
+  if (draining)
+    {
+      pthread_mutex_unlock (&batch_lock);
+      return;
+    }
+
+  draining = 1;
+  while (batch_len > 0)
+    {
+      struct port_info **ports = batch;
+      size_t num = batch_len, alloced = batch_alloced;
+
+      batch = spare;
+      batch_alloced = spare_alloced;
+      batch_len = 0;
+
+      stats.deallocated += num;
+      stats.batches++;
+      if (num > stats.max_batch)
+	stats.max_batch = num;
+
+      pthread_mutex_unlock (&batch_lock);
+      _ports_complete_deallocate_many (ports, num);
+      pthread_mutex_lock (&batch_lock);
+
+      spare = ports;
+      spare_alloced = alloced;
+    }
+  draining = 0;
+
+  pthread_mutex_unlock (&batch_lock);
+}
+
+void
+ports_get_no_senders_stats (struct ports_no_senders_stats *st)
+{
+  pthread_mutex_lock (&batch_lock);
+  *st = stats;
+  st->backlog = batch_len;
+  pthread_mutex_unlock (&batch_lock);
+}
+
 void
 ports_no_senders (void *portstruct,
 		  mach_port_mscount_t mscount)
@@ -29,6 +119,8 @@ ports_no_senders (void *portstruct,
   int dealloc;
   mach_port_t old;
 
+  __atomic_add_fetch (&stats.notifications, 1, __ATOMIC_RELAXED);
+
   pthread_mutex_lock (&_ports_lock);
   if ((pi->flags & PORT_HAS_SENDRIGHTS) == 0)
     {
@@ -37,8 +129,21 @@ ports_no_senders (void *portstruct,
     }
   if (mscount >= pi->mscount)
     {
+      struct rpc_info *rpc;
+      thread_t self = hurd_thread_self ();
+
       dealloc = 1;
       pi->flags &= ~PORT_HAS_SENDRIGHTS;
+      pi->flags |= PORT_NO_SENDERS;
+
+      /* Interrupt any RPCs in progress on PI, as ports_interrupt_rpcs
+	 would, while we have the lock anyway.  */
+      for (rpc = pi->current_rpcs; rpc; rpc = rpc->next)
+	if (rpc->thread != self)
+	  {
+	    hurd_thread_cancel (rpc->thread);
+	    _ports_record_interruption (rpc);
+	  }
     }
   else
     {
@@ -59,7 +164,9 @@ ports_no_senders (void *portstruct,
     {
       ports_interrupt_notified_rpcs (portstruct, pi->port_right,
 				     MACH_NOTIFY_NO_SENDERS);
-      ports_interrupt_rpcs (pi);
+      /* The thread delivering the notification still holds references
+	 to PI, so this is rarely the last one.  Whoever drops that sends
+	 PI to _ports_deallocate_batched, because of PORT_NO_SENDERS.  */
       ports_port_deref (pi);
     }
 }
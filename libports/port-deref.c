@@ -1,5 +1,5 @@
 /* 
-   Copyright (C) 1995, 2001 Free Software Foundation, Inc.
+   Copyright (C) 1995, 2001, 2026 Free Software Foundation, Inc.
    Written by Michael I. Bushnell.
 
    This file is part of the GNU Hurd.
@@ -21,10 +21,11 @@
 #include "ports.h"
 #include <assert-backtrace.h>
 
-void
-ports_port_deref (void *portstruct)
+/* Drop a hard reference to PI, returning true if that was its last
+   reference of any kind, in which case the caller should deallocate it.  */
+int
+_ports_port_deref_last (struct port_info *pi)
 {
-  struct port_info *pi = portstruct;
   struct references result;
 
   if (pi->class->dropweak_routine)
@@ -43,6 +44,14 @@ ports_port_deref (void *portstruct)
   else
     refcounts_deref (&pi->refcounts, &result);
 
-  if (result.hard == 0 && result.weak == 0)
+  return result.hard == 0 && result.weak == 0;
+}
+
+void
+ports_port_deref (void *portstruct)
+{
+  struct port_info *pi = portstruct;
+
+  if (_ports_port_deref_last (pi))
     _ports_complete_deallocate (pi);
 }
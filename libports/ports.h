@@ -1,5 +1,5 @@
 /* Ports library for server construction
-   Copyright (C) 1993,94,95,96,97,99,2000 Free Software Foundation, Inc.
+   Copyright (C) 1993,94,95,96,97,99,2000,2026 Free Software Foundation, Inc.
    Written by Michael I. Bushnell.
 
    This file is part of the GNU Hurd.
@@ -66,6 +66,7 @@ typedef struct port_info *port_info_t;
 
 /* FLAGS above are the following: */
 #define PORT_HAS_SENDRIGHTS	0x0001 /* send rights extant */
+#define PORT_NO_SENDERS		0x0002 /* ports_no_senders dropped them */
 #define PORT_INHIBITED		PORTS_INHIBITED
 #define PORT_BLOCKED		PORTS_BLOCKED
 #define PORT_INHIBIT_WAIT	PORTS_INHIBIT_WAIT
@@ -334,6 +335,23 @@ error_t ports_request_dead_name_notification (void *object,
    when one arrives, call this routine for the PORT the message was
    sent to, providing the MSCOUNT from the notification. */
 void ports_no_senders (void *port, mach_port_mscount_t mscount);
+
+/* Statistics about the ports deallocated by ports_no_senders.  When many
+   senders go away at once, say because a big task died, the ports are
+   deallocated in batches by whichever thread gets there first, while the
+   others go back to serving requests.  */
+struct ports_no_senders_stats
+{
+  unsigned long notifications;	/* Calls to ports_no_senders.  */
+  unsigned long deallocated;	/* Ports deallocated by them.  */
+  unsigned long batches;	/* Number of batches that took.  */
+  unsigned long max_batch;	/* Size of the largest batch.  */
+  unsigned long backlog;	/* Ports now waiting to be deallocated.  */
+  unsigned long max_backlog;	/* The largest that got.  */
+};
+
+/* Return the current no-senders statistics in STATS.  */
+void ports_get_no_senders_stats (struct ports_no_senders_stats *stats);
 void ports_dead_name (void *notify, mach_port_t dead_name);
 
 /* Block port creation of new ports in CLASS.  Return the number
@@ -505,6 +523,10 @@ extern int _ports_flags;
 #define _PORTS_BLOCKED		PORTS_BLOCKED
 #define _PORTS_INHIBIT_WAIT	PORTS_INHIBIT_WAIT
 void _ports_complete_deallocate (struct port_info *);
+int _ports_unhash_dead_port (struct port_info *);
+void _ports_complete_deallocate_many (struct port_info **, size_t);
+void _ports_deallocate_batched (struct port_info *);
+int _ports_port_deref_last (struct port_info *);
 error_t _ports_create_port_internal (struct port_class *, struct port_bucket *,
 				     size_t, void *, int);
 
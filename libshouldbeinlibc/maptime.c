@@ -1,6 +1,6 @@
 /* Support for mach's mapped time
 
-   Copyright (C) 1996, 1997 Free Software Foundation, Inc.
+   Copyright (C) 1996, 1997, 2026 Free Software Foundation, Inc.
 
    Written by Miles Bader <miles@gnu.ai.mit.edu>
 
@@ -82,3 +82,14 @@ maptime_map (int use_mach_dev, char *dev_name,
 
   return err;
 }
+
+/* Like maptime_map, but try the hurd time device "/dev/time" first, and
+   then the mach device "time".  */
+error_t
+maptime_map_any (volatile struct mapped_time_value **mtime)
+{
+  error_t err = maptime_map (0, 0, mtime);
+  if (err)
+    err = maptime_map (1, 0, mtime);
+  return err;
+}
@@ -1,6 +1,6 @@
 /* Support for mach's mapped time
 
-   Copyright (C) 1996, 1997, 2000, 2007 Free Software Foundation, Inc.
+   Copyright (C) 1996, 1997, 2000, 2007, 2026 Free Software Foundation, Inc.
 
    Written by Miles Bader <miles@gnu.org>
 
@@ -23,6 +23,7 @@
 
 #include <mach/time_value.h>
 #include <sys/time.h>
+#include <time.h>
 #include <errno.h>
 #include <features.h>
 
@@ -40,8 +41,18 @@
 error_t maptime_map (int use_mach_dev, char *dev_name,
 		     volatile struct mapped_time_value **mtime);
 
+/* Like maptime_map, but try the hurd time device "/dev/time" first, and
+   then the mach device "time", so that this works both for unprivileged
+   servers and for those started before /dev/time is available.  */
+error_t maptime_map_any (volatile struct mapped_time_value **mtime);
+
 extern void maptime_read (volatile struct mapped_time_value *mtime, struct timeval *tv);
 
+extern void maptime_read_timespec (volatile struct mapped_time_value *mtime,
+				   struct timespec *ts);
+
+extern time_t maptime_seconds (volatile struct mapped_time_value *mtime);
+
 #if defined(__USE_EXTERN_INLINES) || defined(MAPTIME_DEFINE_EI)
 
 /* Read the current time from MTIME into TV.  This should be very fast.  */
@@ -58,6 +69,29 @@ maptime_read (volatile struct mapped_time_value *mtime, struct timeval *tv)
   while (tv->tv_sec != mtime->check_seconds);
 }
 
+/* Read the current time from MTIME into TS, as is wanted for the times in
+   a struct stat.  */
+MAPTIME_EI void
+maptime_read_timespec (volatile struct mapped_time_value *mtime,
+		       struct timespec *ts)
+{
+  struct timeval tv;
+
+  maptime_read (mtime, &tv);
+  ts->tv_sec = tv.tv_sec;
+  ts->tv_nsec = tv.tv_usec * 1000;
+}
+
+/* Return the current time in seconds from MTIME.  This is a single load
+   from the mapped page, without maptime_read's loop, so it is the thing
+   to use for timestamps that only need a precision of a second, and to
+   decide whether a finer one needs updating at all.  */
+MAPTIME_EI time_t
+maptime_seconds (volatile struct mapped_time_value *mtime)
+{
+  return mtime->seconds;
+}
+
 #endif /* Use extern inlines.  */
 
 #endif /* __MAPTIME_H__ */
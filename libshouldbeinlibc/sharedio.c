@@ -0,0 +1,354 @@
+/* Client side of the shared I/O page protocol
+
+   Copyright (C) 2026 Free Software Foundation, Inc.
+
+   This file is part of the GNU Hurd.
+
+   The GNU Hurd is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation; either version 2, or (at
+   your option) any later version.
+
+   The GNU Hurd is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with the GNU Hurd.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include <hurd.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "sharedio.h"
+
+/* The size of the window we map onto a file.  It slides along in
+   steps of its own size, so that sequential I/O remaps it only once in
+   a while, yet it takes little address space however big the file.  */
+#define WINDOW_SIZE (1024 * 1024)
+
+#define SHARED_LOCK(sh) ((pthread_spinlock_t *) &(sh)->lock)
+
+/* Make sure we hold the conch of SIO.  If the server has taken it back
+   since we last had it, ask for it again; the server then refreshes the
+   shared page.  */
+static error_t
+conch_get (struct sharedio *sio)
+{
+  volatile struct shared_io *sh = sio->shared;
+
+  pthread_spin_lock (SHARED_LOCK (sh));
+  switch (sh->conch_status)
+    {
+    case USER_COULD_HAVE_CONCH:
+      sh->conch_status = USER_HAS_CONCH;
+      /* Fall through.  */
+    case USER_HAS_CONCH:
+    case USER_RELEASE_CONCH:
+      pthread_spin_unlock (SHARED_LOCK (sh));
+      return 0;
+
+    case USER_HAS_NOT_CONCH:
+      break;
+    }
+  pthread_spin_unlock (SHARED_LOCK (sh));
+
+  return io_get_conch (sio->io);
+}
+
+/* We are done with the shared page of SIO for now.  Keep the conch so
+   that the next call needs no RPC, unless the server wants it.  */
+static void
+conch_put (struct sharedio *sio)
+{
+  volatile struct shared_io *sh = sio->shared;
+
+  pthread_spin_lock (SHARED_LOCK (sh));
+  if (sh->conch_status == USER_RELEASE_CONCH)
+    {
+      pthread_spin_unlock (SHARED_LOCK (sh));
+      io_release_conch (sio->io);
+      return;
+    }
+  sh->conch_status = USER_COULD_HAVE_CONCH;
+  pthread_spin_unlock (SHARED_LOCK (sh));
+}
+
+/* Make sure the window of SIO onto its file covers the byte at POS,
+   and return in *AVAIL how many bytes from there on it covers.  Return
+   EFBIG if POS is beyond what we can map at all.  */
+static error_t
+cover (struct sharedio *sio, off_t pos, size_t *avail)
+{
+  vm_address_t addr = 0;
+  off_t offset;
+  error_t err;
+
+  if (pos < sio->offset || pos >= sio->offset + (off_t) sio->size)
+    {
+      offset = pos & ~((off_t) WINDOW_SIZE - 1);
+      if (offset > (vm_offset_t) -1 - WINDOW_SIZE)
+	return EFBIG;
+
+      err = vm_map (mach_task_self (), &addr, WINDOW_SIZE, 0, 1, sio->memobj,
+		    offset, 0, sio->prot, sio->prot, VM_INHERIT_NONE);
+      if (err)
+	return err;
+
+      if (sio->data)
+	vm_deallocate (mach_task_self (), (vm_address_t) sio->data,
+		       sio->size);
+      sio->data = (char *) addr;
+      sio->offset = offset;
+      sio->size = WINDOW_SIZE;
+    }
+
+  *avail = sio->offset + sio->size - pos;
+  return 0;
+}
+
+error_t
+sharedio_create (io_t io, struct sharedio **sio)
+{
+  mach_port_t rdobj, wrobj, ctlobj;
+  vm_address_t page = 0;
+  struct sharedio *s;
+  error_t err;
+
+  err = io_map (io, &rdobj, &wrobj);
+  if (err)
+    return err;
+
+  s = malloc (sizeof *s);
+  if (s == NULL)
+    err = ENOMEM;
+  else if (wrobj != MACH_PORT_NULL
+	   && (rdobj == MACH_PORT_NULL || rdobj == wrobj))
+    {
+      s->memobj = wrobj;
+      s->prot = VM_PROT_READ | VM_PROT_WRITE;
+      wrobj = MACH_PORT_NULL;
+    }
+  else if (rdobj != MACH_PORT_NULL && wrobj == MACH_PORT_NULL)
+    {
+      s->memobj = rdobj;
+      s->prot = VM_PROT_READ;
+      rdobj = MACH_PORT_NULL;
+    }
+  else
+    /* No data, or separate objects for reading and writing, as a
+       stream would have.  */
+    err = EOPNOTSUPP;
+
+  if (rdobj != MACH_PORT_NULL)
+    mach_port_deallocate (mach_task_self (), rdobj);
+  if (wrobj != MACH_PORT_NULL)
+    mach_port_deallocate (mach_task_self (), wrobj);
+  if (err)
+    {
+      free (s);
+      return err;
+    }
+
+  s->io = io;
+  s->data = NULL;
+  s->offset = 0;
+  s->size = 0;
+
+  err = io_map_cntl (io, &ctlobj);
+  if (! err)
+    {
+      err = vm_map (mach_task_self (), &page, vm_page_size, 0, 1, ctlobj,
+		    0, 0, VM_PROT_READ | VM_PROT_WRITE,
+		    VM_PROT_READ | VM_PROT_WRITE, VM_INHERIT_NONE);
+      mach_port_deallocate (mach_task_self (), ctlobj);
+    }
+  if (! err)
+    {
+      s->shared = (volatile struct shared_io *) page;
+      if (s->shared->shared_page_magic != SHARED_PAGE_MAGIC)
+	err = EOPNOTSUPP;
+    }
+  if (! err)
+    {
+      err = conch_get (s);
+      if (! err)
+	{
+	  if (! s->shared->seekable || ! s->shared->use_file_size)
+	    err = EOPNOTSUPP;
+	  conch_put (s);
+	}
+    }
+
+  if (err)
+    {
+      if (page)
+	vm_deallocate (mach_task_self (), page, vm_page_size);
+      mach_port_deallocate (mach_task_self (), s->memobj);
+      free (s);
+      return err;
+    }
+
+  *sio = s;
+  return 0;
+}
+
+void
+sharedio_destroy (struct sharedio *sio)
+{
+  volatile struct shared_io *sh = sio->shared;
+  int held;
+
+  pthread_spin_lock (SHARED_LOCK (sh));
+  held = sh->conch_status != USER_HAS_NOT_CONCH;
+  pthread_spin_unlock (SHARED_LOCK (sh));
+  if (held)
+    io_release_conch (sio->io);
+
+  if (sio->data)
+    vm_deallocate (mach_task_self (), (vm_address_t) sio->data, sio->size);
+  vm_deallocate (mach_task_self (), (vm_address_t) sh, vm_page_size);
+  mach_port_deallocate (mach_task_self (), sio->memobj);
+  free (sio);
+}
+
+error_t
+sharedio_read (struct sharedio *sio, void *buf, size_t *len)
+{
+  volatile struct shared_io *sh = sio->shared;
+  off_t pos, size;
+  size_t done, avail;
+  error_t err;
+
+  err = conch_get (sio);
+  if (err)
+    return err;
+
+  pos = sh->xx_file_pointer;
+  size = sh->file_size;
+  if (pos >= size)
+    *len = 0;
+  else if (*len > size - pos)
+    *len = size - pos;
+
+  for (done = 0; done < *len; done += avail)
+    {
+      err = cover (sio, pos + done, &avail);
+      if (err)
+	break;
+      if (avail > *len - done)
+	avail = *len - done;
+      memcpy (buf + done, sio->data + (pos + done - sio->offset), avail);
+    }
+
+  if (done > 0)
+    {
+      /* Like read, report what we got, and the error next time.  */
+      err = 0;
+      *len = done;
+      sh->xx_file_pointer = pos + done;
+      sh->accessed = 1;
+    }
+
+  conch_put (sio);
+  return err;
+}
+
+error_t
+sharedio_write (struct sharedio *sio, const void *buf, size_t len)
+{
+  volatile struct shared_io *sh = sio->shared;
+  off_t pos, end;
+  size_t done, avail;
+  error_t err;
+
+  if (! (sio->prot & VM_PROT_WRITE))
+    return EBADF;
+  if (len == 0)
+    return 0;
+
+  err = conch_get (sio);
+  if (err)
+    return err;
+
+  pos = sh->append_mode ? sh->file_size : sh->xx_file_pointer;
+  end = pos + len;
+
+  /* The server allocates space only when asked to; it tells us how
+     much we may write without asking.  */
+  if (sh->use_prenotify_size && end > sh->prenotify_size)
+    err = io_prenotify (sio->io, pos, end);
+
+  for (done = 0; ! err && done < len; done += avail)
+    {
+      err = cover (sio, pos + done, &avail);
+      if (err)
+	break;
+      if (avail > len - done)
+	avail = len - done;
+      memcpy (sio->data + (pos + done - sio->offset), buf + done, avail);
+    }
+
+  if (done > 0)
+    {
+      end = pos + done;
+      sh->xx_file_pointer = end;
+      if (end > sh->file_size)
+	sh->file_size = end;
+      sh->written = 1;
+    }
+
+  conch_put (sio);
+  return err;
+}
+
+error_t
+sharedio_seek (struct sharedio *sio, off_t offset, int whence, off_t *newp)
+{
+  volatile struct shared_io *sh = sio->shared;
+  off_t base;
+  error_t err;
+
+  err = conch_get (sio);
+  if (err)
+    return err;
+
+  switch (whence)
+    {
+    case SEEK_SET:
+      base = 0;
+      break;
+    case SEEK_CUR:
+      base = sh->xx_file_pointer;
+      break;
+    case SEEK_END:
+      base = sh->file_size;
+      break;
+    default:
+      base = -1;
+      break;
+    }
+
+  if (base < 0 || base + offset < 0)
+    err = EINVAL;
+  else
+    *newp = sh->xx_file_pointer = base + offset;
+
+  conch_put (sio);
+  return err;
+}
+
+error_t
+sharedio_size (struct sharedio *sio, off_t *size)
+{
+  error_t err = conch_get (sio);
+  if (err)
+    return err;
+
+  *size = sio->shared->file_size;
+  conch_put (sio);
+  return 0;
+}
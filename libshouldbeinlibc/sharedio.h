@@ -0,0 +1,80 @@
+/* Client side of the shared I/O page protocol
+
+   Copyright (C) 2026 Free Software Foundation, Inc.
+
+   This file is part of the GNU Hurd.
+
+   The GNU Hurd is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation; either version 2, or (at
+   your option) any later version.
+
+   The GNU Hurd is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with the GNU Hurd.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#ifndef __SHAREDIO_H__
+#define __SHAREDIO_H__
+
+#include <mach.h>
+#include <hurd/hurd_types.h>
+#include <hurd/shared.h>
+#include <errno.h>
+
+/* A file being read and written through its memory object, with the
+   file pointer and size kept in the shared page that io_map_cntl
+   returns (see <hurd/shared.h>).  While the server does not want the
+   conch back, reads, writes and seeks are done without any RPC at all;
+   they take an RPC only when the conch has to be fetched again or when
+   a write goes past the space the server has allocated.
+
+   This only works on seekable objects whose data is a single memory
+   object, which is what filesystems give for regular files.  A struct
+   sharedio is not locked; callers using one from several threads must
+   serialize their calls.
+
+   Only a small window of the file is mapped at a time.  If a part of
+   the file cannot be mapped at all, which may happen past 4G on 32-bit
+   machines, the calls return EFBIG; callers should then use io_read
+   and io_write instead, after sharedio_destroy.  */
+struct sharedio
+{
+  io_t io;			/* The file; not owned by us.  */
+  volatile struct shared_io *shared; /* Mapping of the shared page.  */
+  memory_object_t memobj;	/* The file's data.  */
+  vm_prot_t prot;		/* How we may map MEMOBJ.  */
+  char *data;			/* Window onto MEMOBJ, ...  */
+  off_t offset;			/* ... starting at this offset, ...  */
+  vm_size_t size;		/* ... of this many bytes.  */
+};
+
+/* Set up shared I/O on IO, and return it in *SIO.  IO must stay valid
+   until sharedio_destroy is called.  Only one struct sharedio may be
+   made for each port, as the server gives out the shared page only
+   once.  Return EOPNOTSUPP if IO cannot be used this way.  */
+error_t sharedio_create (io_t io, struct sharedio **sio);
+
+/* Give back the conch, if we have it, and free SIO.  */
+void sharedio_destroy (struct sharedio *sio);
+
+/* Read up to *LEN bytes at the file pointer of SIO into BUF, advancing
+   the file pointer, and set *LEN to the amount read (0 at end of file).  */
+error_t sharedio_read (struct sharedio *sio, void *buf, size_t *len);
+
+/* Write the LEN bytes at BUF at the file pointer of SIO, or at the end
+   of the file in append mode, and advance the file pointer.  */
+error_t sharedio_write (struct sharedio *sio, const void *buf, size_t len);
+
+/* Move the file pointer of SIO as lseek does, and return the new file
+   pointer in *NEWP.  */
+error_t sharedio_seek (struct sharedio *sio, off_t offset, int whence,
+		       off_t *newp);
+
+/* Return the size of the file of SIO in *SIZE.  */
+error_t sharedio_size (struct sharedio *sio, off_t *size);
+
+#endif /* __SHAREDIO_H__ */
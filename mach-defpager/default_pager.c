@@ -157,6 +157,24 @@ partition_init(void)
 	all_partitions.n_partitions = 0;
 }
 
+/*
+ * Make SIZE pages the size of PART.  The bits for the pages past that in
+ * the last bitmap word are marked in use, so that the allocator never
+ * hands them out, and the cursors are spread over the new size.
+ */
+static void
+partition_set_size (partition_t part, vm_size_t size)
+{
+	vm_size_t	p;
+	int		c;
+
+	part->total_size = size;
+	for (p = size; p % NB_BM != 0; p++)
+		part->bitmap[p / NB_BM] |= 1U << (p % NB_BM);
+	for (c = 0; c < PART_CURSORS; c++)
+		part->cursor[c] = c * howmany(size, NB_BM) / PART_CURSORS;
+}
+
 static partition_t
 new_partition (const char *name, struct file_direct *fdp,
 	       int check_linux_signature)
@@ -191,7 +209,6 @@ new_partition (const char *name, struct file_direct *fdp,
 	pthread_mutex_init(&part->p_lock, NULL);
 	part->name	= (char*) malloc(n + 1);
 	strcpy(part->name, name);
-	part->total_size = size;
 	part->free	= size;
 	part->id	= id;
 	part->bitmap	= (bm_entry_t *)malloc(bmsize);
@@ -199,6 +216,7 @@ new_partition (const char *name, struct file_direct *fdp,
 	part->file = fdp;
 
 	memset ((char *)part->bitmap, 0, bmsize);
+	partition_set_size(part, size);
 
 	if (check_linux_signature < 0)
 	  {
@@ -363,7 +381,7 @@ new_partition (const char *name, struct file_direct *fdp,
 		  else
 		    {
 		      waste = part->total_size - hdr->last_page;
-		      part->total_size = hdr->last_page;
+		      partition_set_size(part, hdr->last_page);
 		      part->free = part->total_size - 1;
 		    }
 		  for (i = 0; i < hdr->nr_badpages; ++i)
@@ -503,6 +521,11 @@ ddprintf ("choose_partition(%x,%d,%d)\n",size,cur_part,i);
 	return (found) ? (p_index_t)i : P_INDEX_INVALID;
 }
 
+/*
+ * Which of the partitions' cursors this thread allocates from.
+ */
+static __thread unsigned int	alloc_cursor;
+
 /*
  * Allocate a page in a paging partition
  * The partition is returned unlocked.
@@ -514,7 +537,9 @@ pager_alloc_page(p_index_t	pindex,
 	int	bm_e;
 	int	bit;
 	int	limit;
+	int	n;
 	bm_entry_t	*bm;
+	unsigned int	*cursor;
 	partition_t	part;
 	static char	here[] = "%spager_alloc_page";
 
@@ -536,14 +561,23 @@ ddprintf ("pager_alloc_page(%d,%d)\n",pindex,lock_it);
 	    return (NO_BLOCK);
 	}
 
+	/*
+	 * Search from this thread's cursor, wrapping around
+	 */
 	limit = howmany(part->total_size, NB_BM);
-	bm = part->bitmap;
-	for (bm_e = 0; bm_e < limit; bm_e++, bm++)
-	    if (*bm != BM_MASK)
+	cursor = &part->cursor[alloc_cursor % PART_CURSORS];
+	bm_e = *cursor < limit ? *cursor : 0;
+	for (n = 0; n < limit; n++) {
+	    if (part->bitmap[bm_e] != BM_MASK)
 		break;
+	    if (++bm_e == limit)
+		bm_e = 0;
+	}
 
-	if (bm_e == limit)
+	if (n == limit)
 	    panic(here,my_name);
+	bm = &part->bitmap[bm_e];
+	*cursor = bm_e;
 
 	/*
 	 * Find and set the proper bit
@@ -2059,27 +2093,66 @@ mach_port_t default_pager_internal_set;	/* Port set for internal objects. */
 mach_port_t default_pager_external_set;	/* Port set for external objects. */
 mach_port_t default_pager_default_set;	/* Port set for "default" thread. */
 
+/*
+ *	The threads serving one port set.  A pool starts with a few
+ *	threads and grows on demand: when the last idle thread of a
+ *	pool picks up a request, it starts another one, so that requests
+ *	for other objects need not wait behind one doing synchronous I/O.
+ *	Requests for a single object are still serialized by its own
+ *	lock and sequence numbers.  Threads are never retired; the memory
+ *	pressure that needed them tends to come back.
+ */
+struct default_pager_pool {
+	pthread_mutex_t	lock;		/* For starting threads. */
+	boolean_t	internal;	/* Do we handle internal objects? */
+	mach_port_t	pset;		/* Port set served. */
+	unsigned int	max_threads;	/* Never start more than this. */
+	unsigned int	threads;	/* Threads started. */
+	int		idle;		/* Threads waiting for a request. */
+	unsigned int	busy_max;	/* Most requests in service at once. */
+	unsigned int	saturated;	/* Requests finding no idle thread
+					   and none to start. */
+	unsigned long	requests;	/* Requests handled. */
+};
+
 typedef struct default_pager_thread {
 	pthread_t	dpt_thread;	/* Server thread. */
 	vm_offset_t	dpt_buffer;	/* Read buffer. */
-	boolean_t	dpt_internal;	/* Do we handle internal objects? */
+	struct default_pager_pool *dpt_pool; /* Pool we belong to. */
+	unsigned int	dpt_index;	/* Our number in the pool. */
 } default_pager_thread_t;
 
 #if	PARALLEL
 	/* determine number of threads at run time */
 #define DEFAULT_PAGER_INTERNAL_COUNT	(0)
+#define DEFAULT_PAGER_INTERNAL_MAX	(64)
 
 #else	/* PARALLEL */
 #define	DEFAULT_PAGER_INTERNAL_COUNT	(1)
+#define	DEFAULT_PAGER_INTERNAL_MAX	(1)
 #endif	/* PARALLEL */
 
 /* Memory created by default_pager_object_create should mostly be resident. */
 #define DEFAULT_PAGER_EXTERNAL_COUNT	(1)
+#define DEFAULT_PAGER_EXTERNAL_MAX	(16)
 
 unsigned int default_pager_internal_count = DEFAULT_PAGER_INTERNAL_COUNT;
-					/* Number of "internal" threads. */
+					/* Number of "internal" threads
+					   to start with. */
 unsigned int default_pager_external_count = DEFAULT_PAGER_EXTERNAL_COUNT;
-					/* Number of "external" threads. */
+					/* Number of "external" threads
+					   to start with. */
+
+struct default_pager_pool default_pager_internal_pool = {
+	.lock = PTHREAD_MUTEX_INITIALIZER,
+	.internal = TRUE,
+	.max_threads = DEFAULT_PAGER_INTERNAL_MAX,
+};
+struct default_pager_pool default_pager_external_pool = {
+	.lock = PTHREAD_MUTEX_INITIALIZER,
+	.internal = FALSE,
+	.max_threads = DEFAULT_PAGER_EXTERNAL_MAX,
+};
 
 default_pager_t pager_port_alloc(vm_size_t size)
 {
@@ -2802,6 +2875,47 @@ mig_reply_setup (
 #undef OutP
 }
 
+error_t start_default_pager_thread(struct default_pager_pool *pool);
+
+/*
+ * Note that a thread of POOL took on a request,
+ * and start another if it was the last idle one.
+ */
+static void
+pool_enter(struct default_pager_pool *pool)
+{
+	int idle;
+	unsigned int busy;
+
+	idle = __atomic_sub_fetch(&pool->idle, 1, __ATOMIC_RELAXED);
+	busy = __atomic_load_n(&pool->threads, __ATOMIC_RELAXED) - idle;
+	if (busy > __atomic_load_n(&pool->busy_max, __ATOMIC_RELAXED))
+		__atomic_store_n(&pool->busy_max, busy, __ATOMIC_RELAXED);
+	__atomic_add_fetch(&pool->requests, 1, __ATOMIC_RELAXED);
+
+	if (idle > 0)
+		return;
+
+	pthread_mutex_lock(&pool->lock);
+	if (__atomic_load_n(&pool->idle, __ATOMIC_RELAXED) > 0)
+		;			/* Someone else beat us to it. */
+	else if (pool->threads >= pool->max_threads
+		 || start_default_pager_thread(pool))
+		/* We are short of memory, most likely: carry on with
+		   the threads we have rather than make it worse.  */
+		pool->saturated++;
+	pthread_mutex_unlock(&pool->lock);
+}
+
+/*
+ * Note that a thread of POOL is done with its request.
+ */
+static void
+pool_leave(struct default_pager_pool *pool)
+{
+	__atomic_add_fetch(&pool->idle, 1, __ATOMIC_RELAXED);
+}
+
 boolean_t
 default_pager_demux_object( mach_msg_header_t	*in,
 	mach_msg_header_t	*out)
@@ -2813,6 +2927,7 @@ default_pager_demux_object( mach_msg_header_t	*in,
 
   int rval = FALSE;
   ddprintf ("DPAGER DEMUX OBJECT <%p>: %d\n", in, in->msgh_id);
+  pool_enter (dpt->dpt_pool);
   mig_reply_setup (in, out);
 
   mig_routine_t routine;
@@ -2826,6 +2941,7 @@ default_pager_demux_object( mach_msg_header_t	*in,
       rval = TRUE;
     }
 
+  pool_leave (dpt->dpt_pool);
   ddprintf ("DPAGER DEMUX OBJECT DONE <%p>: %d\n", in, in->msgh_id);
   return rval;
 }
@@ -2878,8 +2994,8 @@ return rval;
  *	We have 3+ threads.
  *	One receives memory_object_create and
  *	default_pager_object_create requests.
- *	One or more manage internal objects.
- *	One or more manage external objects.
+ *	A pool of one or more manages internal objects.
+ *	A pool of one or more manages external objects.
  */
 
 void
@@ -2914,6 +3030,7 @@ default_pager_thread(void *arg)
 	kern_return_t kr;
 
 	dpt = (default_pager_thread_t *) arg;
+	alloc_cursor = dpt->dpt_index;
 
 	/*
 	 *	Threads handling external objects cannot have
@@ -2923,12 +3040,9 @@ default_pager_thread(void *arg)
 	 *	requests sent to internal objects.
 	 */
 
-	if (dpt->dpt_internal) {
+	if (dpt->dpt_pool->internal)
 		default_pager_thread_privileges();
-		pset = default_pager_internal_set;
-	} else {
-		pset = default_pager_external_set;
-	}
+	pset = dpt->dpt_pool->pset;
 
 	for (;;) {
 		kr = mach_msg_server(default_pager_demux_object,
@@ -2938,32 +3052,58 @@ default_pager_thread(void *arg)
 	}
 }
 
-void
-start_default_pager_thread(boolean_t internal)
+/*
+ *	Every page of the task is wired, stacks included, so server
+ *	threads get a small stack of their own instead of the default
+ *	one.  They need little: the message buffers are small, and
+ *	page data goes through dpt_buffer.
+ */
+#define	DEFAULT_PAGER_STACK_SIZE	(64 * 1024)
+
+/*
+ * Start another thread in POOL, which must be locked.
+ * The new thread counts as idle at once.
+ * On failure, nothing is changed.
+ */
+error_t
+start_default_pager_thread(struct default_pager_pool *pool)
 {
 	default_pager_thread_t *ndpt;
+	pthread_attr_t attr;
 	kern_return_t kr;
 	error_t err;
 
 	ndpt = (default_pager_thread_t *) malloc(sizeof *ndpt);
 	if (ndpt == 0)
-		panic(my_name);
+		return ENOMEM;
 
-	ndpt->dpt_internal = internal;
+	ndpt->dpt_pool = pool;
+	ndpt->dpt_index = pool->threads;
 
 	kr = vm_allocate(default_pager_self, &ndpt->dpt_buffer,
 			 vm_page_size, TRUE);
-	if (kr != KERN_SUCCESS)
-		panic(my_name);
+	if (kr != KERN_SUCCESS) {
+		free(ndpt);
+		return kr;
+	}
+
+	__atomic_add_fetch(&pool->threads, 1, __ATOMIC_RELAXED);
+	__atomic_add_fetch(&pool->idle, 1, __ATOMIC_RELAXED);
 
-	err = pthread_create(&ndpt->dpt_thread, NULL, default_pager_thread,
+	pthread_attr_init(&attr);
+	pthread_attr_setstacksize(&attr, DEFAULT_PAGER_STACK_SIZE);
+	pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+	err = pthread_create(&ndpt->dpt_thread, &attr, default_pager_thread,
 			     ndpt);
-	if (!err)
-		pthread_detach (ndpt->dpt_thread);
-	else {
-		errno = err;
-		perror ("pthread_create");
+	pthread_attr_destroy(&attr);
+	if (err) {
+		__atomic_sub_fetch(&pool->threads, 1, __ATOMIC_RELAXED);
+		__atomic_sub_fetch(&pool->idle, 1, __ATOMIC_RELAXED);
+		vm_deallocate(default_pager_self, ndpt->dpt_buffer,
+			      vm_page_size);
+		free(ndpt);
 	}
+	return err;
 }
 
 void
@@ -3022,6 +3162,14 @@ default_pager_initialize(mach_port_t	host_port)
 		default_pager_internal_count =
 		    (h_info.avail_cpus > 32 ? 32 : h_info.avail_cpus) / 4 + 3;
 	}
+	if (default_pager_internal_pool.max_threads
+	    < default_pager_internal_count)
+		default_pager_internal_pool.max_threads =
+		    default_pager_internal_count;
+	if (default_pager_external_pool.max_threads
+	    < default_pager_external_count)
+		default_pager_external_pool.max_threads =
+		    default_pager_external_count;
 }
 
 /*
@@ -3077,14 +3225,23 @@ default_pager(void)
 
 	/*
 	 *	Now we create the threads that will actually
-	 *	manage objects.
+	 *	manage objects.  More are started as needed.
 	 */
 
+	default_pager_internal_pool.pset = default_pager_internal_set;
+	default_pager_external_pool.pset = default_pager_external_set;
+
+	pthread_mutex_lock(&default_pager_internal_pool.lock);
 	for (i = 0; i < default_pager_internal_count; i++)
-		start_default_pager_thread(TRUE);
+		if (start_default_pager_thread(&default_pager_internal_pool))
+			panic(my_name);
+	pthread_mutex_unlock(&default_pager_internal_pool.lock);
 
+	pthread_mutex_lock(&default_pager_external_pool.lock);
 	for (i = 0; i < default_pager_external_count; i++)
-		start_default_pager_thread(FALSE);
+		if (start_default_pager_thread(&default_pager_external_pool))
+			panic(my_name);
+	pthread_mutex_unlock(&default_pager_external_pool.lock);
 
 	default_pager_default_thread(0); /* Become the default_pager server */
 }
@@ -3149,6 +3306,54 @@ S_default_pager_info (mach_port_t pager,
 	return KERN_SUCCESS;
 }
 
+/*
+ * Fill STATS with the counters of POOL, starting at FIRST.
+ */
+static void
+pool_stats(struct default_pager_pool *pool, vm_size_array_t stats,
+	int first)
+{
+	int idle = __atomic_load_n(&pool->idle, __ATOMIC_RELAXED);
+	unsigned int threads = __atomic_load_n(&pool->threads,
+					       __ATOMIC_RELAXED);
+
+	stats[first + DPS_INTERNAL_THREADS] = threads;
+	stats[first + DPS_INTERNAL_BUSY] = idle < 0 ? threads : threads - idle;
+	stats[first + DPS_INTERNAL_BUSY_MAX] = pool->busy_max;
+	stats[first + DPS_INTERNAL_SATURATED] = pool->saturated;
+	stats[first + DPS_INTERNAL_REQUESTS] = pool->requests;
+}
+
+kern_return_t
+S_default_pager_server_stats (mach_port_t pager,
+			      vm_size_array_t *stats,
+			      mach_msg_type_number_t *statsCnt)
+{
+	kern_return_t	kr;
+	vm_offset_t	addr;
+
+	if (pager != default_pager_default_port)
+		return KERN_INVALID_ARGUMENT;
+
+	if (*statsCnt < DPS_MAX)
+	{
+		kr = vm_allocate(default_pager_self, &addr,
+				 round_page(DPS_MAX * sizeof(**stats)), TRUE);
+		if (kr != KERN_SUCCESS)
+			return KERN_RESOURCE_SHORTAGE;
+		*stats = (vm_size_array_t) addr;
+	}
+	*statsCnt = DPS_MAX;
+
+	pool_stats(&default_pager_internal_pool, *stats, 0);
+	pool_stats(&default_pager_external_pool, *stats,
+		   DPS_EXTERNAL_THREADS - DPS_INTERNAL_THREADS);
+	(*stats)[DPS_SEQNO_WAITS] = default_pager_wait_seqno;
+	(*stats)[DPS_READ_WAITS] = default_pager_wait_read;
+	(*stats)[DPS_WRITE_WAITS] = default_pager_wait_write;
+	return KERN_SUCCESS;
+}
+
 kern_return_t
 S_default_pager_storage_info (mach_port_t pager,
 			      vm_size_array_t *size,
@@ -1,5 +1,5 @@
 /*
-   Copyright (C) 2014 Free Software Foundation, Inc.
+   Copyright (C) 2014, 2026 Free Software Foundation, Inc.
    Written by Justus Winter.
 
    This file is part of the GNU Hurd.
@@ -27,8 +27,13 @@
 static inline struct dstruct * __attribute__ ((unused))
 begin_using_default_pager (mach_port_t port)
 {
-  return (default_pager_t) hurd_ihash_find (&all_pagers.htable,
-                                            (hurd_ihash_key_t) port);
+  default_pager_t ds;
+
+  /* Objects come and go while other threads look them up.  */
+  pthread_mutex_lock (&all_pagers.lock);
+  ds = hurd_ihash_find (&all_pagers.htable, (hurd_ihash_key_t) port);
+  pthread_mutex_unlock (&all_pagers.lock);
+  return ds;
 }
 
 static inline struct dstruct * __attribute__ ((unused))
@@ -71,13 +71,23 @@ typedef unsigned int	bm_entry_t;
  * 'Partition' structure for each paging area.
  * Controls allocation of blocks within paging area.
  */
+/*
+ * Each server thread looks for free blocks from one of several
+ * cursors, spread over the partition, so that threads paging out at
+ * the same time neither rescan the full part of the bitmap nor
+ * interleave their objects' blocks.
+ */
+#define	PART_CURSORS	8
+
 struct part {
-	pthread_mutex_t	p_lock;		/* for bitmap/free */
+	pthread_mutex_t	p_lock;		/* for bitmap/free/cursor */
 	char		*name;		/* name */
 	vm_size_t	total_size;	/* total number of blocks */
 	vm_size_t	free;		/* number of blocks free */
 	unsigned int	id;		/* named lookup */
 	bm_entry_t	*bitmap;	/* allocation map */
+	unsigned int	cursor[PART_CURSORS];
+					/* bitmap entries to search from */
 	boolean_t	going_away;	/* destroy attempt in progress */
 	struct file_direct *file;	/* file paged to */
 };
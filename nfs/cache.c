@@ -84,6 +84,10 @@ lookup_fhandle (struct fhandle *handle, struct node **npp)
   nn->dtrans = NOT_POSSIBLE;
   nn->dead_dir = 0;
   nn->dead_name = 0;
+  nn->wb_inflight = 0;
+  nn->wb_start = nn->wb_extent = 0;
+  nn->wb_error = 0;
+  pthread_cond_init (&nn->wb_wakeup, NULL);
   
   hurd_ihash_add (&nodehash, (hurd_ihash_key_t) &nn->handle, np);
   netfs_nref_light (np);
@@ -56,12 +56,18 @@ extern char *localhost (void);
 /* Default number of seconds to timeout cache negative dir hits. */
 #define DEFAULT_NAME_CACHE_NEG_TIMEOUT 3
 
+/* Default maximum number of dir cache entries. */
+#define DEFAULT_NAME_CACHE_SIZE 1024
+
 /* Default maximum number of bytes to read at once. */
 #define DEFAULT_READ_SIZE     8192
 
 /* Default maximum number of bytes to write at once. */
 #define DEFAULT_WRITE_SIZE    8192
 
+/* Default number of writes per file to have in flight at once. */
+#define DEFAULT_WRITE_BEHIND  0
+
 
 /* Number of seconds to timeout cached stat information. */
 int stat_timeout = DEFAULT_STAT_TIMEOUT;
@@ -75,6 +81,9 @@ int name_cache_timeout = DEFAULT_NAME_CACHE_TIMEOUT;
 /* Number of seconds to timeout cached negative dir hits. */
 int name_cache_neg_timeout = DEFAULT_NAME_CACHE_NEG_TIMEOUT;
 
+/* Maximum number of dir cache entries. */
+int name_cache_size = DEFAULT_NAME_CACHE_SIZE;
+
 /* Number of seconds to wait for first retransmission of an RPC. */
 int initial_transmit_timeout = 1;
 
@@ -92,6 +101,9 @@ int read_size = DEFAULT_READ_SIZE;
 
 /* Maximum number of bytes to write at once. */
 int write_size = DEFAULT_WRITE_SIZE;
+
+/* Number of writes per file to have in flight at once. */
+int write_behind = DEFAULT_WRITE_BEHIND;
 
 #define OPT_SOFT	's'
 #define OPT_HARD	'h'
@@ -111,6 +123,8 @@ int write_size = DEFAULT_WRITE_SIZE;
 #define OPT_PMAP_PORT	-13
 #define OPT_NCACHE_TO	-14
 #define OPT_NCACHE_NEG_TO -15
+#define OPT_NCACHE_SIZE	-16
+#define OPT_WBEHIND	-17
 
 /* Return a string corresponding to the printed rep of DEFAULT_what */
 #define ___D(what) #what
@@ -136,6 +150,13 @@ static const struct argp_option common_options[] =
   {"write-size",	    OPT_WSIZE,	   "BYTES", 0,
      "Max packet size for writes (default " _D(WRITE_SIZE)")"},
   {"wsize",0,0,OPTION_ALIAS},
+  {"write-behind",	    OPT_WBEHIND,   "WRITES", 0,
+     "Max number of writes per file to send without waiting for the"
+     " server, 0 to write synchronously (default " _D(WRITE_BEHIND) ");"
+     " errors are then only reported by later writes and syncs"},
+  {"name-cache-size",	    OPT_NCACHE_SIZE, "ENTRIES", 0,
+     "Max number of directory cache entries, 0 to disable the cache"
+     " (default " _D(NAME_CACHE_SIZE) ")"},
 
   {0,0,0,0,"Timeouts:",3},
   {"stat-timeout",	    OPT_STAT_TO,   "SEC", 0,
@@ -170,6 +191,7 @@ parse_common_opt (int key, char *arg, struct argp_state *state)
 
     case OPT_RSIZE: read_size = atoi (arg); break;
     case OPT_WSIZE: write_size = atoi (arg); break;
+    case OPT_WBEHIND: write_behind = atoi (arg); break;
 
     case OPT_STAT_TO: stat_timeout = atoi (arg); break;
     case OPT_CACHE_TO: cache_timeout = atoi (arg); break;
@@ -177,6 +199,7 @@ parse_common_opt (int key, char *arg, struct argp_state *state)
     case OPT_MAX_TR_TO: max_transmit_timeout = atoi (arg); break;
     case OPT_NCACHE_TO: name_cache_timeout = atoi (arg); break;
     case OPT_NCACHE_NEG_TO: name_cache_neg_timeout = atoi (arg); break;
+    case OPT_NCACHE_SIZE: name_cache_size = atoi (arg); break;
 
     default:
       return ARGP_ERR_UNKNOWN;
@@ -247,6 +270,8 @@ netfs_append_args (char **argz, size_t *argz_len)
 
   FOPT ("--read-size=%d", read_size);
   FOPT ("--write-size=%d", write_size);
+  FOPT ("--write-behind=%d", write_behind);
+  FOPT ("--name-cache-size=%d", name_cache_size);
 
   FOPT ("--stat-timeout=%d", stat_timeout);
   FOPT ("--cache-timeout=%d", cache_timeout);
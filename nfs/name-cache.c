@@ -1,6 +1,6 @@
 /* Directory name lookup caching
 
-   Copyright (C) 1996, 1997 Free Software Foundation, Inc.
+   Copyright (C) 1996, 1997, 2026 Free Software Foundation, Inc.
    Written by Thomas Bushnell, n/BSG, & Miles Bader.
 
    This file is part of the GNU Hurd.
@@ -21,47 +21,77 @@
 
 #include "nfs.h"
 #include <string.h>
-#include <cacheq.h>
+#include <stdlib.h>
 
-
-/* Maximum number of names to cache at any given time */
-#define MAXCACHE 200
-
-/* Maximum length of file name we bother caching */
-#define CACHE_NAME_LEN 100
+/* The key of a cache entry: the name NAME, of length NAME_LEN, in the
+   directory whose file handle is DIR, of length DIR_LEN.  */
+struct lookup_key
+{
+  const char *dir;
+  size_t dir_len;
+  const char *name;
+  size_t name_len;
+};
 
 /* Cache entry */
 struct lookup_cache
 {
-  struct cacheq_hdr hdr;
+  /* Links in the LRU list, most recently used first.  */
+  struct lookup_cache *next, *prev;
+
+  /* Our slot in LOOKUP_HASH.  */
+  hurd_ihash_locp_t slot;
+
+  /* The key we are hashed under; it points into DIR_CACHE_FH and
+     NAME.  */
+  struct lookup_key key;
 
-  /* File handles and lengths for cache entries.  0 for NODE_CACHE_LEN
-     means a  */
+  /* File handle of the directory.  */
   char dir_cache_fh[NFS3_FHSIZE];
-  size_t dir_cache_len;
 
   /* Zero means a `negative' entry -- recording that there's
      definitely no node with this name.  */
   struct node *np;
 
-  /* Name of the node NODE_CACHE_ID in the directory DIR_CACHE_ID.  Entries
-     with names too long to fit in this buffer aren't cached at all.  */
-  char name[CACHE_NAME_LEN];
-
-  /* Strlen of NAME.  If this is zero, it's an unused entry. */
-  size_t name_len;
-
   /* Time that this cache entry was created.  */
   time_t cache_stamp;
 
-  /* XXX */
-  int stati;
+  /* Name of the node NP in the directory, NUL terminated.  */
+  char name[0];
 };
 
-/* The contents of the cache in no particular order */
-static struct cacheq lookup_cache = { sizeof (struct lookup_cache) };
+/* Compute and return a hash key for a struct lookup_key.  */
+static hurd_ihash_key_t
+lookup_hash (const void *data)
+{
+  const struct lookup_key *key = data;
+  return (hurd_ihash_key_t)
+    hurd_ihash_hash32 (key->name, key->name_len,
+		       hurd_ihash_hash32 (key->dir, key->dir_len, 0));
+}
 
-static pthread_spinlock_t cache_lock = PTHREAD_SPINLOCK_INITIALIZER;
+/* Compare two struct lookup_keys.  */
+static int
+lookup_compare (const void *key1, const void *key2)
+{
+  const struct lookup_key *k1 = key1, *k2 = key2;
+
+  return k1->name_len == k2->name_len
+    && k1->dir_len == k2->dir_len
+    && memcmp (k1->name, k2->name, k1->name_len) == 0
+    && memcmp (k1->dir, k2->dir, k1->dir_len) == 0;
+}
+
+/* All entries, indexed by directory and name.  */
+static struct hurd_ihash lookup_hash_table =
+  HURD_IHASH_INITIALIZER_GKI (offsetof (struct lookup_cache, slot),
+			      NULL, NULL, lookup_hash, lookup_compare);
+
+/* The entries in LOOKUP_HASH_TABLE, most recently used first.  */
+static struct lookup_cache *lookup_mru, *lookup_lru;
+
+/* Protects all of the above.  */
+static pthread_mutex_t cache_lock = PTHREAD_MUTEX_INITIALIZER;
 
 /* Buffer to hold statistics */
 static struct stats
@@ -69,40 +99,61 @@ static struct stats
   long pos_hits;
   long neg_hits;
   long miss;
-  long fetch_errors;
 } statistics;
 
-#define PARTIAL_THRESH 100
-#define NPARTIALS (MAXCACHE / PARTIAL_THRESH)
-struct stats partial_stats [NPARTIALS];
 
-
+/* Unlink C from the LRU list.  CACHE_LOCK must be held.  */
+static void
+lru_unlink (struct lookup_cache *c)
+{
+  if (c->prev)
+    c->prev->next = c->next;
+  else
+    lookup_mru = c->next;
+  if (c->next)
+    c->next->prev = c->prev;
+  else
+    lookup_lru = c->prev;
+}
+
+/* Make C the most recently used entry.  CACHE_LOCK must be held.  */
+static void
+lru_make_mru (struct lookup_cache *c)
+{
+  if (c == lookup_mru)
+    return;
+
+  lru_unlink (c);
+  c->prev = 0;
+  c->next = lookup_mru;
+  if (lookup_mru)
+    lookup_mru->prev = c;
+  else
+    lookup_lru = c;
+  lookup_mru = c;
+}
+
+/* Remove C from the cache and free it.  CACHE_LOCK must be held.  */
+static void
+remove_cache (struct lookup_cache *c)
+{
+  hurd_ihash_locp_remove (&lookup_hash_table, c->slot);
+  lru_unlink (c);
+  if (c->np)
+    netfs_nrele (c->np);
+  free (c);
+}
+
 /* If there's an entry for NAME, of length NAME_LEN, in directory DIR in the
    cache, return its entry, otherwise 0.  CACHE_LOCK must be held.  */
 static struct lookup_cache *
-find_cache (char *dir, size_t len, const char *name, size_t name_len)
+find_cache (const char *dir, size_t len, const char *name, size_t name_len)
 {
-  struct lookup_cache *c;
-  int i;
-
-  /* Search the list.  All unused entries are contiguous at the end of the
-     list, so we can stop searching when we see the first one.  */
-  for (i = 0, c = lookup_cache.mru; 
-       c && c->name_len; 
-       c = c->hdr.next, i++)
-    if (c->name_len == name_len
-	&& c->dir_cache_len == len
-	&& c->name[0] == name[0] 
-	&& memcmp (c->dir_cache_fh, dir, len) == 0
-	&& strcmp (c->name, name) == 0)
-      {
-	c->stati = i / PARTIAL_THRESH;
-	return c;
-      }
-  
-  return 0;
+  struct lookup_key key = { dir, len, name, name_len };
+
+  return hurd_ihash_find (&lookup_hash_table, (hurd_ihash_key_t) &key);
 }
-
+
 /* Node NP has just been found in DIR with NAME.  If NP is null, this
    name has been confirmed as absent in the directory.  DIR is the
    fhandle of the directory and LEN is its length.  */
@@ -111,66 +162,79 @@ enter_lookup_cache (char *dir, size_t len, struct node *np, const char *name)
 {
   struct lookup_cache *c;
   size_t name_len = strlen (name);
-  
-  if (name_len > CACHE_NAME_LEN - 1)
-    return;
 
-  pthread_spin_lock (&cache_lock);
+  pthread_mutex_lock (&cache_lock);
+
+  /* See if there's an old entry for NAME in DIR.  If not, make a new
+     one, making room for it first.  */
+  c = find_cache (dir, len, name, name_len);
+  if (! c)
+    {
+      if (name_cache_size <= 0)
+	{
+	  pthread_mutex_unlock (&cache_lock);
+	  return;
+	}
+
+      while (lookup_lru && lookup_hash_table.nr_items >= name_cache_size)
+	remove_cache (lookup_lru);
+
+      c = malloc (sizeof *c + name_len + 1);
+      if (! c)
+	{
+	  pthread_mutex_unlock (&cache_lock);
+	  return;
+	}
+
+      memcpy (c->dir_cache_fh, dir, len);
+      memcpy (c->name, name, name_len + 1);
+      c->key.dir = c->dir_cache_fh;
+      c->key.dir_len = len;
+      c->key.name = c->name;
+      c->key.name_len = name_len;
+      c->np = 0;
 
-  if (lookup_cache.length == 0)
-    /* There should always be an lru_cache; this being zero means that the
-       cache hasn't been initialized yet.  Do so.  */
-    cacheq_set_length (&lookup_cache, MAXCACHE);
+      if (hurd_ihash_add (&lookup_hash_table, (hurd_ihash_key_t) &c->key, c))
+	{
+	  free (c);
+	  pthread_mutex_unlock (&cache_lock);
+	  return;
+	}
 
-  /* See if there's an old entry for NAME in DIR.  If not, replace the least
-     recently used entry.  */
-  c = find_cache (dir, len, name, name_len) ?: lookup_cache.lru;
+      c->prev = 0;
+      c->next = lookup_mru;
+      if (lookup_mru)
+	lookup_mru->prev = c;
+      else
+	lookup_lru = c;
+      lookup_mru = c;
+    }
+  else
+    /* Now C becomes the MRU entry!  */
+    lru_make_mru (c);
 
   /* Fill C with the new entry.  */
-  memcpy (c->dir_cache_fh, dir, len);
-  c->dir_cache_len = len;
   if (c->np)
     netfs_nrele (c->np);
   c->np = np;
   if (c->np)
     netfs_nref (c->np);
-  strcpy (c->name, name);
-  c->name_len = name_len;
   c->cache_stamp = mapped_time->seconds;
 
-  /* Now C becomes the MRU entry!  */
-  cacheq_make_mru (&lookup_cache, c);
-
-  pthread_spin_unlock (&cache_lock);
+  pthread_mutex_unlock (&cache_lock);
 }
-
+
 /* Purge all references in the cache to NAME within directory DIR. */
 void
 purge_lookup_cache (struct node *dp, const char *name, size_t namelen)
 {
-  struct lookup_cache *c, *next;
-  
-  pthread_spin_lock (&cache_lock);
-  for (c = lookup_cache.mru; c; c = next)
-    {
-      /* Save C->hdr.next, since we may move C from this position. */
-      next = c->hdr.next;
-
-      if (c->name_len == namelen
-	  && c->dir_cache_len == dp->nn->handle.size
-	  && memcmp (c->dir_cache_fh, dp->nn->handle.data,
-	             c->dir_cache_len) == 0
-	  && strcmp (c->name, name) == 0)
-	{
-	  if (c->np)
-	    netfs_nrele (c->np);
-	  c->name_len = 0;
-	  c->np = 0;
-	  cacheq_make_lru (&lookup_cache, c); /* Use C as the next free
-						 entry. */
-	}
-    }
-  pthread_spin_unlock (&cache_lock);
+  struct lookup_cache *c;
+
+  pthread_mutex_lock (&cache_lock);
+  c = find_cache (dp->nn->handle.data, dp->nn->handle.size, name, namelen);
+  if (c)
+    remove_cache (c);
+  pthread_mutex_unlock (&cache_lock);
 }
 
 /* Purge all references in the cache to node NP. */
@@ -178,66 +242,18 @@ void
 purge_lookup_cache_node (struct node *np)
 {
   struct lookup_cache *c, *next;
-  
-  pthread_spin_lock (&cache_lock);
-  for (c = lookup_cache.mru; c; c = next)
+
+  pthread_mutex_lock (&cache_lock);
+  for (c = lookup_mru; c; c = next)
     {
-      next = c->hdr.next;
-      
+      next = c->next;
       if (c->np == np)
-	{
-	  netfs_nrele (c->np);
-	  c->name_len = 0;
-	  c->np = 0;
-	  cacheq_make_lru (&lookup_cache, c);
-	}
+	remove_cache (c);
     }
-  pthread_spin_unlock (&cache_lock);
+  pthread_mutex_unlock (&cache_lock);
 }
 
 
-
-/* Register a negative hit for an entry in the Nth stat class */
-void
-register_neg_hit (int n)
-{
-  int i;
-
-  statistics.neg_hits++;
-
-  for (i = 0; i < n; i++)
-    partial_stats[i].miss++;
-  for (; i < NPARTIALS; i++)
-    partial_stats[i].neg_hits++;
-}
-
-/* Register a positive hit for an entry in the Nth stat class */
-void
-register_pos_hit (int n)
-{
-  int i;
-
-  statistics.pos_hits++;
-
-  for (i = 0; i < n; i++)
-    partial_stats[i].miss++;
-  for (; i < NPARTIALS; i++)
-    partial_stats[i].pos_hits++;
-}
-  
-/* Register a miss */
-void
-register_miss (void)
-{
-  int i;
-  
-  statistics.miss++;
-  for (i = 0; i < NPARTIALS; i++)
-    partial_stats[i].miss++;
-}
-
-
-
 /* Scan the cache looking for NAME inside DIR.  If we know nothing
    about the entry, then return 0.  If the entry is confirmed to not
    exist, then return -1.  Otherwise, return NP for the entry, with
@@ -248,58 +264,54 @@ struct node *
 check_lookup_cache (struct node *dir, const char *name)
 {
   struct lookup_cache *c;
-  
-  pthread_spin_lock (&cache_lock);
+
+  pthread_mutex_lock (&cache_lock);
 
   c = find_cache (dir->nn->handle.data, dir->nn->handle.size,
 		  name, strlen (name));
   if (c)
     {
       int timeout = c->np
-	? name_cache_timeout 
+	? name_cache_timeout
 	: name_cache_neg_timeout;
 
       /* Make sure the entry is still usable; if not, zap it now. */
       if (mapped_time->seconds - c->cache_stamp >= timeout)
 	{
-	  register_neg_hit (c->stati);
-	  if (c->np)
-	    netfs_nrele (c->np);
-	  c->name_len = 0;
-	  c->np = 0;
-	  cacheq_make_lru (&lookup_cache, c);
-	  pthread_spin_unlock (&cache_lock);
+	  statistics.miss++;
+	  remove_cache (c);
+	  pthread_mutex_unlock (&cache_lock);
 	  return 0;
 	}
 
-      cacheq_make_mru (&lookup_cache, c); /* Record C as recently used.  */
+      lru_make_mru (c);		/* Record C as recently used.  */
 
       if (c->np == 0)
 	/* A negative cache entry.  */
 	{
-	  register_neg_hit (c->stati);
-	  pthread_spin_unlock (&cache_lock);
+	  statistics.neg_hits++;
+	  pthread_mutex_unlock (&cache_lock);
 	  pthread_mutex_unlock (&dir->lock);
 	  return (struct node *)-1;
 	}
-      else 
+      else
 	{
 	  struct node *np;
-	  
+
 	  np = c->np;
 	  netfs_nref (np);
-	  register_pos_hit (c->stati);
-	  pthread_spin_unlock (&cache_lock);
-	  
+	  statistics.pos_hits++;
+	  pthread_mutex_unlock (&cache_lock);
+
 	  pthread_mutex_unlock (&dir->lock);
 	  pthread_mutex_lock (&np->lock);
 
 	  return np;
 	}
     }
-  
-  register_miss ();
-  pthread_spin_unlock (&cache_lock);
+
+  statistics.miss++;
+  pthread_mutex_unlock (&cache_lock);
 
   return 0;
 }
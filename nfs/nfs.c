@@ -167,11 +167,33 @@ xdr_encode_data (int *p, const char *data, size_t len)
 int *
 xdr_encode_64bit (int *p, long long n)
 {
-  *(p++) = htonl (n & 0xffffffff00000000LL >> 32);
+  *(p++) = htonl ((n >> 32) & 0xffffffff);
   *(p++) = htonl (n & 0xffffffff);
   return p;
 }
 
+/* Encode the arguments of a WRITE of LEN bytes of DATA at OFFSET into
+   the file NP; STABLE is the stable_how to ask for with NFSv3.  */
+int *
+xdr_encode_write_args (int *p, struct node *np, off_t offset,
+		       const void *data, size_t len, int stable)
+{
+  p = xdr_encode_fhandle (p, &np->nn->handle);
+  if (protocol_version == 2)
+    {
+      *(p++) = 0;		/* beginoffset, unused */
+      *(p++) = htonl (offset);
+      *(p++) = 0;		/* totalcount, unused */
+    }
+  else
+    {
+      p = xdr_encode_64bit (p, offset);
+      *(p++) = htonl (len);
+      *(p++) = htonl (stable);
+    }
+  return xdr_encode_data (p, data, len);
+}
+
 /* Encode a C string.  */
 int *
 xdr_encode_string (int *p, const char *string)
@@ -71,6 +71,15 @@ struct netnode
 
   struct user_pager_info *fileinfo;
 
+  /* Write-behind state, see write-behind.c.  WB_INFLIGHT counts the
+     writes queued or being sent, which cover the bytes from WB_START
+     to WB_EXTENT, and WB_ERROR is the first error any write got, for
+     the next write or sync to return.  */
+  int wb_inflight;
+  off_t wb_start, wb_extent;
+  error_t wb_error;
+  pthread_cond_t wb_wakeup;
+
   /* If this node has been renamed by "deletion" then
      this is the directory and the name in that directory
      which is holding the node */
@@ -101,6 +110,9 @@ extern int name_cache_timeout;
 /* How long to keep around negative dir cache entries */
 extern int name_cache_neg_timeout;
 
+/* How many dir cache entries to keep at most */
+extern int name_cache_size;
+
 /* How long to wait for replies before re-sending RPC's. */
 extern int initial_transmit_timeout;
 extern int max_transmit_timeout;
@@ -117,6 +129,10 @@ extern int read_size;
 /* Maximum amout to write at once */
 extern int write_size;
 
+/* How many writes per file to have in flight at once; 0 means to wait
+   for each write to complete */
+extern int write_behind;
+
 /* Service name for portmapper */
 extern char *pmap_service_name;
 
@@ -164,6 +180,9 @@ extern int protocol_version;
 int hurd_mode_to_nfs_type (mode_t);
 int *xdr_encode_fhandle (int *, const struct fhandle *);
 int *xdr_encode_data (int *, const char *, size_t);
+int *xdr_encode_64bit (int *, long long);
+int *xdr_encode_write_args (int *, struct node *, off_t, const void *,
+			    size_t, int);
 int *xdr_encode_string (int *, const char *);
 int *xdr_encode_sattr_mode (int *, mode_t);
 int *xdr_encode_sattr_ids (int *, u_int, u_int);
@@ -196,6 +215,13 @@ void *rpc_receive_thread (void *);
 void lookup_fhandle (struct fhandle *, struct node **);
 int *recache_handle (int *, struct node *);
 
+/* write-behind.c */
+error_t write_behind_queue (struct iouser *, struct node *, off_t,
+			    size_t *, const void *);
+void write_behind_wait (struct node *);
+error_t write_behind_flush (struct node *, int);
+error_t write_behind_sync_all (int);
+
 /* name-cache.c */
 void enter_lookup_cache (char *, size_t, struct node *, const char *);
 void purge_lookup_cache (struct node *, const char *, size_t);
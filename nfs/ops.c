@@ -75,6 +75,10 @@ register_fresh_stat (struct node *np, int *p)
   np->nn_stat.st_flags = 0;
   np->nn_translated = np->nn_stat.st_mode & S_IFMT;
 
+  /* Writes the server hasn't seen yet may extend the file.  */
+  if (np->nn_stat.st_size < np->nn->wb_extent)
+    np->nn_stat.st_size = np->nn->wb_extent;
+
   return ret;
 }
 
@@ -124,9 +128,9 @@ process_wcc_stat (struct node *np, int *p, int mod)
       if (attrs_exist)
 	{
 	  /* Just skip them for now */
-	  p += 2 * sizeof (int); /* size */
-	  p += 2 * sizeof (int); /* mtime */
-	  p += 2 * sizeof (int); /* atime */
+	  p += 2; /* size */
+	  p += 2; /* mtime */
+	  p += 2; /* ctime */
 	}
 
       /* Now the post_op_attr */
@@ -338,6 +342,11 @@ netfs_attempt_set_size (struct iouser *cred, struct node *np,
   void *rpcbuf;
   error_t err;
 
+  /* Don't let writes behind us land after the size changes.  */
+  err = write_behind_flush (np, 1);
+  if (err)
+    return err;
+
   p = nfs_initialize_rpc (NFSPROC_SETATTR (protocol_version),
 			  cred, 0, &rpcbuf, np, -1);
   if (! p)
@@ -425,8 +434,7 @@ netfs_attempt_statfs (struct iouser *cred, struct node *np,
 error_t
 netfs_attempt_sync (struct iouser *cred, struct node *np, int wait)
 {
-  /* We are already completely synchronous. */
-  return 0;
+  return write_behind_flush (np, wait);
 }
 
 /* Implement the netfs_attempt_syncfs callback as described in
@@ -434,7 +442,7 @@ netfs_attempt_sync (struct iouser *cred, struct node *np, int wait)
 error_t
 netfs_attempt_syncfs (struct iouser *cred, int wait)
 {
-  return 0;
+  return write_behind_sync_all (wait);
 }
 
 /* Implement the netfs_attempt_read callback as described in
@@ -450,6 +458,9 @@ netfs_attempt_read (struct iouser *cred, struct node *np,
   size_t amt, thisamt;
   int eof;
 
+  /* Make sure we read back what was written.  */
+  write_behind_wait (np);
+
   for (amt = *len; amt;)
     {
       thisamt = amt;
@@ -524,6 +535,17 @@ netfs_attempt_write (struct iouser *cred, struct node *np,
   size_t amt, thisamt;
   size_t count;
 
+  if (write_behind > 0)
+    return write_behind_queue (cred, np, offset, len, data);
+
+  /* Report errors from when write-behind was still on.  */
+  err = write_behind_flush (np, 1);
+  if (err)
+    {
+      *len = 0;
+      return err;
+    }
+
   for (amt = *len; amt;)
     {
       thisamt = amt;
@@ -535,15 +557,7 @@ netfs_attempt_write (struct iouser *cred, struct node *np,
       if (! p)
         return errno;
 
-      p = xdr_encode_fhandle (p, &np->nn->handle);
-      if (protocol_version == 2)
-	*(p++) = 0;
-      *(p++) = htonl (offset);
-      if (protocol_version == 2)
-	*(p++) = 0;
-      if (protocol_version == 3)
-	*(p++) = htonl (FILE_SYNC);
-      p = xdr_encode_data (p, data, thisamt);
+      p = xdr_encode_write_args (p, np, offset, data, thisamt, FILE_SYNC);
 
       err = conduct_rpc (&rpcbuf, &p);
       if (!err)
@@ -0,0 +1,347 @@
+/* Write-behind for the NFS client
+   Copyright (C) 2026 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation; either version 2, or (at
+   your option) any later version.
+
+   This program is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA. */
+
+#include "nfs.h"
+
+#include <netinet/in.h>
+#include <string.h>
+#include <stdio.h>
+
+/* netfs_attempt_write queues the data it is given in chunks of at most
+   WRITE_SIZE bytes and returns at once, and a pool of threads sends
+   them to the server.  At most WRITE_BEHIND writes per file are queued
+   or in flight; a write which overlaps one of them waits for them all,
+   so the server always sees overlapping writes in order.
+
+   Errors are returned by the next write or sync of the file, and by
+   the next sync of the whole file system.  libnetfs has no close hook,
+   so an error that happens after the last write to a file is only seen
+   by a program which syncs it; that is why write-behind is off unless
+   asked for.  */
+
+/* Number of threads sending writes.  */
+#define WRITE_BEHIND_THREADS 8
+
+struct write_request
+{
+  struct write_request *next;
+
+  /* The file to write to, of which we hold a reference.  */
+  struct node *np;
+
+  /* The user to write as.  */
+  struct iouser *cred;
+
+  off_t offset;
+  size_t len;
+
+  char data[0];
+};
+
+/* Writes waiting for a thread to send them, oldest first, the number
+   of writes queued or being sent, and the first error any write got
+   since the last sync of the file system.  */
+static struct write_request *queue, **queue_tail = &queue;
+static int queue_busy;
+static error_t queue_error;
+static pthread_mutex_t queue_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t queue_wakeup = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t queue_idle = PTHREAD_COND_INITIALIZER;
+
+static pthread_once_t threads_once = PTHREAD_ONCE_INIT;
+
+
+/* Free REQ; its reference to the node must have been dealt with.  */
+static void
+free_request (struct write_request *req)
+{
+  if (req->cred != (struct iouser *) -1)
+    iohelp_free_iouser (req->cred);
+  free (req);
+}
+
+/* Send the write REQ.  The node REQ->np must be locked; it is unlocked
+   while waiting for the server.  */
+static error_t
+send_write (struct write_request *req)
+{
+  struct node *np = req->np;
+  off_t offset = req->offset;
+  const char *data = req->data;
+  size_t amt = req->len;
+  size_t count;
+  void *rpcbuf;
+  error_t err;
+  int *p;
+
+  while (amt)
+    {
+      p = nfs_initialize_rpc (NFSPROC_WRITE (protocol_version),
+			      req->cred, amt, &rpcbuf, np, -1);
+      if (! p)
+	return errno;
+
+      p = xdr_encode_write_args (p, np, offset, data, amt, FILE_SYNC);
+
+      pthread_mutex_unlock (&np->lock);
+      err = conduct_rpc (&rpcbuf, &p);
+      pthread_mutex_lock (&np->lock);
+
+      if (!err)
+	{
+	  err = nfs_error_trans (ntohl (*p));
+	  p++;
+	  if (!err || protocol_version == 3)
+	    p = process_wcc_stat (np, p, !err);
+	}
+
+      if (!err && protocol_version == 3)
+	{
+	  count = ntohl (*p);
+	  if (count == 0 || count > amt)
+	    err = EIO;
+	}
+      else
+	/* assume it wrote the whole thing */
+	count = amt;
+
+      free (rpcbuf);
+
+      if (err)
+	return err;
+
+      amt -= count;
+      data += count;
+      offset += count;
+    }
+
+  return 0;
+}
+
+/* Remember that node NP, which is locked, got an error ERR from the
+   server behind the user's back.  */
+static void
+record_error (struct node *np, error_t err)
+{
+  if (! err)
+    return;
+
+  if (!np->nn->wb_error)
+    np->nn->wb_error = err;
+
+  pthread_mutex_lock (&queue_lock);
+  if (!queue_error)
+    queue_error = err;
+  pthread_mutex_unlock (&queue_lock);
+}
+
+/* Send queued writes.  */
+static void *
+writer_thread (void *arg)
+{
+  (void) arg;
+
+  for (;;)
+    {
+      struct write_request *req;
+      struct node *np;
+
+      pthread_mutex_lock (&queue_lock);
+      while (! queue)
+	pthread_cond_wait (&queue_wakeup, &queue_lock);
+      req = queue;
+      queue = req->next;
+      if (! queue)
+	queue_tail = &queue;
+      pthread_mutex_unlock (&queue_lock);
+
+      np = req->np;
+      pthread_mutex_lock (&np->lock);
+
+      record_error (np, send_write (req));
+
+      if (--np->nn->wb_inflight == 0)
+	np->nn->wb_start = np->nn->wb_extent = 0;
+
+      pthread_cond_broadcast (&np->nn->wb_wakeup);
+      pthread_mutex_unlock (&np->lock);
+
+      free_request (req);
+      netfs_nrele (np);
+
+      pthread_mutex_lock (&queue_lock);
+      if (--queue_busy == 0)
+	pthread_cond_broadcast (&queue_idle);
+      pthread_mutex_unlock (&queue_lock);
+    }
+
+  return NULL;
+}
+
+static void
+start_threads (void)
+{
+  pthread_t thread;
+  error_t err;
+  int i;
+
+  for (i = 0; i < WRITE_BEHIND_THREADS; i++)
+    {
+      err = pthread_create (&thread, NULL, writer_thread, NULL);
+      if (!err)
+	pthread_detach (thread);
+      else
+	{
+	  errno = err;
+	  perror ("pthread_create");
+	}
+    }
+}
+
+/* Wait until the server has answered all writes to node NP, which is
+   locked.  */
+void
+write_behind_wait (struct node *np)
+{
+  while (np->nn->wb_inflight)
+    pthread_cond_wait (&np->nn->wb_wakeup, &np->lock);
+}
+
+/* Return the first error that happened while writing to node NP,
+   which is locked, behind the user's back.  If WAIT is set, wait for
+   the server to answer all writes to NP first.  */
+error_t
+write_behind_flush (struct node *np, int wait)
+{
+  error_t err;
+
+  if (wait)
+    write_behind_wait (np);
+
+  err = np->nn->wb_error;
+  np->nn->wb_error = 0;
+  return err;
+}
+
+/* Return the first error that happened while writing behind the
+   user's back since the last call.  If WAIT is set, wait for the
+   server to answer all writes first.  */
+error_t
+write_behind_sync_all (int wait)
+{
+  error_t err;
+
+  pthread_mutex_lock (&queue_lock);
+  while (wait && queue_busy)
+    pthread_cond_wait (&queue_idle, &queue_lock);
+  err = queue_error;
+  queue_error = 0;
+  pthread_mutex_unlock (&queue_lock);
+
+  return err;
+}
+
+/* Queue a write of *LEN bytes of DATA at OFFSET into node NP, which is
+   locked, as user CRED, in the manner of netfs_attempt_write.  */
+error_t
+write_behind_queue (struct iouser *cred, struct node *np, off_t offset,
+		    size_t *len, const void *data)
+{
+  size_t amt, thisamt;
+  error_t err;
+
+  err = np->nn->wb_error;
+  if (err)
+    {
+      np->nn->wb_error = 0;
+      *len = 0;
+      return err;
+    }
+
+  pthread_once (&threads_once, start_threads);
+
+  for (amt = *len; amt;)
+    {
+      struct write_request *req;
+
+      thisamt = amt;
+      if (thisamt > write_size)
+	thisamt = write_size;
+
+      /* Make room in the window, and keep overlapping writes in
+	 order.  */
+      while (np->nn->wb_inflight >= write_behind
+	     || (np->nn->wb_inflight
+		 && offset < np->nn->wb_extent
+		 && offset + thisamt > np->nn->wb_start))
+	if (pthread_hurd_cond_wait_np (&np->nn->wb_wakeup, &np->lock))
+	  {
+	    err = EINTR;
+	    break;
+	  }
+
+      if (!err)
+	{
+	  req = malloc (sizeof *req + thisamt);
+	  if (! req)
+	    err = ENOMEM;
+	  else if (cred == (struct iouser *) -1)
+	    req->cred = cred;
+	  else
+	    {
+	      err = iohelp_dup_iouser (&req->cred, cred);
+	      if (err)
+		free (req);
+	    }
+	}
+
+      if (err)
+	{
+	  if (amt == *len)
+	    return err;
+	  *len -= amt;
+	  return 0;
+	}
+
+      req->next = 0;
+      req->np = np;
+      netfs_nref (np);
+      req->offset = offset;
+      req->len = thisamt;
+      memcpy (req->data, data, thisamt);
+
+      if (np->nn->wb_inflight++ == 0 || offset < np->nn->wb_start)
+	np->nn->wb_start = offset;
+      if (offset + thisamt > np->nn->wb_extent)
+	np->nn->wb_extent = offset + thisamt;
+      if (np->nn_stat.st_size < np->nn->wb_extent)
+	np->nn_stat.st_size = np->nn->wb_extent;
+
+      pthread_mutex_lock (&queue_lock);
+      *queue_tail = req;
+      queue_tail = &req->next;
+      queue_busy++;
+      pthread_cond_signal (&queue_wakeup);
+      pthread_mutex_unlock (&queue_lock);
+
+      amt -= thisamt;
+      data += thisamt;
+      offset += thisamt;
+    }
+
+  return 0;
+}
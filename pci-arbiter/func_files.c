@@ -32,6 +32,9 @@
 
 #include "device_map.h"
 
+typedef int (*pci_io_op_t) (struct pci_device *dev, void *data,
+			    pciaddr_t reg, pciaddr_t width, pciaddr_t *bytes);
+
 /* Read or write a block of data from/to the configuration space */
 static error_t
 config_block_op (struct pci_device *dev, off_t offset, size_t * len,
@@ -79,29 +82,141 @@ config_block_op (struct pci_device *dev, off_t offset, size_t * len,
   return 0;
 }
 
-/* Read or write from/to the config file */
+/*
+ * Dwords of the config header that may be served from the shadow copy.
+ *
+ * These only change when written to. The command and status register,
+ * the BIST register and, on bridges, the secondary status register are
+ * updated by the hardware, so they are always read from the device.
+ */
+#define CONFIG_SHADOW_MASK \
+  (~((1U << (0x04 / 4)) | (1U << (0x0c / 4)) | (1U << (0x1c / 4))) \
+   & ((1U << (PCI_CONFIG_SHADOW_SIZE / 4)) - 1))
+
+/*
+ * Read a block of data from the configuration space, using the shadow
+ * copy of the header where possible and filling it in where not.
+ *
+ * `pci_conf_lock' must be held.
+ */
+static error_t
+config_read (struct pcifs_dirent *e, off_t offset, size_t * len, void *data)
+{
+  error_t err;
+  size_t pendent = *len;
+
+  while (pendent > 0 && offset < PCI_CONFIG_SHADOW_SIZE)
+    {
+      int dword = offset / 4;
+      size_t skip = offset % 4;
+      size_t amount = 4 - skip;
+      uint32_t bit = 1U << dword;
+
+      if (amount > pendent)
+	amount = pendent;
+
+      if (!(CONFIG_SHADOW_MASK & bit))
+	{
+	  err = config_block_op (e->device, offset, &amount, data,
+				 pci_device_cfg_read);
+	  if (err)
+	    return err;
+	}
+      else
+	{
+	  if (!(e->config_shadow_valid & bit))
+	    {
+	      err = pci_device_cfg_read_u32 (e->device,
+					     &e->config_shadow[dword],
+					     dword * 4);
+	      if (err)
+		return err;
+	      e->config_shadow_valid |= bit;
+	    }
+
+	  memcpy (data, (char *) &e->config_shadow[dword] + skip, amount);
+	}
+
+      offset += amount;
+      data += amount;
+      pendent -= amount;
+    }
+
+  if (pendent > 0)
+    {
+      err = config_block_op (e->device, offset, &pendent, data,
+			     pci_device_cfg_read);
+      if (err)
+	return err;
+    }
+
+  return 0;
+}
+
+/*
+ * Write a block of data to the configuration space, and invalidate the
+ * part of the shadow copy it covers.
+ *
+ * `pci_conf_lock' must be held.
+ */
+static error_t
+config_write (struct pcifs_dirent *e, off_t offset, size_t * len, void *data)
+{
+  off_t first, last;
+
+  if (offset < PCI_CONFIG_SHADOW_SIZE && *len > 0)
+    {
+      first = offset / 4;
+      last = (offset + *len - 1) / 4;
+      for (; first <= last && first < PCI_CONFIG_SHADOW_SIZE / 4; first++)
+	e->config_shadow_valid &= ~(1U << first);
+    }
+
+  return config_block_op (e->device, offset, len, data,
+			  (pci_io_op_t) pci_device_cfg_write);
+}
+
+/* Read or write from/to the config space of the device of E */
 error_t
-io_config_file (struct pci_device * dev, off_t offset, size_t * len,
-		void *data, pci_io_op_t op)
+io_config (struct pcifs_dirent * e, off_t offset, size_t * len,
+	   void *data, int read)
 {
   error_t err;
 
   /* This should never happen */
-  assert_backtrace (dev != 0);
+  assert_backtrace (e->device != 0);
 
-  /* Don't exceed the config space size */
-  if (offset > PCI_CONFIG_SIZE)
+  if (offset < 0)
     return EINVAL;
-  if ((offset + *len) > PCI_CONFIG_SIZE)
-    *len = PCI_CONFIG_SIZE - offset;
 
+  /*
+   * The server is multi-threaded, incoming rpcs are handled by libnetfs.
+   * A lock is needed for arbitration.
+   */
   pthread_mutex_lock (&fs->pci_conf_lock);
-  err = config_block_op (dev, offset, len, data, op);
+  if (read)
+    err = config_read (e, offset, len, data);
+  else
+    err = config_write (e, offset, len, data);
   pthread_mutex_unlock (&fs->pci_conf_lock);
 
   return err;
 }
 
+/* Read or write from/to the config file */
+error_t
+io_config_file (struct pcifs_dirent * e, off_t offset, size_t * len,
+		void *data, int read)
+{
+  /* Don't exceed the config space size */
+  if (offset > PCI_CONFIG_SIZE)
+    return EINVAL;
+  if ((offset + *len) > PCI_CONFIG_SIZE)
+    *len = PCI_CONFIG_SIZE - offset;
+
+  return io_config (e, offset, len, data, read);
+}
+
 /* Read the mapped ROM */
 error_t
 read_rom_file (struct pcifs_dirent * e, off_t offset, size_t * len,
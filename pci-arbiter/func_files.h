@@ -25,9 +25,6 @@
 #include "pcifs.h"
 #include <pciaccess.h>
 
-typedef int (*pci_io_op_t) (struct pci_device *dev, void *data,
-                 pciaddr_t reg, pciaddr_t width, pciaddr_t *bytes);
-
 /* Config */
 #define FILE_CONFIG_NAME  "config"
 
@@ -37,8 +34,11 @@ typedef int (*pci_io_op_t) (struct pci_device *dev, void *data,
 /* Region */
 #define FILE_REGION_NAME     "region"
 
-error_t io_config_file (struct pci_device * dev, off_t offset, size_t * len,
-			void *data, pci_io_op_t op);
+error_t io_config (struct pcifs_dirent * e, off_t offset, size_t * len,
+		   void *data, int read);
+
+error_t io_config_file (struct pcifs_dirent * e, off_t offset, size_t * len,
+			void *data, int read);
 
 error_t read_rom_file (struct pcifs_dirent * e, off_t offset, size_t * len,
 		       void *data);
@@ -500,9 +500,7 @@ netfs_attempt_read (struct iouser * cred, struct node * node,
 
   if (!strncmp (node->nn->ln->name, FILE_CONFIG_NAME, NAME_SIZE))
     {
-      err =
-        io_config_file (node->nn->ln->device, offset, len, data,
-                        pci_device_cfg_read);
+      err = io_config_file (node->nn->ln, offset, len, data, 1);
       if (!err)
         /* Update atime */
         UPDATE_TIMES (node->nn->ln, TOUCH_ATIME);
@@ -539,9 +537,7 @@ netfs_attempt_write (struct iouser * cred, struct node * node,
 
   if (!strncmp (node->nn->ln->name, FILE_CONFIG_NAME, NAME_SIZE))
     {
-      err =
-        io_config_file (node->nn->ln->device, offset, len, (void*) data,
-                       (pci_io_op_t) pci_device_cfg_write);
+      err = io_config_file (node->nn->ln, offset, len, (void*) data, 0);
       if (!err)
         {
           /* Update mtime and ctime */
@@ -83,9 +83,8 @@ S_pci_conf_read (struct protid * master, int reg, char **data,
 		 mach_msg_type_number_t * datalen, vm_size_t amount)
 {
   error_t err;
-  pthread_mutex_t *lock;
   struct pcifs_dirent *e;
-  pciaddr_t actual_len;
+  size_t len;
 
   if (!master)
     return EOPNOTSUPP;
@@ -95,8 +94,6 @@ S_pci_conf_read (struct protid * master, int reg, char **data,
     /* This operation may only be addressed to the config file */
     return EINVAL;
 
-  lock = &fs->pci_conf_lock;
-
   err = check_permissions (master, O_READ);
   if (err)
     return err;
@@ -108,17 +105,13 @@ S_pci_conf_read (struct protid * master, int reg, char **data,
   if (amount > *datalen)
     amount = *datalen;
 
-  /*
-   * The server is not single-threaded anymore. Incoming rpcs are handled by
-   * libnetfs which is multi-threaded. A lock is needed for arbitration.
-   */
-  pthread_mutex_lock (lock);
-  err = pci_device_cfg_read (e->device, *data, reg, amount, &actual_len);
-  pthread_mutex_unlock (lock);
+  /* The header is served from the shadow copy when possible */
+  len = amount;
+  err = io_config (e, reg, &len, *data, 1);
 
   if (!err)
     {
-      *datalen = (size_t)actual_len;
+      *datalen = len;
       /* Update atime */
       UPDATE_TIMES (e, TOUCH_ATIME);
     }
@@ -132,9 +125,8 @@ S_pci_conf_write (struct protid * master, int reg, const char *data, mach_msg_ty
 		  vm_size_t * amount)
 {
   error_t err;
-  pthread_mutex_t *lock;
   struct pcifs_dirent *e;
-  pciaddr_t actual_len;
+  size_t len;
 
   if (!master)
     return EOPNOTSUPP;
@@ -144,19 +136,16 @@ S_pci_conf_write (struct protid * master, int reg, const char *data, mach_msg_ty
     /* This operation may only be addressed to the config file */
     return EINVAL;
 
-  lock = &fs->pci_conf_lock;
-
   err = check_permissions (master, O_WRITE);
   if (err)
     return err;
 
-  pthread_mutex_lock (lock);
-  err = pci_device_cfg_write (e->device, data, reg, datalen, &actual_len);
-  pthread_mutex_unlock (lock);
+  len = datalen;
+  err = io_config (e, reg, &len, (void *) data, 0);
 
   if (!err)
     {
-      *amount = (size_t)actual_len;
+      *amount = len;
       /* Update mtime and ctime */
       UPDATE_TIMES (e, TOUCH_MTIME | TOUCH_CTIME);
     }
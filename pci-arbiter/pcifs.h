@@ -31,6 +31,9 @@
 // FIXME: Hardcoded PCI config size
 #define PCI_CONFIG_SIZE 256
 
+/* Size of the part of the config space that is shadowed: the header */
+#define PCI_CONFIG_SHADOW_SIZE 64
+
 #include <netfs_impl.h>
 
 /* Size of a directory entry name */
@@ -105,6 +108,15 @@ struct pcifs_dirent
    * Only when a device is present
    */
   void *rom_map;
+
+  /*
+   * Shadow copy of the config space header, one bit per valid dword in
+   * `config_shadow_valid'.
+   *
+   * Only for config files. Protected by `pci_conf_lock'.
+   */
+  uint32_t config_shadow[PCI_CONFIG_SHADOW_SIZE / 4];
+  uint32_t config_shadow_valid;
 };
 
 /*
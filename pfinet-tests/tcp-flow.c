@@ -0,0 +1,275 @@
+/* tcp-flow.c: Check that loopback TCP keeps to flow control
+
+   Copyright (C) 2026 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation; either version 2, or (at
+   your option) any later version.
+
+   This program is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with the GNU Hurd.  If not, see <http://www.gnu.org/licenses/>.  */
+
+/* pfinet hands data on IPv4 loopback connections straight to the peer
+   socket, while IPv6 ones still go through the loopback device.  This
+   runs the same transfers over 127.0.0.1 and ::1 and checks that both
+   behave as TCP should: a writer that is not being read from is stopped
+   by the reader's window, it resumes once the reader catches up, and
+   the byte stream arrives intact.  It exits with status 0 if all checks
+   pass.  */
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <error.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#define RCVBUF		8192
+#define CHUNK		512
+#define STREAM_BYTES	(4 * 1024 * 1024)
+
+static int failures;
+
+static void
+check (int ok, const char *family, const char *what)
+{
+  printf ("%s: %s: %s\n", ok ? "PASS" : "FAIL", family, what);
+  if (! ok)
+    failures++;
+}
+
+/* The byte at offset POS of the stream.  */
+static inline unsigned char
+pattern (size_t pos)
+{
+  return (pos * 7 + pos / 251) & 0xff;
+}
+
+/* Connect a socket of FAMILY to itself through the loopback address,
+   with the accepting end's receive buffer set to RCVBUF.  Return the
+   connecting end in *WR and the accepting end in *RD.  */
+static void
+connect_pair (int family, int *wr, int *rd)
+{
+  struct sockaddr_storage ss;
+  socklen_t len = sizeof ss;
+  int lsock, size = RCVBUF;
+
+  memset (&ss, 0, sizeof ss);
+  if (family == AF_INET)
+    {
+      struct sockaddr_in *sin = (struct sockaddr_in *) &ss;
+      sin->sin_family = AF_INET;
+      sin->sin_addr.s_addr = htonl (INADDR_LOOPBACK);
+    }
+  else
+    {
+      struct sockaddr_in6 *sin6 = (struct sockaddr_in6 *) &ss;
+      sin6->sin6_family = AF_INET6;
+      sin6->sin6_addr = in6addr_loopback;
+    }
+
+  lsock = socket (family, SOCK_STREAM, 0);
+  if (lsock < 0)
+    error (1, errno, "socket");
+  if (setsockopt (lsock, SOL_SOCKET, SO_RCVBUF, &size, sizeof size) < 0)
+    error (1, errno, "SO_RCVBUF");
+  if (bind (lsock, (struct sockaddr *) &ss,
+	    family == AF_INET ? sizeof (struct sockaddr_in)
+	    : sizeof (struct sockaddr_in6)) < 0
+      || listen (lsock, 1) < 0
+      || getsockname (lsock, (struct sockaddr *) &ss, &len) < 0)
+    error (1, errno, "listen");
+
+  *wr = socket (family, SOCK_STREAM, 0);
+  if (*wr < 0 || connect (*wr, (struct sockaddr *) &ss, len) < 0)
+    error (1, errno, "connect");
+  *rd = accept (lsock, NULL, NULL);
+  if (*rd < 0)
+    error (1, errno, "accept");
+  close (lsock);
+}
+
+/* Write CHUNK sized pieces of the stream from *POS on to the
+   non-blocking socket FD until it would block, and return how much was
+   written.  */
+static size_t
+fill (int fd, size_t *pos)
+{
+  unsigned char buf[CHUNK];
+  size_t total = 0;
+  ssize_t n;
+  int i;
+
+  for (;;)
+    {
+      for (i = 0; i < CHUNK; i++)
+	buf[i] = pattern (*pos + i);
+      n = write (fd, buf, CHUNK);
+      if (n < 0)
+	{
+	  if (errno != EAGAIN && errno != EWOULDBLOCK)
+	    error (1, errno, "write");
+	  return total;
+	}
+      *pos += n;
+      total += n;
+    }
+}
+
+/* Read everything there is on the non-blocking socket FD, checking it
+   against the stream from *POS on.  Return how much was read, or -1 if
+   the data was wrong.  */
+static ssize_t
+drain (int fd, size_t *pos)
+{
+  unsigned char buf[CHUNK];
+  ssize_t n, total = 0, i;
+  int bad = 0;
+
+  while ((n = read (fd, buf, sizeof buf)) > 0)
+    {
+      for (i = 0; i < n; i++)
+	if (buf[i] != pattern (*pos + i))
+	  bad = 1;
+      *pos += n;
+      total += n;
+    }
+  if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK)
+    error (1, errno, "read");
+  return bad ? -1 : total;
+}
+
+/* Wait up to five seconds for FD to become writable.  */
+static int
+wait_writable (int fd)
+{
+  struct timeval tv = { 5, 0 };
+  fd_set fds;
+
+  FD_ZERO (&fds);
+  FD_SET (fd, &fds);
+  return select (fd + 1, NULL, &fds, NULL, &tv) == 1;
+}
+
+struct reader
+{
+  int fd;
+  int bad;
+};
+
+static void *
+stream_reader (void *arg)
+{
+  struct reader *r = arg;
+  unsigned char buf[8192];
+  size_t pos = 0;
+  ssize_t n, i;
+
+  while ((n = read (r->fd, buf, sizeof buf)) > 0)
+    {
+      for (i = 0; i < n; i++)
+	if (buf[i] != pattern (pos + i))
+	  r->bad = 1;
+      pos += n;
+    }
+  if (pos != STREAM_BYTES)
+    r->bad = 1;
+  return NULL;
+}
+
+static void
+run (int family, const char *name)
+{
+  size_t wpos = 0, rpos = 0, filled;
+  int wr, rd, queued, rcvbuf;
+  socklen_t len = sizeof rcvbuf;
+  struct reader r;
+  pthread_t thread;
+  ssize_t got;
+
+  connect_pair (family, &wr, &rd);
+  if (getsockopt (rd, SOL_SOCKET, SO_RCVBUF, &rcvbuf, &len) < 0)
+    error (1, errno, "SO_RCVBUF");
+  fcntl (wr, F_SETFL, O_NONBLOCK);
+  fcntl (rd, F_SETFL, O_NONBLOCK);
+
+  /* Nobody reads: the writer must be stopped, with no more than the
+     reader's window queued at the reader.  */
+  filled = fill (wr, &wpos);
+  sleep (1);
+  if (ioctl (rd, FIONREAD, &queued) < 0)
+    error (1, errno, "FIONREAD");
+  printf ("%s: %zu bytes written, %d queued at the reader (rcvbuf %d)\n",
+	  name, filled, queued, rcvbuf);
+  check (filled > 0, name, "writer makes progress");
+  check (queued > 0 && queued <= rcvbuf, name,
+	 "reader holds no more than its window");
+
+  /* The reader catches up: the window must open again.  */
+  got = drain (rd, &rpos);
+  check (got > 0, name, "reader gets the data intact");
+  check (wait_writable (wr) && fill (wr, &wpos) > 0, name,
+	 "writer resumes once the reader has read");
+  while (rpos < wpos)
+    {
+      got = drain (rd, &rpos);
+      if (got < 0)
+	break;
+      if (got == 0)
+	usleep (10000);
+    }
+  check (got >= 0 && rpos == wpos, name, "stream so far is intact");
+  close (wr);
+  close (rd);
+
+  /* A long transfer with a reader that keeps up.  */
+  connect_pair (family, &wr, &rd);
+  r.fd = rd;
+  r.bad = 0;
+  pthread_create (&thread, NULL, stream_reader, &r);
+  for (wpos = 0; wpos < STREAM_BYTES; )
+    {
+      unsigned char buf[CHUNK * 3];
+      size_t i, count = sizeof buf;
+      ssize_t n;
+
+      if (count > STREAM_BYTES - wpos)
+	count = STREAM_BYTES - wpos;
+      for (i = 0; i < count; i++)
+	buf[i] = pattern (wpos + i);
+      n = write (wr, buf, count);
+      if (n < 0)
+	error (1, errno, "write");
+      wpos += n;
+    }
+  shutdown (wr, SHUT_WR);
+  pthread_join (thread, NULL);
+  check (! r.bad, name, "4M stream arrives intact");
+  close (wr);
+  close (rd);
+}
+
+int
+main (void)
+{
+  run (AF_INET, "127.0.0.1 (spliced)");
+  run (AF_INET6, "::1 (loopback device)");
+
+  if (failures)
+    error (1, 0, "%d checks failed", failures);
+  return 0;
+}
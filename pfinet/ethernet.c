@@ -1,5 +1,5 @@
 /*
-   Copyright (C) 1995, 1996, 1998, 1999, 2000, 2002, 2007
+   Copyright (C) 1995, 1996, 1998, 1999, 2000, 2002, 2007, 2026
      Free Software Foundation, Inc.
 
    Written by Michael I. Bushnell, p/BSG.
@@ -34,6 +34,8 @@
 #include <linux/netdevice.h>
 #include <linux/etherdevice.h>
 #include <linux/if_arp.h>
+#include <net/ip.h>
+#include <net/checksum.h>
 
 
 struct port_class *etherreadclass;
@@ -107,6 +109,38 @@ ethernet_thread (void *arg)
   return NULL;
 }
 
+/* Copy the LEN bytes of frame payload at FROM to TO.  If they are an
+   unfragmented IPv4 datagram, sum its payload on the way, as a card
+   doing receive checksum offload would, so that TCP and UDP need not
+   go over the data a second time: return CHECKSUM_HW and store the sum
+   in *CSUM.  Otherwise return CHECKSUM_NONE.  */
+static int
+ethernet_copy_and_csum (char *to, const char *from, int len,
+			unsigned short proto, unsigned int *csum)
+{
+  const struct iphdr *iph = (const struct iphdr *) from;
+  int hlen, tot_len;
+
+  if (proto != htons (ETH_P_IP) || len < sizeof *iph
+      || iph->version != 4 || (iph->frag_off & htons (IP_MF | IP_OFFSET)))
+    goto plain;
+
+  hlen = iph->ihl * 4;
+  tot_len = ntohs (iph->tot_len);
+  if (hlen < sizeof *iph || tot_len < hlen || tot_len > len)
+    goto plain;
+
+  memcpy (to, from, hlen);
+  *csum = csum_partial_copy_nocheck ((char *) from + hlen, to + hlen,
+				     tot_len - hlen, 0);
+  memcpy (to + tot_len, from + tot_len, len - tot_len);
+  return CHECKSUM_HW;
+
+ plain:
+  memcpy (to, from, len);
+  return CHECKSUM_NONE;
+}
+
 int
 ethernet_demuxer (mach_msg_header_t *inp,
 		  mach_msg_header_t *outp)
@@ -160,9 +194,12 @@ ethernet_demuxer (mach_msg_header_t *inp,
 
   /* Copy the two parts of the frame into the buffer. */
   memcpy (skb->data, msg->header, ETH_HLEN);
-  memcpy (skb->data + ETH_HLEN,
-	  msg->packet + sizeof (struct packet_header),
-	  datalen - ETH_HLEN);
+  skb->ip_summed =
+    ethernet_copy_and_csum (skb->data + ETH_HLEN,
+			    msg->packet + sizeof (struct packet_header),
+			    datalen - ETH_HLEN,
+			    ((struct ethhdr *) msg->header)->h_proto,
+			    &skb->csum);
 
   /* Drop it on the queue. */
   skb->protocol = eth_type_trans (skb, dev);
@@ -1,5 +1,5 @@
 /*
-   Copyright (C) 1995,96,97,98,99,2000,02 Free Software Foundation, Inc.
+   Copyright (C) 1995,96,97,98,99,2000,02,26 Free Software Foundation, Inc.
    Written by Michael I. Bushnell, p/BSG.
 
    This file is part of the GNU Hurd.
@@ -27,6 +27,7 @@
 #include <net/sock.h>
 
 #include "io_S.h"
+#include "io_event_S.h"
 #include <netinet/in.h>
 #include <fcntl.h>
 #include <string.h>
@@ -334,6 +335,39 @@ S_io_select_timeout (struct sock_user *user,
   return io_select_common (user, reply, reply_type, &ts, select_type);
 }
 
+/* Return the kinds of i/o SOCK is ready for.  A pending error makes it
+   ready for everything, since the next operation will report it.  */
+int
+sock_select_ready (struct socket *sock)
+{
+  int avail = (*sock->ops->poll) ((void *) 0xdeadbeef,
+				  sock,
+				  (void *) 0xdeadbead);
+  if (avail & POLLERR)
+    avail |= SELECT_READ | SELECT_WRITE | SELECT_URG;
+  return avail & (SELECT_READ | SELECT_WRITE | SELECT_URG);
+}
+
+kern_return_t
+S_io_event_register (struct sock_user *user,
+		     mach_port_t event_port,
+		     vm_address_t cookie,
+		     int select_type)
+{
+  error_t err;
+
+  if (!user)
+    return EOPNOTSUPP;
+
+  pthread_mutex_lock (&global_lock);
+  become_task (user);
+  err = iohelp_register_event (&user->sock->events, event_port, cookie,
+			       select_type, sock_select_ready (user->sock));
+  pthread_mutex_unlock (&global_lock);
+
+  return err;
+}
+
 kern_return_t
 S_io_stat (struct sock_user *user,
 	   struct stat *st)
@@ -89,6 +89,7 @@ struct sk_buff {
 	atomic_t	users;			/* User count - see datagram.c,tcp.c 		*/
 	unsigned short	protocol;		/* Packet protocol from driver. 		*/
 	unsigned short	security;		/* Security level of packet			*/
+	unsigned short	gso_size;		/* Payload of each segment merged into us	*/
 	unsigned int	truesize;		/* Buffer size 					*/
 
 	unsigned char	*head;			/* Head of buffer 				*/
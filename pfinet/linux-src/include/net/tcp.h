@@ -863,6 +863,11 @@ static __inline__ u16 tcp_v4_check(struct tcphdr *th, int len,
 	return csum_tcpudp_magic(saddr,daddr,len,IPPROTO_TCP,base);
 }
 
+#ifdef _HURD_
+extern struct sk_buff *	tcp_v4_gro_receive(struct sk_buff *skb,
+					   struct sk_buff_head *queue);
+#endif
+
 #undef STATE_TRACE
 
 #ifdef STATE_TRACE
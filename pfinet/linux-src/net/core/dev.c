@@ -93,6 +93,9 @@
 #ifdef CONFIG_NET_RADIO
 #include <linux/wireless.h>
 #endif	/* CONFIG_NET_RADIO */
+#ifdef _HURD_
+#include <net/tcp.h>
+#endif
 #ifdef CONFIG_PLIP
 extern int plip_init(void);
 #endif
@@ -922,6 +925,14 @@ void net_bh(void)
 		 *	skb->nh.raw point to the MAC and encapsulated data
 		 */
 
+#ifdef _HURD_
+		/* Merge the TCP segments right behind this one into it.
+		 * Taps want to see the frames as they came.
+		 */
+		if (ptype_all == NULL)
+			skb = tcp_v4_gro_receive(skb, &backlog);
+#endif
+
 		/* XXX until we figure out every place to modify.. */
 		skb->h.raw = skb->nh.raw = skb->data;
 
@@ -191,6 +191,7 @@ static inline void skb_headerinit(void *p, kmem_cache_t *cache,
 	skb->stamp.tv_sec=0;	/* No idea about time */
 	skb->ip_summed = 0;
 	skb->security = 0;	/* By default packets are insecure */
+	skb->gso_size = 0;
 	skb->dst = NULL;
 #ifdef CONFIG_IP_FIREWALL
         skb->fwmark = 0;
@@ -304,6 +305,7 @@ struct sk_buff *skb_copy(struct sk_buff *skb, int gfp_mask)
 	n->stamp=skb->stamp;
 	n->destructor = NULL;
 	n->security=skb->security;
+	n->gso_size=skb->gso_size;
 #ifdef CONFIG_IP_FIREWALL
         n->fwmark = skb->fwmark;
 #endif
@@ -353,6 +355,7 @@ struct sk_buff *skb_realloc_headroom(struct sk_buff *skb, int newheadroom)
 	n->stamp=skb->stamp;
 	n->destructor = NULL;
 	n->security=skb->security;
+	n->gso_size=skb->gso_size;
 #ifdef CONFIG_IP_FIREWALL
         n->fwmark = skb->fwmark;
 #endif
@@ -974,8 +974,14 @@ int sock_no_recvmsg(struct socket *sock, struct msghdr *m, int flags,
 
 void sock_def_wakeup(struct sock *sk)
 {
-	if(!sk->dead)
+	if(!sk->dead) {
 		wake_up_interruptible(sk->sleep);
+#ifdef _HURD_
+		/* Connecting and closing change what the socket is
+		   ready for; post the io_event_register events.  */
+		sock_wake_async(sk->socket, 0);
+#endif
+	}
 }
 
 void sock_def_error_report(struct sock *sk)
@@ -419,6 +419,7 @@
 
 #include <net/icmp.h>
 #include <net/tcp.h>
+#include <net/route.h>
 
 #include <asm/uaccess.h>
 
@@ -761,6 +762,133 @@ static int wait_for_buffer(struct sock *sk)
 	return 0;
 }
 
+#ifdef _HURD_
+
+/*
+ *	Loopback splicing.  When the other end of a connection is a
+ *	socket of this same stack, data need not be segmented,
+ *	checksummed, and fed through the loopback device and net_bh:
+ *	we append it straight to the peer's receive queue, exactly as
+ *	tcp_data_queue would have, and advance the sequence numbers on
+ *	both ends as if it had been sent and acknowledged.  This is only
+ *	done while everything we sent before has been received, so the
+ *	byte stream stays in order; whenever that doesn't hold, or the
+ *	peer has no room, we just take the normal path.
+ *
+ *	Flow control stays as it was: a splice never goes beyond the
+ *	window the peer advertised, and it doesn't move that window's
+ *	right edge, just as an acknowledgement without a window update
+ *	wouldn't.  The peer opens the window again when it reads, with
+ *	the same window update it would otherwise send.
+ */
+
+extern struct sock *tcp_v4_lookup(u32 saddr, u16 sport,
+				  u32 daddr, u16 dport, int dif);
+
+/* Return the local socket at the other end of SK's connection if data
+ * can be handed to it directly right now, or NULL.
+ */
+static struct sock *tcp_splice_peer(struct sock *sk, struct tcp_opt *tp)
+{
+	struct rtable *rt = (struct rtable *) sk->dst_cache;
+	struct sock *peer;
+	struct tcp_opt *ptp;
+
+	if (sk->family != PF_INET || rt == NULL ||
+	    !(rt->rt_flags & RTCF_LOCAL))
+		return NULL;
+
+	/* Everything we sent must have been acknowledged.  */
+	if (tp->send_head || tp->packets_out ||
+	    tp->snd_una != tp->write_seq)
+		return NULL;
+
+	peer = tcp_v4_lookup(sk->saddr, sk->sport, sk->daddr, sk->dport,
+			     rt->u.dst.dev->ifindex);
+	if (peer == NULL || peer == sk ||
+	    !((1 << peer->state) &
+	      (TCPF_ESTABLISHED | TCPF_FIN_WAIT1 | TCPF_FIN_WAIT2)) ||
+	    (peer->shutdown & RCV_SHUTDOWN) || peer->dead ||
+	    atomic_read(&peer->sock_readers))
+		return NULL;
+
+	/* ...and the peer must have received all of it.  */
+	ptp = &(peer->tp_pinfo.af_tcp);
+	if (ptp->rcv_nxt != tp->write_seq ||
+	    skb_queue_len(&ptp->out_of_order_queue))
+		return NULL;
+
+	return peer;
+}
+
+/* Move up to LEN bytes at FROM onto the receive queue of PEER.  Return
+ * the number of bytes moved, which is zero if PEER has no room, or a
+ * negative error.
+ */
+static int tcp_splice(struct sock *sk, struct sock *peer,
+		      unsigned char *from, int len)
+{
+	struct tcp_opt *tp = &(sk->tp_pinfo.af_tcp);
+	struct tcp_opt *ptp = &(peer->tp_pinfo.af_tcp);
+	int headroom = MAX_HEADER + sk->prot->max_header;
+	struct sk_buff *skb;
+	struct tcphdr *th;
+	int room;
+	u32 win;
+
+	room = peer->rcvbuf - atomic_read(&peer->rmem_alloc)
+		- headroom - sizeof(struct sk_buff);
+	win = min(tp->snd_wnd, tcp_receive_window(ptp));
+	if (room > (int) win)
+		room = win;
+	if (len > room)
+		len = room;
+	if (len <= 0)
+		return 0;
+
+	skb = alloc_skb(headroom + len, GFP_KERNEL);
+	if (skb == NULL)
+		return 0;
+	skb_reserve(skb, headroom);
+	if (copy_from_user(skb_put(skb, len), from, len)) {
+		kfree_skb(skb);
+		return -EFAULT;
+	}
+
+	/* tcp_recvmsg and tcp_readable look at the header.  */
+	th = (struct tcphdr *) skb_push(skb, sizeof(struct tcphdr));
+	memset(th, 0, sizeof(struct tcphdr));
+	th->source = sk->sport;
+	th->dest = sk->dport;
+	th->seq = htonl(tp->write_seq);
+	th->ack_seq = htonl(tp->rcv_nxt);
+	th->doff = sizeof(struct tcphdr) >> 2;
+	th->ack = 1;
+	skb->h.th = th;
+	__skb_pull(skb, sizeof(struct tcphdr));
+
+	TCP_SKB_CB(skb)->seq = tp->write_seq;
+	TCP_SKB_CB(skb)->end_seq = tp->write_seq + len;
+
+	skb_set_owner_r(skb, peer);
+	__skb_queue_tail(&peer->receive_queue, skb);
+
+	/* Move the sequence numbers along, so that segments sent the
+	 * normal way later on are still in sequence.  The right edge of
+	 * the window stays put on both ends, so what we have just used
+	 * of it is gone until the peer reads and updates it.
+	 */
+	ptp->rcv_nxt = TCP_SKB_CB(skb)->end_seq;
+	ptp->rcv_tstamp = tcp_time_stamp;
+	tp->write_seq = tp->snd_nxt = tp->snd_una = ptp->rcv_nxt;
+	tp->snd_wnd -= len;
+
+	peer->data_ready(peer, 0);
+	return len;
+}
+
+#endif /* _HURD_ */
+
 /* When all user supplied data has been queued set the PSH bit */
 #define PSH_NEEDED (seglen == 0 && iovlen == 0)
 
@@ -893,6 +1021,24 @@ int tcp_do_sendmsg(struct sock *sk, struct msghdr *msg)
 				}
 			}
 
+#ifdef _HURD_
+			if (!(flags & MSG_OOB)) {
+				struct sock *peer = tcp_splice_peer(sk, tp);
+
+				if (peer) {
+					copy = tcp_splice(sk, peer, from, seglen);
+					if (copy < 0)
+						goto do_fault2;
+					if (copy > 0) {
+						from += copy;
+						copied += copy;
+						seglen -= copy;
+						continue;
+					}
+				}
+			}
+#endif
+
 			/* We also need to worry about the window.  If
 			 * window < 1/2 the maximum window we've seen
 			 * from this host, don't use it.  This is
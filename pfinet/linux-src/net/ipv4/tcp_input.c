@@ -1580,6 +1580,10 @@ static __inline__ void tcp_measure_rcv_mss(struct sock *sk, struct sk_buff *skb)
 	struct tcp_opt *tp = &(sk->tp_pinfo.af_tcp);
 	unsigned int len = skb->len, lss; 
 
+	/* Measure the segments, not what receive aggregation made of them. */
+	if (skb->gso_size)
+		len = skb->gso_size;
+
 	if (len > tp->rcv_mss) 
 		tp->rcv_mss = len; 
 	lss = tp->last_seg_size; 
@@ -1696,6 +1696,195 @@ discard:
 	return 0;
 }
 
+#ifdef _HURD_
+
+/*
+ *	Receive aggregation.  net_bh offers us each frame before handing
+ *	it to IP.  When the frames queued right behind a TCP data segment
+ *	carry the segments that follow it on the same connection, we merge
+ *	them all into one skb, so that IP and TCP processing, and the ACK
+ *	decision, happen once for the lot instead of once per segment.
+ *	Only plain in-order data segments with identical headers (bar the
+ *	sequence number) are merged, and each one's checksum is verified
+ *	while its data is copied, so the result needs no further checking.
+ */
+
+/* Return the TCP header of SKB, which starts at its IP header, if it
+ * is a data segment we may merge, or NULL.
+ */
+static struct tcphdr *tcp_v4_gro_header(struct sk_buff *skb)
+{
+	struct iphdr *iph = (struct iphdr *) skb->data;
+	struct tcphdr *th;
+
+	if (skb->protocol != __constant_htons(ETH_P_IP) ||
+	    skb->pkt_type != PACKET_HOST ||
+	    skb->len < sizeof(struct iphdr) + sizeof(struct tcphdr) ||
+	    iph->version != 4 || iph->ihl != 5 ||
+	    iph->protocol != IPPROTO_TCP ||
+	    (iph->frag_off & __constant_htons(IP_MF|IP_OFFSET)) ||
+	    ntohs(iph->tot_len) > skb->len ||
+	    ip_fast_csum((u8 *) iph, iph->ihl) != 0)
+		return NULL;
+
+	th = (struct tcphdr *) (iph + 1);
+	if (th->doff < 5 ||
+	    th->doff * 4 >= ntohs(iph->tot_len) - sizeof(struct iphdr) ||
+	    !th->ack || th->syn || th->fin || th->rst || th->urg)
+		return NULL;
+
+	return th;
+}
+
+/* Length of the data in the segment at TH, whose IP header is IPH.  */
+static inline int tcp_v4_gro_datalen(struct iphdr *iph, struct tcphdr *th)
+{
+	return ntohs(iph->tot_len) - sizeof(struct iphdr) - th->doff * 4;
+}
+
+/* Return true if NSKB carries the segment that follows the one at TH
+ * and IPH, on the same connection and with the same header.
+ */
+static int tcp_v4_gro_follows(struct sk_buff *skb, struct iphdr *iph,
+			      struct tcphdr *th, struct sk_buff *nskb)
+{
+	struct iphdr *niph = (struct iphdr *) nskb->data;
+	struct tcphdr *nth = tcp_v4_gro_header(nskb);
+
+	return (nth != NULL && nskb->dev == skb->dev &&
+		niph->saddr == iph->saddr && niph->daddr == iph->daddr &&
+		niph->tos == iph->tos && niph->ttl == iph->ttl &&
+		nth->source == th->source && nth->dest == th->dest &&
+		nth->ack_seq == th->ack_seq && nth->window == th->window &&
+		nth->doff == th->doff &&
+		ntohl(nth->seq) == ntohl(th->seq) + tcp_v4_gro_datalen(iph, th) &&
+		!memcmp(th + 1, nth + 1, th->doff * 4 - sizeof(struct tcphdr)));
+}
+
+/* Copy the data of the segment in SKB, which has TH and IPH as headers,
+ * to TO, verifying its checksum on the way.  Return true if it is good.
+ */
+static int tcp_v4_gro_copy(struct sk_buff *skb, struct iphdr *iph,
+			   struct tcphdr *th, char *to)
+{
+	int thlen = th->doff * 4;
+	int len = tcp_v4_gro_datalen(iph, th);
+	char *data = (char *) th + thlen;
+	unsigned int csum;
+
+	switch (skb->ip_summed) {
+	case CHECKSUM_NONE:
+		csum = csum_partial((char *) th, thlen, 0);
+		csum = csum_partial_copy_nocheck(data, to, len, csum);
+		return !tcp_v4_check(th, thlen + len, iph->saddr, iph->daddr,
+				     csum);
+	case CHECKSUM_HW:
+		memcpy(to, data, len);
+		return !tcp_v4_check(th, thlen + len, iph->saddr, iph->daddr,
+				     skb->csum);
+	default:
+		memcpy(to, data, len);
+		return 1;
+	}
+}
+
+/* Merge the segments queued on QUEUE right behind SKB that follow it
+ * into a single skb, and return that, or else SKB itself.
+ */
+struct sk_buff *tcp_v4_gro_receive(struct sk_buff *skb,
+				   struct sk_buff_head *queue)
+{
+	struct iphdr *iph = (struct iphdr *) skb->data;
+	struct tcphdr *th = tcp_v4_gro_header(skb);
+	struct sk_buff *nskb, *next, *agg;
+	struct iphdr *aiph;
+	struct tcphdr *ath;
+	int hlen, maclen, seglen, total, count;
+
+	/* Frames we are to forward must reach the next hop as they are.  */
+	if (th == NULL || th->psh || inet_addr_type(iph->daddr) != RTN_LOCAL)
+		return skb;
+
+	/* See how many of the queued segments we can take.  All but the
+	 * last must be as long as the first, which is how the receiver
+	 * will go on measuring the peer's MSS.
+	 */
+	hlen = sizeof(struct iphdr) + th->doff * 4;
+	seglen = tcp_v4_gro_datalen(iph, th);
+	total = seglen;
+	count = 0;
+	for (nskb = skb, next = queue->next;
+	     next != (struct sk_buff *) queue;
+	     nskb = next, next = next->next) {
+		struct iphdr *niph = (struct iphdr *) nskb->data;
+		struct tcphdr *nth = (struct tcphdr *) (niph + 1);
+		int len;
+
+		if (nskb != skb &&
+		    (nth->psh || tcp_v4_gro_datalen(niph, nth) != seglen))
+			break;
+		if (!tcp_v4_gro_follows(nskb, niph, nth, next))
+			break;
+		niph = (struct iphdr *) next->data;
+		len = tcp_v4_gro_datalen(niph, (struct tcphdr *) (niph + 1));
+		if (len > seglen || hlen + total + len > 65535)
+			break;
+		total += len;
+		count++;
+	}
+	if (count == 0)
+		return skb;
+
+	maclen = skb->data - skb->mac.raw;
+	agg = alloc_skb(maclen + hlen + total, GFP_ATOMIC);
+	if (agg == NULL)
+		return skb;
+	skb_reserve(agg, maclen);
+	agg->mac.raw = agg->data - maclen;
+	memcpy(agg->mac.raw, skb->mac.raw, maclen + hlen);
+	aiph = (struct iphdr *) skb_put(agg, hlen);
+	ath = (struct tcphdr *) (aiph + 1);
+
+	if (!tcp_v4_gro_copy(skb, iph, th, skb_put(agg, seglen))) {
+		/* Let TCP count and drop the bad one.  */
+		kfree_skb(agg);
+		return skb;
+	}
+
+	/* The segments we take are always at the head of QUEUE.  One with
+	 * a bad checksum stays there, for TCP to count and drop.
+	 */
+	while (count-- > 0) {
+		struct iphdr *niph;
+		struct tcphdr *nth;
+
+		nskb = skb_peek(queue);
+		niph = (struct iphdr *) nskb->data;
+		nth = (struct tcphdr *) (niph + 1);
+		if (!tcp_v4_gro_copy(nskb, niph, nth, (char *) agg->tail))
+			break;
+		skb_put(agg, tcp_v4_gro_datalen(niph, nth));
+		ath->psh = nth->psh;
+		__skb_unlink(nskb, queue);
+		kfree_skb(nskb);
+	}
+
+	agg->dev = skb->dev;
+	agg->protocol = skb->protocol;
+	agg->pkt_type = skb->pkt_type;
+	agg->stamp = skb->stamp;
+	agg->priority = skb->priority;
+	agg->ip_summed = CHECKSUM_UNNECESSARY;
+	agg->gso_size = seglen;
+	aiph->tot_len = htons(agg->len);
+	ip_send_check(aiph);
+
+	kfree_skb(skb);
+	return agg;
+}
+
+#endif /* _HURD_ */
+
 /*
  *	From tcp_input.c
  */
@@ -1,5 +1,5 @@
 /* Loopback "device" for pfinet
-   Copyright (C) 1996,98,2000 Free Software Foundation, Inc.
+   Copyright (C) 1996,98,2000,2026 Free Software Foundation, Inc.
 
    This file is part of the GNU Hurd.
 
@@ -31,7 +31,10 @@
 #include <linux/if_ether.h>	/* For the statistics structure. */
 #include <linux/if_arp.h>	/* For ARPHRD_ETHER */
 
-#define LOOPBACK_MTU	(vm_page_size - 172)
+/* There is no wire to segment for, so let TCP build segments as large
+   as its default windows comfortably hold: 16k of data plus TCP and IP
+   headers and the timestamp option.  */
+#define LOOPBACK_MTU	(16384 + 20 + 20 + 12)
 
 /*
  * The higher levels take care of making this non-reentrant (it's
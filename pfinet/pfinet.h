@@ -1,5 +1,5 @@
 /*
-   Copyright (C) 1995, 1996, 1999, 2000, 2002, 2007
+   Copyright (C) 1995, 1996, 1999, 2000, 2002, 2007, 2026
      Free Software Foundation, Inc.
 
    Written by Michael I. Bushnell, p/BSG.
@@ -86,6 +86,8 @@ void init_time (void);
 int get_routing_table(int start, int count, ifrtreq_t *routes);
 struct sock;
 error_t tcp_tiocinq (struct sock *sk, mach_msg_type_number_t *amount);
+struct socket;
+int sock_select_ready (struct socket *sock);
 
 void clean_addrport (void *);
 void clean_socketport (void *);
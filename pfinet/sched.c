@@ -1,5 +1,5 @@
 /*
-   Copyright (C) 1995,96,2000,02 Free Software Foundation, Inc.
+   Copyright (C) 1995,96,2000,02,26 Free Software Foundation, Inc.
 
    This file is part of the GNU Hurd.
 
@@ -22,6 +22,7 @@
 #include <asm/system.h>
 #include <linux/sched.h>
 #include <linux/interrupt.h>
+#include <linux/net.h>
 
 pthread_mutex_t global_lock = PTHREAD_MUTEX_INITIALIZER;
 pthread_mutex_t net_bh_lock = PTHREAD_MUTEX_INITIALIZER;
@@ -34,11 +35,16 @@ struct task_struct current_contents; /* zeros are right default values */
 /* Wake up the owner of the SOCK.  If HOW is zero, then just
    send SIGIO.  If HOW is one, then send SIGIO only if the
    SO_WAITDATA flag is off.  If HOW is two, then send SIGIO
-   only if the SO_NOSPACE flag is on, and also clear it. */
+   only if the SO_NOSPACE flag is on, and also clear it.
+
+   SIGIO is not done yet.  XXX  But this is where the Linux code tells
+   us that SOCK may have become ready, so post the readiness events
+   registered with io_event_register.  */
 int
 sock_wake_async (struct socket *sock, int how)
 {
-  /* For now, do nothing. XXX  */
+  if (sock && sock->events)
+    iohelp_post_events (&sock->events, sock_select_ready (sock));
   return 0;
 }
 
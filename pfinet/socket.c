@@ -1,5 +1,5 @@
 /*
-   Copyright (C) 1995,2000,02 Free Software Foundation, Inc.
+   Copyright (C) 1995,2000,02,26 Free Software Foundation, Inc.
 
    This file is part of the GNU Hurd.
 
@@ -106,6 +106,8 @@ sock_release (struct socket *sock)
   if (--sock->refcnt != 0)
     return;
 
+  iohelp_cancel_events (&sock->events);
+
   if (sock->state != SS_UNCONNECTED)
     sock->state = SS_DISCONNECTING;
 
@@ -0,0 +1,350 @@
+/* test-accept.c: Test batched accepts and SO_REUSEPORT on local sockets
+
+   Copyright (C) 2026 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation; either version 2, or (at
+   your option) any later version.
+
+   This program is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with the GNU Hurd.  If not, see <http://www.gnu.org/licenses/>.  */
+
+/* Two acceptors sleep in accept on a socket while a third sleeps in
+   socket_accept_many, and bursts of connections wake them.  When the
+   batch acceptor takes connections that woke the others, pflocal must
+   give those sleepers their places back, or later connectors find
+   nobody listening.  Then two sockets bind one address with
+   SO_REUSEPORT, and connections to it must be spread over both.  This
+   exits with status 0 if all checks pass.  */
+
+#include <errno.h>
+#include <error.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <hurd.h>
+#include <hurd/fd.h>
+#include <hurd/ifsock.h>
+#include <hurd/socket.h>
+
+#include "socket_accept_U.h"
+
+#define BURSTS		20
+#define BURST		3
+#define BATCH_MAX	8
+
+static int failures;
+
+/* Connections accepted so far, and the largest batch.  */
+static int accepted, max_batch;
+static pthread_mutex_t accepted_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static void
+check (int ok, const char *what)
+{
+  printf ("%s: %s\n", ok ? "PASS" : "FAIL", what);
+  if (! ok)
+    failures++;
+}
+
+static void
+count_accepted (int n)
+{
+  pthread_mutex_lock (&accepted_lock);
+  accepted += n;
+  if (n > max_batch)
+    max_batch = n;
+  pthread_mutex_unlock (&accepted_lock);
+}
+
+/* Wait up to five seconds for ACCEPTED to reach N.  */
+static int
+wait_accepted (int n)
+{
+  int i, done = 0;
+
+  for (i = 0; i < 500 && ! done; i++)
+    {
+      pthread_mutex_lock (&accepted_lock);
+      done = accepted >= n;
+      pthread_mutex_unlock (&accepted_lock);
+      if (! done)
+	usleep (10000);
+    }
+  return done;
+}
+
+/* Make a new local socket bound to PATH; if SHARE, let others bind to
+   it too.  */
+static int
+bound_socket (const char *path, int share)
+{
+  struct sockaddr_un sun;
+  int fd, one = 1;
+
+  fd = socket (AF_LOCAL, SOCK_STREAM, 0);
+  if (fd < 0)
+    error (1, errno, "socket");
+  if (share
+      && setsockopt (fd, SOL_SOCKET, SO_REUSEPORT, &one, sizeof one) < 0)
+    error (1, errno, "SO_REUSEPORT");
+
+  memset (&sun, 0, sizeof sun);
+  sun.sun_family = AF_LOCAL;
+  strcpy (sun.sun_path, path);
+  if (bind (fd, (struct sockaddr *) &sun, sizeof sun) < 0)
+    error (1, errno, "bind");
+  return fd;
+}
+
+/* Connect a new local socket to PATH, and return it, or -1 with errno
+   set.  */
+static int
+connect_to (const char *path, int nonblock)
+{
+  struct sockaddr_un sun;
+  int fd;
+
+  fd = socket (AF_LOCAL, SOCK_STREAM, 0);
+  if (fd < 0)
+    error (1, errno, "socket");
+  if (nonblock)
+    fcntl (fd, F_SETFL, O_NONBLOCK);
+
+  memset (&sun, 0, sizeof sun);
+  sun.sun_family = AF_LOCAL;
+  strcpy (sun.sun_path, path);
+  if (connect (fd, (struct sockaddr *) &sun, sizeof sun) < 0)
+    {
+      int saved = errno;
+      close (fd);
+      errno = saved;
+      return -1;
+    }
+  return fd;
+}
+
+static void *
+sleeping_acceptor (void *arg)
+{
+  int lfd = (intptr_t) arg, fd;
+
+  while ((fd = accept (lfd, NULL, NULL)) >= 0)
+    {
+      count_accepted (1);
+      close (fd);
+    }
+  return NULL;
+}
+
+static void *
+batch_acceptor (void *arg)
+{
+  int lfd = (intptr_t) arg;
+
+  for (;;)
+    {
+      mach_port_t *conns = NULL, *addrs = NULL;
+      mach_msg_type_number_t nconns = 0, naddrs = 0, i;
+      error_t err;
+
+      err = HURD_DPORT_USE (lfd, socket_accept_many (port, BATCH_MAX,
+						     &conns, &nconns,
+						     &addrs, &naddrs));
+      if (err)
+	error (1, err, "socket_accept_many");
+      for (i = 0; i < nconns; i++)
+	mach_port_deallocate (mach_task_self (), conns[i]);
+      for (i = 0; i < naddrs; i++)
+	if (MACH_PORT_VALID (addrs[i]))
+	  mach_port_deallocate (mach_task_self (), addrs[i]);
+      vm_deallocate (mach_task_self (), (vm_address_t) conns,
+		     nconns * sizeof *conns);
+      vm_deallocate (mach_task_self (), (vm_address_t) addrs,
+		     naddrs * sizeof *addrs);
+      count_accepted (nconns);
+    }
+  return NULL;
+}
+
+static char *burst_path;
+
+static void *
+burst_connector (void *arg)
+{
+  int fd = connect_to (burst_path, 0);
+
+  (void) arg;
+  if (fd < 0)
+    error (1, errno, "connect");
+  close (fd);
+  return NULL;
+}
+
+/* Serve PATH with two sleeping acceptors and a batch acceptor, and send
+   it bursts of connections.  */
+static void
+test_batches (const char *path)
+{
+  pthread_t thread, connectors[BURST];
+  int lfd, fds[BURST], i, j, ok;
+
+  lfd = bound_socket (path, 0);
+  /* With no backlog, a non-blocking connect gets through only when
+     someone is listening.  */
+  if (listen (lfd, 0) < 0)
+    error (1, errno, "listen");
+
+  pthread_create (&thread, NULL, sleeping_acceptor, (void *) (intptr_t) lfd);
+  pthread_create (&thread, NULL, sleeping_acceptor, (void *) (intptr_t) lfd);
+  pthread_create (&thread, NULL, batch_acceptor, (void *) (intptr_t) lfd);
+
+  burst_path = (char *) path;
+  ok = 1;
+  for (i = 0; i < BURSTS && ok; i++)
+    {
+      usleep (50000);
+      for (j = 0; j < BURST; j++)
+	pthread_create (&connectors[j], NULL, burst_connector, NULL);
+      for (j = 0; j < BURST; j++)
+	pthread_join (connectors[j], NULL);
+      ok = wait_accepted ((i + 1) * BURST);
+    }
+  check (ok, "every connection of every burst is accepted");
+  printf ("largest batch: %d\n", max_batch);
+
+  /* All three acceptors are asleep again, so three non-blocking
+     connects in a row must find somebody listening.  */
+  usleep (200000);
+  ok = 1;
+  for (j = 0; j < BURST; j++)
+    {
+      fds[j] = connect_to (path, 1);
+      if (fds[j] < 0)
+	ok = 0;
+    }
+  check (ok, "the sleeping acceptors still count as listening");
+  check (wait_accepted ((BURSTS + 1) * BURST),
+	 "and they accept those connections");
+  for (j = 0; j < BURST; j++)
+    if (fds[j] >= 0)
+      close (fds[j]);
+}
+
+/* Accept all the connections waiting on the non-blocking LFD, and return
+   how many there were.  */
+static int
+accept_all (int lfd)
+{
+  int fd, n = 0;
+
+  while ((fd = accept (lfd, NULL, NULL)) >= 0)
+    {
+      close (fd);
+      n++;
+    }
+  if (errno != EWOULDBLOCK)
+    error (1, errno, "accept");
+  return n;
+}
+
+/* Bind two SO_REUSEPORT sockets to PATH, and see how the connections to
+   it are spread over them.  */
+static void
+test_reuseport (const char *path)
+{
+  int lfd[2], fd, n[2], i;
+  file_t node;
+  addr_port_t addr;
+  error_t err;
+
+  lfd[0] = bound_socket (path, 1);
+
+  /* Bind a second socket to the address of the first one.  */
+  lfd[1] = socket (AF_LOCAL, SOCK_STREAM, 0);
+  if (lfd[1] < 0)
+    error (1, errno, "socket");
+  i = 1;
+  if (setsockopt (lfd[1], SOL_SOCKET, SO_REUSEPORT, &i, sizeof i) < 0)
+    error (1, errno, "SO_REUSEPORT");
+  node = file_name_lookup (path, 0, 0);
+  if (node == MACH_PORT_NULL)
+    error (1, errno, "%s", path);
+  err = ifsock_getsockaddr (node, &addr);
+  if (err)
+    error (1, err, "ifsock_getsockaddr");
+  err = HURD_DPORT_USE (lfd[1], socket_bind (port, addr));
+  check (! err, "a second SO_REUSEPORT socket binds the same address");
+  mach_port_deallocate (mach_task_self (), addr);
+  mach_port_deallocate (mach_task_self (), node);
+
+  for (i = 0; i < 2; i++)
+    {
+      if (listen (lfd[i], 16) < 0)
+	error (1, errno, "listen");
+      fcntl (lfd[i], F_SETFL, O_NONBLOCK);
+    }
+
+  for (i = 0; i < 10; i++)
+    {
+      fd = connect_to (path, 0);
+      if (fd < 0)
+	error (1, errno, "connect");
+      close (fd);
+    }
+  n[0] = accept_all (lfd[0]);
+  n[1] = accept_all (lfd[1]);
+  printf ("SO_REUSEPORT: %d and %d connections\n", n[0], n[1]);
+  check (n[0] + n[1] == 10, "every connection reaches a listener");
+  check (n[0] == 5 && n[1] == 5, "the listeners take turns");
+
+  /* A socket without SO_REUSEPORT may still not share the address.  */
+  fd = socket (AF_LOCAL, SOCK_STREAM, 0);
+  node = file_name_lookup (path, 0, 0);
+  if (fd < 0 || node == MACH_PORT_NULL
+      || ifsock_getsockaddr (node, &addr))
+    error (1, errno, "%s", path);
+  err = HURD_DPORT_USE (fd, socket_bind (port, addr));
+  check (err == EADDRINUSE, "a socket without SO_REUSEPORT does not");
+  mach_port_deallocate (mach_task_self (), addr);
+  mach_port_deallocate (mach_task_self (), node);
+  close (fd);
+
+  close (lfd[0]);
+  close (lfd[1]);
+}
+
+int
+main (void)
+{
+  char batches[] = "/tmp/test-accept.XXXXXX", reuse[64];
+
+  if (! mkdtemp (batches))
+    error (1, errno, "mkdtemp");
+  snprintf (reuse, sizeof reuse, "%s/reuse", batches);
+  strcat (batches, "/batches");
+
+  test_batches (batches);
+  test_reuseport (reuse);
+
+  unlink (batches);
+  unlink (reuse);
+  *strrchr (reuse, '/') = '\0';
+  rmdir (reuse);
+
+  if (failures)
+    error (1, 0, "%d checks failed", failures);
+  return 0;
+}
@@ -0,0 +1,172 @@
+/* test-events.c: Test io_event_register on local sockets
+
+   Copyright (C) 2026 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation; either version 2, or (at
+   your option) any later version.
+
+   This program is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with the GNU Hurd.  If not, see <http://www.gnu.org/licenses/>.  */
+
+/* This registers for events on the ends of a pflocal socket pair and
+   checks what io_event_ready messages arrive, and when.  It exits with
+   status 0 if all checks pass.  */
+
+#include <errno.h>
+#include <error.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <hurd.h>
+#include <hurd/fd.h>
+#include <hurd/io.h>
+
+#include "io_event_U.h"
+#include "io_event_notify_S.h"
+
+#define MAX_EVENTS	8
+
+/* The events received by the last call to wait_events.  */
+static struct
+{
+  vm_address_t cookie;
+  int select_type;
+} events[MAX_EVENTS];
+static int nevents;
+
+static mach_port_t event_port;
+static int failures;
+
+static void
+check (int ok, const char *what)
+{
+  printf ("%s: %s\n", ok ? "PASS" : "FAIL", what);
+  if (! ok)
+    failures++;
+}
+
+kern_return_t
+S_io_event_ready (mach_port_t port, vm_address_t cookie, int select_type)
+{
+  if (nevents < MAX_EVENTS)
+    {
+      events[nevents].cookie = cookie;
+      events[nevents].select_type = select_type;
+    }
+  nevents++;
+  return 0;
+}
+
+/* Collect the events that arrive within MSECS milliseconds, and return
+   how many there were.  */
+static int
+wait_events (int msecs)
+{
+  nevents = 0;
+  mach_msg_server_timeout (io_event_notify_server, 0, event_port,
+			   MACH_RCV_TIMEOUT, msecs);
+  return nevents;
+}
+
+/* Register for SELECT_TYPE on FD with COOKIE.  */
+static void
+event_register (int fd, vm_address_t cookie, int select_type)
+{
+  error_t err;
+
+  err = HURD_DPORT_USE (fd, io_event_register (port, event_port, cookie,
+					       select_type));
+  if (err)
+    error (1, err, "io_event_register");
+}
+
+/* Write to the non-blocking FD until that would block.  */
+static void
+fill (int fd)
+{
+  char buf[512] = { 0 };
+
+  while (write (fd, buf, sizeof buf) > 0)
+    ;
+  if (errno != EAGAIN)
+    error (1, errno, "write");
+}
+
+/* Read everything there is on the non-blocking FD.  */
+static void
+drain (int fd)
+{
+  char buf[512];
+
+  while (read (fd, buf, sizeof buf) > 0)
+    ;
+}
+
+int
+main (void)
+{
+  error_t err;
+  int fds[2];
+
+  err = mach_port_allocate (mach_task_self (), MACH_PORT_RIGHT_RECEIVE,
+			    &event_port);
+  if (err)
+    error (1, err, "mach_port_allocate");
+
+  if (socketpair (AF_LOCAL, SOCK_STREAM, 0, fds) < 0)
+    error (1, errno, "socketpair");
+  fcntl (fds[0], F_SETFL, O_NONBLOCK);
+  fcntl (fds[1], F_SETFL, O_NONBLOCK);
+
+  /* Nothing to read on fds[0], and no room to write to it: this waits
+     on both of its pipes.  */
+  fill (fds[0]);
+  event_register (fds[0], 1, SELECT_READ | SELECT_WRITE);
+  check (wait_events (200) == 0,
+	 "nothing is posted while the socket is not ready");
+
+  write (fds[1], "x", 1);
+  check (wait_events (1000) == 1 && events[0].cookie == 1
+	 && events[0].select_type == SELECT_READ,
+	 "data to read posts the registration once, for reading");
+
+  /* The registration also waited on fds[0]'s other pipe; making that
+     writable must not post it again.  */
+  drain (fds[1]);
+  check (wait_events (200) == 0,
+	 "a posted registration is not posted again by its other pipe");
+
+  event_register (fds[0], 2, SELECT_WRITE);
+  check (wait_events (1000) == 1 && events[0].cookie == 2
+	 && events[0].select_type == SELECT_WRITE,
+	 "a socket that is ready already is posted right away");
+
+  drain (fds[0]);
+  event_register (fds[0], 3, SELECT_READ);
+  close (fds[1]);
+  check (wait_events (1000) == 1 && events[0].cookie == 3
+	 && events[0].select_type == SELECT_READ,
+	 "the peer closing posts a waiting reader");
+
+  /* Both ends going away must return the right, with or without a
+     type.  */
+  if (socketpair (AF_LOCAL, SOCK_STREAM, 0, fds) < 0)
+    error (1, errno, "socketpair");
+  event_register (fds[0], 4, SELECT_READ);
+  close (fds[0]);
+  close (fds[1]);
+  check (wait_events (1000) == 1 && events[0].cookie == 4,
+	 "closing the socket returns an outstanding registration");
+
+  if (failures)
+    error (1, 0, "%d checks failed", failures);
+  return 0;
+}
@@ -1,6 +1,6 @@
 /* Listen queue functions
 
-   Copyright (C) 1995,96,2001,2012 Free Software Foundation, Inc.
+   Copyright (C) 1995,96,2001,2012,26 Free Software Foundation, Inc.
 
    Written by Miles Bader <miles@gnu.org>
 
@@ -21,6 +21,8 @@
 #include <pthread.h>
 #include <assert-backtrace.h>
 #include <stdlib.h>
+#include <hurd/hurd_types.h>
+#include <hurd/iohelp.h>
 
 #include "connq.h"
 
@@ -41,6 +43,9 @@ struct connq
   pthread_cond_t connectors;
   unsigned num_connectors;
 
+  /* io_event_register registrations waiting for a connection request.  */
+  struct iohelp_event *events;
+
   pthread_mutex_t lock;
 };
 
@@ -54,12 +59,16 @@ struct connq_request
 
   /* The socket that's waiting to connect.  */
   struct sock *sock;
+
+  /* True if queueing this request woke up a listener.  */
+  int woke_listener;
 };
 
 static inline void
 connq_request_init (struct connq_request *req, struct sock *sock)
 {
   req->sock = sock;
+  req->woke_listener = 0;
 }
 
 /* Enqueue connection request REQ onto CQ.  CQ must be locked.  */
@@ -117,6 +126,7 @@ connq_create (struct connq **cq)
 
   new->num_listeners = 0;
   new->num_connectors = 0;
+  new->events = NULL;
 
   pthread_mutex_init (&new->lock, NULL);
   pthread_cond_init (&new->listeners, NULL);
@@ -135,18 +145,18 @@ connq_destroy (struct connq *cq)
   assert_backtrace (! cq->head);
   assert_backtrace (cq->count == 0);
 
+  iohelp_cancel_events (&cq->events);
   free (cq);
 }
 
 /* ---------------------------------------------------------------- */
 
-/* Return a connection request on CQ.  If SOCK is NULL, the request is
-   left in the queue.  If TIMEOUT denotes a value of 0, EWOULDBLOCK is
-   returned when there are no immediate connections available.
-   Otherwise this value is used to limit the wait duration.  If TIMEOUT
-   is NULL, the wait duration isn't bounded.  */
+/* Return up to *NUM connection requests on CQ in SOCKS, and set *NUM
+   to the number returned.  If SOCKS is NULL, the requests are left in
+   the queue.  TSP is as for connq_listen.  */
 error_t
-connq_listen (struct connq *cq, struct timespec *tsp, struct sock **sock)
+connq_listen_many (struct connq *cq, struct timespec *tsp,
+		   struct sock **socks, unsigned *num)
 {
   error_t err = 0;
 
@@ -159,7 +169,7 @@ connq_listen (struct connq *cq, struct timespec *tsp, struct sock **sock)
       return EWOULDBLOCK;
     }
 
-  if (! sock && (cq->count > 0 || cq->num_connectors > 0))
+  if (! socks && (cq->count > 0 || cq->num_connectors > 0))
     /* The caller just wants to know if a connection ready.  */
     {
       pthread_mutex_unlock (&cq->lock);
@@ -192,12 +202,33 @@ connq_listen (struct connq *cq, struct timespec *tsp, struct sock **sock)
 
   assert_backtrace (cq->head);
 
-  if (sock)
-    /* Dequeue the next request, if desired.  */
+  if (socks)
+    /* Dequeue the next requests, if desired.  */
     {
-      struct connq_request *req = connq_request_dequeue (cq);
-      *sock = req->sock;
-      free (req);
+      unsigned n = 0, woken = 0;
+
+      while (n < *num && cq->head)
+	{
+	  struct connq_request *req = connq_request_dequeue (cq);
+	  socks[n++] = req->sock;
+	  woken += req->woke_listener;
+	  free (req);
+	}
+      *num = n;
+
+      /* Each request that woke a listener took away that listener's
+	 count in NUM_LISTENERS.  As with a single request, our own count
+	 makes up for one of them; the other listeners will find the
+	 queue empty and go back to waiting, so give them their counts
+	 back.  */
+      if (woken > 1)
+	cq->num_listeners += woken - 1;
+
+      /* We made room in the queue; let as many connectors in.  Waking
+	 them one by one rather than all at once keeps the others
+	 asleep.  */
+      while (n-- > 0 && cq->num_connectors > 0)
+	pthread_cond_signal (&cq->connectors);
     }
   else if (cq->num_listeners > 0)
     /* The caller will not actually process this request but someone
@@ -218,6 +249,19 @@ connq_listen (struct connq *cq, struct timespec *tsp, struct sock **sock)
   pthread_mutex_unlock (&cq->lock);
   return err;
 }
+
+/* Return a connection request on CQ.  If SOCK is NULL, the request is
+   left in the queue.  If TIMEOUT denotes a value of 0, EWOULDBLOCK is
+   returned when there are no immediate connections available.
+   Otherwise this value is used to limit the wait duration.  If TIMEOUT
+   is NULL, the wait duration isn't bounded.  */
+error_t
+connq_listen (struct connq *cq, struct timespec *tsp, struct sock **sock)
+{
+  unsigned num = 1;
+
+  return connq_listen_many (cq, tsp, sock, &num);
+}
 
 /* Try to connect SOCK with the socket listening on CQ.  If NOBLOCK is
    true, then return EWOULDBLOCK if there are no connections
@@ -241,6 +285,10 @@ connq_connect (struct connq *cq, int noblock)
 
   cq->num_connectors ++;
 
+  /* A connector counts as a pending connection for connq_listen with a
+     NULL SOCK, which is what select does; be consistent with that.  */
+  iohelp_post_events (&cq->events, SELECT_READ);
+
   while (cq->count + cq->num_connectors > cq->max + cq->num_listeners)
     /* The queue is full and there is no immediate listener to service
        us.  Block until we can get a slot.  */
@@ -275,6 +323,7 @@ connq_connect_complete (struct connq *cq, struct sock *sock)
   cq->num_connectors --;
 
   connq_request_enqueue (cq, req);
+  iohelp_post_events (&cq->events, SELECT_READ);
 
   if (cq->num_listeners > 0)
     /* Wake a listener up.  We must consume the listener ref here as
@@ -282,6 +331,7 @@ connq_connect_complete (struct connq *cq, struct sock *sock)
        thread dequeues this request.  */
     {
       cq->num_listeners --;
+      req->woke_listener = 1;
       pthread_cond_signal (&cq->listeners);
     }
 
@@ -319,9 +369,24 @@ connq_set_length (struct connq *cq, int max)
     /* This is an increase in the number of connection slots which has
        made some slots available and there are waiting threads.  Wake
        them up.  */
-    pthread_cond_broadcast (&cq->listeners);
+    pthread_cond_broadcast (&cq->connectors);
 
   pthread_mutex_unlock (&cq->lock);
 
   return 0;
 }
+
+/* Handle io_event_register for reading on the socket listening on CQ.  */
+error_t
+connq_event_register (struct connq *cq, mach_port_t port, vm_address_t cookie)
+{
+  error_t err;
+
+  pthread_mutex_lock (&cq->lock);
+  err = iohelp_register_event (&cq->events, port, cookie, SELECT_READ,
+			       (cq->count > 0 || cq->num_connectors > 0)
+			       ? SELECT_READ : 0);
+  pthread_mutex_unlock (&cq->lock);
+
+  return err;
+}
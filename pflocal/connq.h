@@ -1,6 +1,6 @@
 /* Connection queues
 
-   Copyright (C) 1995, 2012 Free Software Foundation, Inc.
+   Copyright (C) 1995, 2012, 2026 Free Software Foundation, Inc.
 
    Written by Miles Bader <miles@gnu.ai.mit.edu>
 
@@ -22,6 +22,7 @@
 #define __CONNQ_H__
 
 #include <errno.h>
+#include <mach.h>
 
 /* Forward.  */
 struct connq;
@@ -43,6 +44,12 @@ void connq_destroy (struct connq *cq);
 error_t connq_listen (struct connq *cq, struct timespec *tsp,
 		      struct sock **sock);
 
+/* Like connq_listen, but return up to *NUM connection requests at once
+   in SOCKS, and set *NUM to the number returned.  This waits only for
+   the first request.  */
+error_t connq_listen_many (struct connq *cq, struct timespec *tsp,
+			   struct sock **socks, unsigned *num);
+
 /* Try to connect SOCK with the socket listening on CQ.  If NOBLOCK is
    true, then return EWOULDBLOCK if there are no connections
    immediately available.  On success, this call must be followed up
@@ -60,4 +67,11 @@ void connq_connect_cancel (struct connq *cq);
    connections that are past the new length remain.  */
 error_t connq_set_length (struct connq *cq, int length);
 
+/* Handle io_event_register for reading on the socket listening on CQ:
+   post an event for COOKIE to PORT once a connection request is there,
+   as connq_listen would wait for.  PORT is consumed unless an error is
+   returned.  */
+error_t connq_event_register (struct connq *cq,
+			      mach_port_t port, vm_address_t cookie);
+
 #endif /* __CONNQ_H__ */
@@ -1,6 +1,6 @@
 /* Socket I/O operations
 
-   Copyright (C) 1995, 1996, 1998, 1999, 2000, 2002, 2007, 2012
+   Copyright (C) 1995, 1996, 1998, 1999, 2000, 2002, 2007, 2012, 2026
      Free Software Foundation, Inc.
 
    Written by Miles Bader <miles@gnu.org>
@@ -30,6 +30,7 @@
 #include <hurd/hurd_types.h>
 #include <hurd/auth.h>
 #include <hurd/pipe.h>
+#include <hurd/iohelp.h>
 #include <mach/notify.h>
 
 #include "sock.h"
@@ -37,6 +38,7 @@
 #include "sserver.h"
 
 #include "io_S.h"
+#include "io_event_S.h"
 
 /* Read data from an IO object.  If offset if -1, read from the object
    maintained file pointer.  If the object is not seekable, offset is
@@ -298,6 +300,72 @@ S_io_select_timeout (struct sock_user *user,
 {
   return io_select_common (user, reply, reply_type, &ts, select_type);
 }
+
+/* Like io_select_common, but rather than waiting, leave a registration
+   behind on the listen queue or pipes to post an event to EVENT_PORT
+   once the socket is ready.  */
+kern_return_t
+S_io_event_register (struct sock_user *user,
+		     mach_port_t event_port, vm_address_t cookie,
+		     int select_type)
+{
+  error_t err;
+  struct sock *sock;
+  struct pipe *read_pipe, *write_pipe;
+  int ready = 0;
+
+  if (!user)
+    return EOPNOTSUPP;
+
+  select_type &= SELECT_READ | SELECT_WRITE;
+
+  sock = user->sock;
+  pthread_mutex_lock (&sock->lock);
+
+  if (sock->listen_queue)
+    /* Only accepting connections can be waited for; see above.  */
+    {
+      pthread_mutex_unlock (&sock->lock);
+      if (! (select_type & SELECT_READ))
+	return EINVAL;
+      return connq_event_register (sock->listen_queue, event_port, cookie);
+    }
+
+  read_pipe = sock->read_pipe;
+  write_pipe = sock->write_pipe;
+
+  if (! write_pipe)
+    ready |= SELECT_WRITE;
+  if (! read_pipe)
+    ready |= SELECT_READ;
+  ready &= select_type;
+
+  if (ready || ! select_type)
+    {
+      pthread_mutex_unlock (&sock->lock);
+      if (! select_type)
+	return EINVAL;
+      iohelp_post_event (event_port, cookie, ready);
+      return 0;
+    }
+
+  /* Keep the pipes around while we register on them.  */
+  if (select_type & SELECT_READ)
+    pipe_add_reader (read_pipe);
+  if (select_type & SELECT_WRITE)
+    pipe_add_writer (write_pipe);
+  pthread_mutex_unlock (&sock->lock);
+
+  err = pipe_pair_event_register (read_pipe, write_pipe, event_port, cookie,
+				  select_type, 1);
+
+  if (select_type & SELECT_READ)
+    pipe_remove_reader (read_pipe);
+  if (select_type & SELECT_WRITE)
+    pipe_remove_writer (write_pipe);
+
+  return err;
+}
 
 static inline void
 copy_time (time_value_t *from, time_t *to_sec, long *to_nsec)
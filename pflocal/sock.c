@@ -1,6 +1,6 @@
 /* Sock functions
 
-   Copyright (C) 1995,96,2000,01,02, 2005 Free Software Foundation, Inc.
+   Copyright (C) 1995,96,2000,01,02, 2005, 2026 Free Software Foundation, Inc.
    Written by Miles Bader <miles@gnu.org>
 
    This program is free software; you can redistribute it and/or
@@ -124,6 +124,7 @@ sock_create (struct pipe_class *pipe_class, mode_t mode, struct sock **sock)
   new->connect_queue = NULL;
   new->pipe_class = pipe_class;
   new->addr = NULL;
+  new->bound_next = NULL;
   new->uid = getuid ();
   new->gid = getgid ();
   memset (&new->change_time, 0, sizeof (new->change_time));
@@ -168,7 +169,8 @@ sock_clone (struct sock *template, struct sock **sock)
     return err;
 
   /* Copy some properties from TEMPLATE.  */
-  (*sock)->flags = template->flags & ~PFLOCAL_SOCK_CONNECTED;
+  (*sock)->flags = template->flags
+		   & ~(PFLOCAL_SOCK_CONNECTED | PFLOCAL_SOCK_REUSEPORT);
 
   return 0;
 }
@@ -217,7 +219,10 @@ sock_create_port (struct sock *sock, mach_port_t *port)
 struct addr
 {
   struct port_info pi;
+  /* The sockets bound to this address, linked through BOUND_NEXT.  */
   struct sock *sock;
+  /* The one addr_get_sock returned last, if several are bound.  */
+  struct sock *rotor;
   pthread_mutex_t lock;
 };
 
@@ -232,16 +237,17 @@ addr_unbind (void *vaddr)
   struct addr *addr = vaddr;
 
   pthread_mutex_lock (&addr->lock);
-  sock = addr->sock;
-  if (sock)
+  while ((sock = addr->sock))
     {
       pthread_mutex_lock (&sock->lock);
       sock->addr = NULL;
-      addr->sock = NULL;
+      addr->sock = sock->bound_next;
+      sock->bound_next = NULL;
       ports_port_deref_weak (addr);
       pthread_mutex_unlock (&sock->lock);
       sock_deref (sock);
     }
+  addr->rotor = NULL;
   pthread_mutex_unlock (&addr->lock);
 }
 
@@ -268,34 +274,70 @@ addr_create (struct addr **addr)
     {
       ensure_sock_server ();
       (*addr)->sock = NULL;
+      (*addr)->rotor = NULL;
       pthread_mutex_init (&(*addr)->lock, NULL);
     }
 
   return err;
 }
 
+/* Return true if SOCK may be bound to an address OTHER is bound to.  */
+static inline int
+sock_may_share_addr (struct sock *sock, struct sock *other)
+{
+  return ((sock->flags & other->flags & PFLOCAL_SOCK_REUSEPORT)
+	  && sock->uid == other->uid
+	  && sock->pipe_class == other->pipe_class);
+}
+
 /* Bind SOCK to ADDR.  */
 error_t
 sock_bind (struct sock *sock, struct addr *addr)
 {
   error_t err = 0;
-  struct addr *old_addr;
+  struct addr *old_addr, *unbind_addr = NULL;
+  struct sock **sp;
 
   if (addr)
     pthread_mutex_lock (&addr->lock);
+  else
+    {
+      /* To unbind, we need the lock of the address SOCK is bound to,
+	 which comes before SOCK's.  Our weak reference keeps it around
+	 meanwhile.  */
+      pthread_mutex_lock (&sock->lock);
+      unbind_addr = sock->addr;
+      if (unbind_addr)
+	ports_port_ref_weak (unbind_addr);
+      pthread_mutex_unlock (&sock->lock);
+      if (unbind_addr)
+	pthread_mutex_lock (&unbind_addr->lock);
+    }
   pthread_mutex_lock (&sock->lock);
 
   old_addr = sock->addr;
   if (addr && old_addr)
     err = EINVAL;		/* SOCK already bound.  */
-  else if (!addr && !old_addr)
+  else if (!addr && (!old_addr || old_addr != unbind_addr))
     err = EINVAL;		/* SOCK already bound.  */
-  else if (addr && addr->sock)
+  else if (addr && addr->sock && ! sock_may_share_addr (sock, addr->sock))
     err = EADDRINUSE;		/* Something else already bound ADDR.  */
   else if (addr)
-    addr->sock = sock;		/* First binding for SOCK.  */
+    {
+      /* Binding for SOCK, maybe not the first one for ADDR.  */
+      sock->bound_next = addr->sock;
+      addr->sock = sock;
+    }
   else
-    old_addr->sock = NULL;	/* Unbinding SOCK.  */
+    {
+      /* Unbinding SOCK.  */
+      for (sp = &old_addr->sock; *sp != sock; sp = &(*sp)->bound_next)
+	assert_backtrace (*sp);
+      *sp = sock->bound_next;
+      sock->bound_next = NULL;
+      if (old_addr->rotor == sock)
+	old_addr->rotor = NULL;
+    }
 
   if (! err)
     {
@@ -318,6 +360,11 @@ sock_bind (struct sock *sock, struct addr *addr)
   pthread_mutex_unlock (&sock->lock);
   if (addr)
     pthread_mutex_unlock (&addr->lock);
+  if (unbind_addr)
+    {
+      pthread_mutex_unlock (&unbind_addr->lock);
+      ports_port_deref_weak (unbind_addr);
+    }
 
   return err;
 }
@@ -355,6 +402,28 @@ addr_get_sock (struct addr *addr, struct sock **sock)
 {
   pthread_mutex_lock (&addr->lock);
   *sock = addr->sock;
+  if (*sock && (*sock)->bound_next)
+    /* Several sockets share ADDR; hand them out in turn, skipping those
+       that don't listen (yet), so that connections are spread over the
+       servers.  */
+    {
+      struct sock *start, *s;
+
+      start = addr->rotor ? addr->rotor->bound_next : NULL;
+      if (! start)
+	start = addr->sock;
+
+      s = start;
+      do
+	{
+	  if (s->listen_queue)
+	    break;
+	  s = s->bound_next ?: addr->sock;
+	}
+      while (s != start);
+
+      addr->rotor = *sock = s;
+    }
   if (*sock)
     {
       pthread_mutex_lock (&(*sock)->lock);
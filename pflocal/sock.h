@@ -1,6 +1,6 @@
 /* Internal sockets
 
-   Copyright (C) 1995,96,99,2000,01 Free Software Foundation, Inc.
+   Copyright (C) 1995,96,99,2000,01,2026 Free Software Foundation, Inc.
 
    Written by Miles Bader <miles@gnu.org>
 
@@ -73,6 +73,9 @@ struct sock
      is ok, as we can then just make up another address if necessary, and no
      one could tell anyway).  */
   struct addr *addr;
+  /* The next socket bound to ADDR, if several are (see
+     PFLOCAL_SOCK_REUSEPORT).  Protected by ADDR's lock.  */
+  struct sock *bound_next;
 
   /* A connection queue to listen for incoming connections on.  Once a socket
      has one of these, it always does, and can never again be used for
@@ -92,6 +95,7 @@ struct sock
 #define PFLOCAL_SOCK_NONBLOCK		0x2 /* Don't block on I/O.  */
 #define PFLOCAL_SOCK_SHUTDOWN_READ	0x4 /* The read-half has been shutdown.  */
 #define PFLOCAL_SOCK_SHUTDOWN_WRITE	0x8 /* The write-half has been shutdown.  */
+#define PFLOCAL_SOCK_REUSEPORT		0x10 /* May share its address, see sock_bind.  */
 
 /* Returns the pipe that SOCK is reading from in PIPE, locked and with an
    additional reference, or an error saying why it's not possible.  NULL may
@@ -117,7 +121,10 @@ void sock_free (struct sock *sock);
 /* Free a sock derefed too far.  */
 void _sock_norefs (struct sock *sock);
 
-/* Bind SOCK to ADDR.  */
+/* Bind SOCK to ADDR, or unbind it if ADDR is NULL.  Several sockets
+   may be bound to the same address if they all have
+   PFLOCAL_SOCK_REUSEPORT set and belong to the same user; connections
+   and datagrams to the address are then spread over them.  */
 error_t sock_bind (struct sock *sock, struct addr *addr);
 
 /* Remove a reference from SOCK, possibly freeing it.  */
@@ -175,7 +182,8 @@ void sock_shutdown (struct sock *sock, unsigned flags);
 /* Return a new address, not connected to any socket yet, ADDR.  */
 error_t addr_create (struct addr **addr);
 
-/* Returns the socket bound to ADDR in SOCK, or EADDRNOTAVAIL.  The returned
+/* Returns the socket bound to ADDR in SOCK, or EADDRNOTAVAIL.  If several
+   are, they are returned in turn, preferring listening ones.  The returned
    sock will have one reference added to it.  */
 error_t addr_get_sock (struct addr *addr, struct sock **sock);
 
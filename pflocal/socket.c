@@ -1,6 +1,6 @@
 /* Socket-specific operations
 
-   Copyright (C) 1995, 2008, 2010, 2012 Free Software Foundation, Inc.
+   Copyright (C) 1995, 2008, 2010, 2012, 2026 Free Software Foundation, Inc.
 
    Written by Miles Bader <miles@gnu.ai.mit.edu>
 
@@ -19,6 +19,8 @@
    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA. */
 
 #include <sys/socket.h>
+#include <sys/mman.h>
+#include <sys/param.h>
 
 #include <hurd/pipe.h>
 
@@ -26,6 +28,7 @@
 #include "connq.h"
 
 #include "socket_S.h"
+#include "socket_accept_S.h"
 
 /* Connect two sockets */
 kern_return_t
@@ -221,6 +224,107 @@ S_socket_accept (struct sock_user *user,
   return err;
 }
 
+/* The most connections socket_accept_many returns at once.  */
+#define ACCEPT_MANY_MAX 64
+
+/* Return up to MAX_CONNS connections from a socket previously listened.  */
+kern_return_t
+S_socket_accept_many (struct sock_user *user, int max_conns,
+		      mach_port_t **conns, mach_msg_type_name_t *conns_type,
+		      mach_msg_type_number_t *num_conns,
+		      mach_port_t **addrs, mach_msg_type_name_t *addrs_type,
+		      mach_msg_type_number_t *num_addrs)
+{
+  error_t err;
+  struct sock *sock;
+  struct sock *peers[ACCEPT_MANY_MAX];
+  struct timespec noblock = {0, 0};
+  mach_port_t *conns_buf = *conns, *addrs_buf = *addrs;
+  unsigned num, i, n;
+  size_t size;
+
+  if (!user)
+    return EOPNOTSUPP;
+  if (max_conns <= 0)
+    return EINVAL;
+
+  sock = user->sock;
+  num = MIN (max_conns, ACCEPT_MANY_MAX);
+  size = num * sizeof (mach_port_t);
+
+  /* Get the space for the reply first, as we could not give back the
+     connections once we have taken them.  */
+  if (*num_conns < num)
+    {
+      conns_buf = mmap (0, size, PROT_READ|PROT_WRITE, MAP_ANON, 0, 0);
+      if (conns_buf == MAP_FAILED)
+	return ENOMEM;
+    }
+  if (*num_addrs < num)
+    {
+      addrs_buf = mmap (0, size, PROT_READ|PROT_WRITE, MAP_ANON, 0, 0);
+      if (addrs_buf == MAP_FAILED)
+	{
+	  addrs_buf = *addrs;
+	  err = ENOMEM;
+	  goto lose;
+	}
+    }
+
+  err = ensure_connq (sock);
+  if (!err)
+    err = connq_listen_many (sock->listen_queue,
+			     (sock->flags & PFLOCAL_SOCK_NONBLOCK)
+			     ? &noblock : NULL,
+			     peers, &num);
+  if (err)
+    goto lose;
+
+  n = 0;
+  for (i = 0; i < num; i++)
+    {
+      struct addr *peer_addr;
+
+      /* Release the reference for the connection request in the queue */
+      sock_deref (sock);
+
+      err = sock_create_port (peers[i], &conns_buf[n]);
+      if (err)
+	{
+	  /* Nobody has PEERS[I] yet; tear it down, which the client
+	     sees as the connection being closed.  */
+	  sock_free (peers[i]);
+	  continue;
+	}
+
+      if (sock_get_addr (peers[i], &peer_addr) == 0)
+	{
+	  addrs_buf[n] = ports_get_right (peer_addr);
+	  ports_port_deref (peer_addr);
+	}
+      else
+	addrs_buf[n] = MACH_PORT_NULL;
+      n++;
+    }
+  if (n == 0)
+    goto lose;
+
+  *conns = conns_buf;
+  *addrs = addrs_buf;
+  *conns_type = MACH_MSG_TYPE_MAKE_SEND;
+  *addrs_type = MACH_MSG_TYPE_MAKE_SEND;
+  *num_conns = n;
+  *num_addrs = n;
+  return 0;
+
+ lose:
+  if (conns_buf != *conns)
+    munmap (conns_buf, size);
+  if (addrs_buf != *addrs)
+    munmap (addrs_buf, size);
+  return err;
+}
+
 /* Bind a socket to an address.  */
 kern_return_t
 S_socket_bind (struct sock_user *user, struct addr *addr)
@@ -506,6 +610,15 @@ S_socket_getopt (struct sock_user *user,
 	    *(int *)*value = sock->req_write_limit;
 	  *value_len = sizeof (int);
 	  break;
+	case SO_REUSEPORT:
+	  if (*value_len < sizeof (int))
+	    {
+	      ret = EINVAL;
+	      break;
+	    }
+	  *(int *)*value = !!(sock->flags & PFLOCAL_SOCK_REUSEPORT);
+	  *value_len = sizeof (int);
+	  break;
 	case SO_ERROR:
 	  /* We do not have asynchronous operations (such as connect), so no
 	     error to report.  */
@@ -627,6 +740,20 @@ S_socket_setopt (struct sock_user *user,
 	    break;
 	  }
 
+	case SO_REUSEPORT:
+	  /* Let other sockets of ours bind to the same address, see
+	     sock_bind.  */
+	  if (value_len < sizeof (int))
+	    {
+	      ret = EINVAL;
+	      break;
+	    }
+	  if (*(int *)value)
+	    sock->flags |= PFLOCAL_SOCK_REUSEPORT;
+	  else
+	    sock->flags &= ~PFLOCAL_SOCK_REUSEPORT;
+	  break;
+
 	default:
 	  ret = ENOPROTOOPT;
 	  break;
@@ -1,6 +1,6 @@
 /* Server for socket ops
 
-   Copyright (C) 1995, 1997, 2013 Free Software Foundation, Inc.
+   Copyright (C) 1995, 1997, 2013, 2026 Free Software Foundation, Inc.
 
    Written by Miles Bader <miles@gnu.ai.mit.edu>
 
@@ -33,8 +33,10 @@ static int sock_server_active = 0;
 static pthread_spinlock_t sock_server_active_lock = PTHREAD_SPINLOCK_INITIALIZER;
 
 #include "io_S.h"
+#include "io_event_S.h"
 #include "fs_S.h"
 #include "socket_S.h"
+#include "socket_accept_S.h"
 #include "../libports/interrupt_S.h"
 #include "../libports/notify_S.h"
 
@@ -44,8 +46,10 @@ sock_demuxer (mach_msg_header_t *inp, mach_msg_header_t *outp)
 {
   mig_routine_t routine;
   if ((routine = io_server_routine (inp)) ||
+      (routine = io_event_server_routine (inp)) ||
       (routine = fs_server_routine (inp)) ||
       (routine = socket_server_routine (inp)) ||
+      (routine = socket_accept_server_routine (inp)) ||
       (routine = ports_interrupt_server_routine (inp)) ||
       (routine = ports_notify_server_routine (inp)))
     {
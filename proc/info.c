@@ -28,7 +28,9 @@
 #include <stdio.h>
 #include <errno.h>
 #include <string.h>
+#include <stddef.h>
 #include <sys/resource.h>
+#include <sys/time.h>
 #include <assert-backtrace.h>
 #include <hurd/msg.h>
 
@@ -477,6 +479,84 @@ S_proc_getprocenv (struct proc *callerp,
 #define PI_FETCH_THREAD_DETAILS  \
   (PI_FETCH_THREAD_SCHED | PI_FETCH_THREAD_BASIC | PI_FETCH_THREAD_WAITS)
 
+/* The statistics that can be served from a process's cache.  Thread
+   waits are obtained from the process itself and are never cached.  */
+#define PI_FETCH_CACHEABLE \
+  (PI_FETCH_TASKINFO | PI_FETCH_TASKEVENTS | PI_FETCH_THREADS \
+   | PI_FETCH_THREAD_BASIC | PI_FETCH_THREAD_SCHED)
+
+/* Where the statistics start in struct procinfo.  */
+#define PI_STATS_OFFSET  offsetof (struct procinfo, taskinfo)
+
+int stats_max_age = 100;
+
+/* Discard the statistics cached for P, because they are known to be
+   out of date.  Bumping the generation keeps statistics collected
+   before now from being stored afterwards.  */
+void
+proc_stats_invalidate (struct proc *p)
+{
+  free (p->p_stats);
+  p->p_stats = NULL;
+  p->p_stats_gen++;
+}
+
+/* Return P's cached statistics if they can satisfy a request for FLAGS
+   and are recent enough, or null.  */
+static struct proc_stats *
+proc_stats_lookup (struct proc *p, int flags)
+{
+  struct proc_stats *ps = p->p_stats;
+  struct timeval now, age;
+
+  if (!ps || stats_max_age <= 0 || (flags & PI_FETCH_THREAD_WAITS)
+      || (flags & PI_FETCH_CACHEABLE & ~ps->ps_flags))
+    return NULL;
+
+  gettimeofday (&now, NULL);
+  timersub (&now, &ps->ps_stamp, &age);
+  if (age.tv_sec < 0
+      || age.tv_sec * 1000 + age.tv_usec / 1000 >= stats_max_age)
+    {
+      proc_stats_invalidate (p);
+      return NULL;
+    }
+
+  return ps;
+}
+
+/* Remember the statistics in PI, which satisfies a request for FLAGS,
+   as P's cached statistics.  */
+static void
+proc_stats_store (struct proc *p, int flags,
+		  const struct procinfo *pi, size_t structsize)
+{
+  struct proc_stats *ps;
+  size_t len = structsize - PI_STATS_OFFSET;
+
+  flags &= PI_FETCH_CACHEABLE;
+  if (stats_max_age <= 0 || !flags)
+    return;
+
+  ps = p->p_stats;
+  if (!ps || ps->ps_len != len)
+    {
+      ps = realloc (ps, sizeof *ps + len);
+      if (!ps)
+	{
+	  proc_stats_invalidate (p);
+	  return;
+	}
+      p->p_stats = ps;
+    }
+
+  gettimeofday (&ps->ps_stamp, NULL);
+  ps->ps_flags = flags;
+  ps->ps_nthreads = pi->nthreads;
+  ps->ps_len = len;
+  memcpy (ps->ps_data, (const char *) pi + PI_STATS_OFFSET, len);
+}
+
 /* Implement proc_getprocinfo as described in <hurd/process.defs>. */
 kern_return_t
 S_proc_getprocinfo (struct proc *callerp,
@@ -501,6 +581,8 @@ S_proc_getprocinfo (struct proc *callerp,
   task_t task;			/* P's task port.  */
   mach_port_t msgport;		/* P's msgport, or MACH_PORT_NULL if none.  */
   int owned;
+  struct proc_stats *cached;	/* P's statistics, if we can use them.  */
+  unsigned int stats_gen;	/* P's p_stats_gen when we unlocked.  */
 
   /* No need to check CALLERP here; we don't use it. */
 
@@ -591,7 +673,10 @@ S_proc_getprocinfo (struct proc *callerp,
   if (*flags & PI_FETCH_THREAD_DETAILS)
     *flags |= PI_FETCH_THREADS;
 
-  if (*flags & PI_FETCH_THREADS)
+  cached = proc_stats_lookup (p, *flags);
+  if (cached)
+    nthreads = (*flags & PI_FETCH_THREADS) ? cached->ps_nthreads : 0;
+  else if (*flags & PI_FETCH_THREADS)
     {
       err = task_threads (p->p_task, &thds, &nthreads);
       if (err == MACH_SEND_INVALID_DEST)
@@ -612,7 +697,7 @@ S_proc_getprocinfo (struct proc *callerp,
       if (*piarray == MAP_FAILED)
 	{
 	  err = errno;
-	  if (*flags & PI_FETCH_THREADS)
+	  if (!cached && (*flags & PI_FETCH_THREADS))
 	    {
 	      for (i = 0; i < nthreads; i++)
 		mach_port_deallocate (mach_task_self (), thds[i]);
@@ -656,8 +741,19 @@ S_proc_getprocinfo (struct proc *callerp,
 
   pi->nthreads = nthreads;
 
+  if (cached)
+    {
+      /* The cache covers everything that was asked for, and holds at
+	 least as many bytes as we need.  */
+      memcpy ((char *) pi + PI_STATS_OFFSET, cached->ps_data,
+	      structsize - PI_STATS_OFFSET);
+      *waits_len = 0;
+      return 0;
+    }
+
   /* Release GLOBAL_LOCK around time consuming bits, and more importatantly,
      potential calls to P's msgport, which can block.  */
+  stats_gen = p->p_stats_gen;
   pthread_mutex_unlock (&global_lock);
 
   if (*flags & PI_FETCH_TASKINFO)
@@ -821,6 +917,13 @@ S_proc_getprocinfo (struct proc *callerp,
   /* Reacquire GLOBAL_LOCK to make the central locking code happy.  */
   pthread_mutex_lock (&global_lock);
 
+  /* P may have died and been freed while we were not holding the lock,
+     so look it up again before caching what we got.  If P stopped,
+     continued or exec'd meanwhile, what we got may predate that.  */
+  if (!err && pid_find (pid) == p && p->p_task == task
+      && p->p_stats_gen == stats_gen)
+    proc_stats_store (p, *flags, pi, structsize);
+
   return err;
 }
 
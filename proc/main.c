@@ -144,11 +144,15 @@ open_console (mach_port_t device_master)
 static task_t kernel_task;
 
 #define OPT_KERNEL_TASK	-1
+#define OPT_STATS_MAX_AGE	-2
 
 static struct argp_option
 options[] =
 {
   {"kernel-task", OPT_KERNEL_TASK, "PORT"},
+  {"stats-max-age", OPT_STATS_MAX_AGE, "MSECS", 0,
+   "Answer repeated process information queries from a cache for up to"
+   " MSECS milliseconds (default 100; 0 disables the cache)"},
   {0}
 };
 
@@ -160,6 +164,9 @@ parse_opt (int key, char *arg, struct argp_state *state)
     case OPT_KERNEL_TASK:
       kernel_task = atoi (arg);
       break;
+    case OPT_STATS_MAX_AGE:
+      stats_max_age = atoi (arg);
+      break;
     default: return ARGP_ERR_UNKNOWN;
     }
   return 0;
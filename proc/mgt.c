@@ -244,6 +244,14 @@ S_proc_child (struct proc *parentp,
     childp->p_sib->p_prevsib = childp->p_prevsib;
   *childp->p_prevsib = childp->p_sib;
 
+  if (childp->p_pendprevp)
+    {
+      /* Move the pending status change along with the child.  */
+      child_unpending (childp);
+      childp->p_parent = parentp;
+      child_pending (childp);
+    }
+
   childp->p_parent = parentp;
   childp->p_sib = parentp->p_ochild;
   childp->p_prevsib = &parentp->p_ochild;
@@ -310,6 +318,7 @@ S_proc_reassign (struct proc *p,
   task_terminate (p->p_task);
   mach_port_deallocate (mach_task_self (), p->p_task);
   p->p_task = stubp->p_task;
+  proc_stats_invalidate (p);
 
   /* For security, we need to use the request port from STUBP */
   ports_transfer_right (p, stubp);
@@ -459,6 +468,7 @@ S_proc_reauthenticate_reassign (struct proc *p,
 
   p->p_task = stubp->p_task;
   stubp->p_task = MACH_PORT_NULL;
+  proc_stats_invalidate (p);
   ports_destroy_right (stubp);
   ports_reallocate_from_external (p, new_proc_port);
 
@@ -1110,6 +1120,23 @@ process_has_exited (struct proc *p)
       reparent_to->p_ochild = p->p_ochild;
       p->p_ochild->p_prevsib = &reparent_to->p_ochild;
 
+      /* Hand over the pending status changes too, and wake the new
+	 parent if it is waiting for them.  */
+      if (p->p_pending)
+	{
+	  while (p->p_pending)
+	    {
+	      tp = p->p_pending;
+	      child_unpending (tp);
+	      child_pending (tp);
+	    }
+	  if (reparent_to->p_waiting)
+	    {
+	      pthread_cond_broadcast (&reparent_to->p_wakeup);
+	      reparent_to->p_waiting = 0;
+	    }
+	}
+
       if (isdead)
 	alert_parent (reparent_to);
     }
@@ -1140,6 +1167,7 @@ complete_exit (struct proc *p)
   assert_backtrace (p->p_waited);
 
   remove_proc_from_hash (p);
+  proc_stats_invalidate (p);
   if (p->p_task != MACH_PORT_NULL)
     {
       mach_port_deallocate (mach_task_self (), p->p_task);
@@ -1150,6 +1178,7 @@ complete_exit (struct proc *p)
   if (p->p_sib)
     p->p_sib->p_prevsib = p->p_prevsib;
   *p->p_prevsib = p->p_sib;
+  child_unpending (p);
 
   leave_pgrp (p);
 
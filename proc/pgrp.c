@@ -481,6 +481,7 @@ S_proc_mark_exec (struct proc *p)
   if (!p)
     return EOPNOTSUPP;
   p->p_exec = 1;
+  proc_stats_invalidate (p);
   return 0;
 }
 
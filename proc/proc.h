@@ -54,6 +54,11 @@ struct proc
   struct proc *p_ochild;	/* youngest child */
   struct proc *p_sib, **p_prevsib; /* next youngest sibling */
 
+  /* Children with a status change not yet reported by wait, so that
+     wait need not scan every child.  */
+  struct proc *p_pending;	/* first child with a pending status */
+  struct proc *p_pendnext, **p_pendprevp; /* null p_pendprevp if none */
+
   /* Process group structure */
   struct pgrp *p_pgrp;
 
@@ -80,6 +85,10 @@ struct proc
    * grandchildren and their descendants.  */
   struct rusage p_child_rusage;
 
+  /* Task and thread statistics last returned by proc_getprocinfo.  */
+  struct proc_stats *p_stats;	/* null if none are cached */
+  unsigned int p_stats_gen;	/* bumped when they are invalidated */
+
   unsigned int p_exec:1;	/* has called proc_mark_exec */
   unsigned int p_stopped:1;	/* has called proc_mark_stop */
   unsigned int p_waited:1;	/* stop has been reported to parent */
@@ -117,6 +126,17 @@ struct session
   mach_port_t s_sessionid;	/* receive right */
 };
 
+/* A sample of the statistics the kernel keeps for a process, kept so
+   that repeated proc_getprocinfo calls need not ask it again.  */
+struct proc_stats
+{
+  struct timeval ps_stamp;	/* when the sample was taken */
+  int ps_flags;			/* PI_FETCH_* bits the sample satisfies */
+  int ps_nthreads;
+  size_t ps_len;		/* size of PS_DATA */
+  char ps_data[0];		/* struct procinfo from the taskinfo member on */
+};
+
 struct login
 {
   int l_refcnt;
@@ -157,6 +177,8 @@ extern pthread_mutex_t global_lock;
 
 extern int startup_fallback;	/* (ab)use /hurd/startup's message port */
 
+extern int stats_max_age;	/* msecs to keep cached statistics; 0 for none */
+
 /* Forward declarations */
 void complete_wait (struct proc *, int);
 int check_uid (struct proc *, uid_t);
@@ -209,10 +231,13 @@ error_t namespace_translate_pids (mach_port_t namespace, pid_t *pids, size_t pid
 struct proc *namespace_find_root (struct proc *);
 void process_has_exited (struct proc *);
 void alert_parent (struct proc *);
+void child_pending (struct proc *);
+void child_unpending (struct proc *);
 void reparent_zombies (struct proc *);
 void complete_exit (struct proc *);
 
 void initialize_version_info (void);
+void proc_stats_invalidate (struct proc *);
 
 void send_signal (mach_port_t, int, int, mach_port_t);
 
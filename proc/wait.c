@@ -149,6 +149,57 @@ waiter_cares (pid_t wait_pid, pid_t mypgrp,
 	  (wait_pid == WAIT_MYPGRP && pgrp == mypgrp));
 }
 
+/* CHILD has a status change to report to its parent.  Queue it on
+   the parent's list of pending children, unless it is already there.  */
+void
+child_pending (struct proc *child)
+{
+  struct proc *parent = child->p_parent;
+
+  if (child->p_pendprevp)
+    return;
+
+  child->p_pendnext = parent->p_pending;
+  child->p_pendprevp = &parent->p_pending;
+  if (parent->p_pending)
+    parent->p_pending->p_pendprevp = &child->p_pendnext;
+  parent->p_pending = child;
+}
+
+/* CHILD has no status change left to report; remove it from its
+   parent's list of pending children if it is there.  */
+void
+child_unpending (struct proc *child)
+{
+  if (! child->p_pendprevp)
+    return;
+
+  *child->p_pendprevp = child->p_pendnext;
+  if (child->p_pendnext)
+    child->p_pendnext->p_pendprevp = child->p_pendprevp;
+  child->p_pendnext = NULL;
+  child->p_pendprevp = NULL;
+}
+
+/* Return nonzero if P has a child in the process group PGID.  Rather
+   than scanning all of P's children, look through the members of the
+   process group.  */
+static int
+has_child_in_pgrp (struct proc *p, pid_t pgid)
+{
+  struct pgrp *pg;
+  struct proc *tp;
+
+  pg = pgrp_find (pgid);
+  if (!pg)
+    return 0;
+
+  for (tp = pg->pg_plist; tp; tp = tp->p_gnext)
+    if (tp->p_parent == p)
+      return 1;
+  return 0;
+}
+
 /* A process is dying.  Send SIGCHLD to the parent.
    Wake the parent if it is waiting for us to exit. */
 void
@@ -167,6 +218,8 @@ alert_parent (struct proc *p)
       p->p_sigcode = -1;
     }
 
+  child_pending (p);
+
   if (p->p_parent->p_waiting)
     {
       pthread_cond_broadcast (&p->p_parent->p_wakeup);
@@ -204,6 +257,7 @@ S_proc_waitid (struct proc *p,
       if (!(options & WNOWAIT))
       {
 	child->p_waited = 1;
+	child_unpending (child);
 	if (child->p_dead)
 	  complete_exit (child);
       }
@@ -230,19 +284,20 @@ S_proc_waitid (struct proc *p,
     }
   else
     {
-      struct proc *child;
-      int had_a_match = pid == 0;
-
-      for (child = p->p_ochild; child; child = child->p_sib)
-	if (waiter_cares (pid, p->p_pgrp->pg_pgid,
-			  child->p_pid, child->p_pgrp->pg_pgid))
-	  {
-	    if (reap (child))
-	      return 0;
-	    had_a_match = 1;
-	  }
-
-      if (!had_a_match)
+      struct proc *child, *next;
+
+      /* Only children with a pending status change can satisfy the
+	 request, so there is no need to look at the others.  */
+      for (child = p->p_pending; child; child = next)
+	{
+	  next = child->p_pendnext;
+	  if (waiter_cares (pid, p->p_pgrp->pg_pgid,
+			    child->p_pid, child->p_pgrp->pg_pgid)
+	      && reap (child))
+	    return 0;
+	}
+
+      if (pid < WAIT_ANY && !has_child_in_pgrp (p, -pid))
 	return ECHILD;
     }
 
@@ -285,9 +340,11 @@ S_proc_mark_stop (struct proc *p,
 
   p->p_stopped = 1;
   p->p_continued = 0;
+  proc_stats_invalidate (p);
   p->p_status = W_STOPCODE (signo);
   p->p_sigcode = sigcode;
   p->p_waited = 0;
+  child_pending (p);
 
   if (p->p_parent->p_waiting)
     {
@@ -320,6 +377,7 @@ S_proc_mark_exit (struct proc *p,
 
   p->p_exiting = 1;
   p->p_status = status;
+  proc_stats_invalidate (p);
   p->p_sigcode = sigcode;
   return 0;
 }
@@ -333,8 +391,10 @@ S_proc_mark_cont (struct proc *p)
 
   p->p_stopped = 0;
   p->p_continued = 1;
+  proc_stats_invalidate (p);
   p->p_status = __W_CONTINUED;
   p->p_waited = 0;
+  child_pending (p);
 
   if (p->p_parent->p_waiting)
     {
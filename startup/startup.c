@@ -44,6 +44,7 @@
 #include <hurd/msg_server.h>
 #include <wire.h>
 #include <sys/wait.h>
+#include <sys/time.h>
 #include <error.h>
 #include <hurd/msg_reply.h>
 #include <argz.h>
@@ -160,7 +161,143 @@ static size_t startup_envz_len;
 
 void launch_system (void);
 void process_signal (int signo);
-
+
+/** Boot stages **/
+
+/* The boot sequence is described as a dependency graph of stages.  A
+   stage is run as soon as every stage it depends on is complete, so
+   that work which only needs some of the core servers does not wait
+   for all of them.  The time at which each stage completes is
+   recorded and reported if we are verbose.  */
+enum boot_stage
+  {
+    STAGE_PROC,			/* proc called startup_procinit.  */
+    STAGE_AUTH,			/* auth called startup_authinit.  */
+    STAGE_CORE,			/* proc and auth are fully set up.  */
+    STAGE_ESS_AUTH,		/* Essential tasks have registered.  */
+    STAGE_ESS_PROC,
+    STAGE_ESS_EXEC,
+    STAGE_ESS_FS,
+    STAGE_KERNEL,		/* The kernel process has been frobbed.  */
+    STAGE_STDARRAYS,		/* The standard exec data is set.  */
+    STAGE_SYSTEM,		/* Userland has been launched.  */
+    STAGE_MAX
+  };
+
+#define STAGE(s)	(1U << (s))
+
+void launch_core_servers (void);
+void init_stdarrays (void);
+void frob_kernel_process (void);
+
+static void stage_launch_system (void);
+
+static const struct boot_stage_desc
+{
+  const char *name;
+  unsigned int deps;		/* Mask of stages that must be complete.  */
+  void (*run) (void);		/* Called once DEPS are all complete.  */
+} boot_stages[STAGE_MAX] =
+  {
+    [STAGE_PROC] = { "proc", 0, NULL },
+    [STAGE_AUTH] = { "auth", 0, NULL },
+    [STAGE_CORE] = { "core servers", STAGE (STAGE_PROC) | STAGE (STAGE_AUTH),
+		     launch_core_servers },
+    [STAGE_ESS_AUTH] = { "auth essential", 0, NULL },
+    [STAGE_ESS_PROC] = { "proc essential", 0, NULL },
+    [STAGE_ESS_EXEC] = { "exec essential", 0, NULL },
+    [STAGE_ESS_FS] = { "fs essential", 0, NULL },
+    [STAGE_KERNEL] = { "kernel process",
+		       STAGE (STAGE_CORE) | STAGE (STAGE_ESS_PROC),
+		       frob_kernel_process },
+    [STAGE_STDARRAYS] = { "exec data",
+			  STAGE (STAGE_CORE) | STAGE (STAGE_ESS_AUTH)
+			  | STAGE (STAGE_ESS_PROC) | STAGE (STAGE_ESS_FS),
+			  init_stdarrays },
+    [STAGE_SYSTEM] = { "system",
+		       STAGE (STAGE_KERNEL) | STAGE (STAGE_STDARRAYS)
+		       | STAGE (STAGE_ESS_EXEC),
+		       stage_launch_system },
+  };
+
+/* Mask of the stages that are complete, and of those that are running
+   or complete.  */
+static unsigned int stages_done, stages_started;
+
+/* When we started, and when each stage completed.  */
+static struct timeval boot_start;
+static struct timeval stage_time[STAGE_MAX];
+
+static long
+stage_elapsed_ms (const struct timeval *tv)
+{
+  return (tv->tv_sec - boot_start.tv_sec) * 1000
+    + (tv->tv_usec - boot_start.tv_usec) / 1000;
+}
+
+/* Print when each stage of the boot completed.  */
+static void
+report_boot_stages (void)
+{
+  int s;
+
+  fprintf (stderr, "Boot stage timings:\n");
+  for (s = 0; s < STAGE_MAX; s++)
+    if (stages_done & STAGE (s))
+      fprintf (stderr, "  %-16s %6ld ms\n",
+	       boot_stages[s].name, stage_elapsed_ms (&stage_time[s]));
+}
+
+/* Record that STAGE has completed.  */
+static void
+stage_complete (enum boot_stage stage)
+{
+  stages_started |= STAGE (stage);
+  stages_done |= STAGE (stage);
+  gettimeofday (&stage_time[stage], NULL);
+
+  if (verbose)
+    fprintf (stderr, "Boot stage `%s' complete after %ld ms\n",
+	     boot_stages[stage].name, stage_elapsed_ms (&stage_time[stage]));
+}
+
+/* Mark STAGE as complete, and run every stage that this makes ready.
+   Stages that become ready while another stage is running are run
+   once it finishes, so stages never nest.  */
+static void
+boot_stage_done (enum boot_stage stage)
+{
+  static int running;
+  int progress;
+
+  stage_complete (stage);
+
+  if (running)
+    return;
+
+  running = 1;
+  do
+    {
+      int s;
+
+      progress = 0;
+      for (s = 0; s < STAGE_MAX; s++)
+	if (boot_stages[s].run
+	    && ! (stages_started & STAGE (s))
+	    && (stages_done & boot_stages[s].deps) == boot_stages[s].deps)
+	  {
+	    stages_started |= STAGE (s);
+	    (*boot_stages[s].run) ();
+	    stage_complete (s);
+	    if (verbose && s == STAGE_SYSTEM)
+	      report_boot_stages ();
+	    progress = 1;
+	  }
+    }
+  while (progress);
+  running = 0;
+}
+
 /** Utility functions **/
 
 /* Read a string from stdin into BUF.  */
@@ -755,6 +892,7 @@ main (int argc, char **argv, char **envp)
     error (2, 0, "can only be run by bootstrap filesystem");
 
   global_argv = argv;
+  gettimeofday (&boot_start, NULL);
 
   /* Fetch a port to the bootstrap filesystem, the host priv and
      master device ports, and the console.  */
@@ -1409,6 +1547,14 @@ launch_system (void)
   if (verbose)
     fprintf (stderr, "Init has completed\n");
 }
+
+/* Run userland once all the essential servers are up.  */
+static void
+stage_launch_system (void)
+{
+  launch_system ();
+  booted = 1;
+}
 
 /** RPC servers **/
 
@@ -1437,8 +1583,7 @@ S_startup_procinit (startup_t server,
   procreplytype = reply_porttype;
 
   /* Save the reply port until we get startup_authinit.  */
-  if (authserver)
-    launch_core_servers ();
+  boot_stage_done (STAGE_PROC);
 
   return MIG_NO_REPLY;
 }
@@ -1466,8 +1611,7 @@ S_startup_authinit (startup_t server,
   authreply = reply;
   authreplytype = reply_porttype;
 
-  if (procserver)
-    launch_core_servers ();
+  boot_stage_done (STAGE_AUTH);
 
   return MIG_NO_REPLY;
 }
@@ -1482,7 +1626,7 @@ S_startup_essential_task (mach_port_t server,
 			  const_string_t name,
 			  mach_port_t credential)
 {
-  static int authinit, procinit, execinit, fsinit;
+  enum boot_stage stage;
   int fail;
 
   if (credential != host_priv)
@@ -1505,19 +1649,19 @@ S_startup_essential_task (mach_port_t server,
   if (!booted)
     {
       if (!strcmp (name, "auth"))
-	authinit = 1;
+	stage = STAGE_ESS_AUTH;
       else if (!strcmp (name, "exec"))
         {
-          execinit = 1;
+          stage = STAGE_ESS_EXEC;
           mach_port_t execproc;
           proc_task2proc (procserver, task, &execproc);
           proc_mark_important (execproc);
           proc_set_exe (execproc, "/hurd/exec");
         }
       else if (!strcmp (name, "proc"))
-	procinit = 1;
+	stage = STAGE_ESS_PROC;
       else if (!strcmp (name, "ext2fs"))
-        fsinit = 1;
+        stage = STAGE_ESS_FS;
       else
         {
           mach_port_t otherproc;
@@ -1525,41 +1669,25 @@ S_startup_essential_task (mach_port_t server,
           proc_task2proc (procserver, task, &otherproc);
           proc_mark_important (otherproc);
           proc_set_exe (otherproc, name);
+          return 0;
         }
 
-      if (verbose)
-        fprintf (stderr, "  still waiting for:");
-
-      if (authinit && execinit && procinit && fsinit)
-	{
-          if (verbose)
-            fprintf (stderr, " none!\n");
-	  /* Reply to this RPC, after that everything
-	     is ready for real startup to begin. */
-	  startup_essential_task_reply (reply, replytype, 0);
-
-	  init_stdarrays ();
-	  frob_kernel_process ();
-
-	  launch_system ();
-
-	  booted = 1;
-
-	  return MIG_NO_REPLY;
-	}
-
       if (verbose)
         {
-          if (! authinit)
-            fprintf (stderr, " auth");
-          if (! execinit)
-            fprintf (stderr, " exec");
-          if (! procinit)
-            fprintf (stderr, " proc");
-          if (! fsinit)
-            fprintf (stderr, " fs");
+          int s;
+
+          fprintf (stderr, "  still waiting for:");
+          for (s = STAGE_ESS_AUTH; s <= STAGE_ESS_FS; s++)
+            if (s != stage && ! (stages_done & STAGE (s)))
+              fprintf (stderr, " %s", boot_stages[s].name);
           fprintf (stderr, "\n");
         }
+
+      /* Reply to this RPC before running the stages this makes
+	 ready, which may in turn make requests of the caller.  */
+      startup_essential_task_reply (reply, replytype, 0);
+      boot_stage_done (stage);
+      return MIG_NO_REPLY;
     }
 
   return 0;
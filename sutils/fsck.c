@@ -1,6 +1,6 @@
 /* Hurd-aware fsck wrapper
 
-   Copyright (C) 1996, 97, 98, 99 Free Software Foundation, Inc.
+   Copyright (C) 1996, 97, 98, 99, 2026 Free Software Foundation, Inc.
 
    Written by Miles Bader <miles@gnu.org>
 
@@ -39,18 +39,27 @@
    The exit-status from this wrapper is the greatest status returned from any
    individual fsck.
 
+   With --by-device, once the filesystems in pass 1 are done, all the rest
+   are checked at once regardless of their pass numbers, except that two
+   filesystems on the same disk (as found by looking at their storage with
+   libstore) are never checked at the same time.
+
    Although it knows something about the hurd, this fsck still uses
    /etc/fstab, and is generally not very integrated.  That will have to wait
    until the appropriate mechanisms for doing so are decided.  */
 
 #include <stdlib.h>
 #include <string.h>
+#include <ctype.h>
+#include <limits.h>
 #include <unistd.h>
+#include <sys/time.h>
 #include <sys/wait.h>
 #include <error.h>
 #include <argp.h>
 #include <argz.h>
 #include <assert-backtrace.h>
+#include <hurd/store.h>
 #include <version.h>
 
 #include "fstab.h"
@@ -96,6 +105,7 @@ static int _debug = 0;
 #define FSCK_F_WRITABLE	0x200	/* Make writable after fscking.  */
 #define FSCK_F_AUTO	0x400	/* Do all filesystems in fstab.  */
 #define FSCK_F_DRYRUN	0x800	/* Don't actually do anything.  */
+#define FSCK_F_BY_DEVICE 0x1000	/* Schedule by disk rather than by pass.  */
 
 static int got_sigquit = 0, got_sigint = 0;
 
@@ -114,6 +124,9 @@ struct fsck
   struct fs *fs;		/* Filesystem being fscked.  */
   int pid;			/* Pid for process.  */
   int make_writable;		/* Make writable after fscking if possible.  */
+  char *disks;			/* Argz vector of the disks FS is on.  */
+  size_t disks_len;
+  struct timeval start;		/* When the fsck was started.  */
   struct fsck *next, **self;
 };
 
@@ -200,10 +213,12 @@ fs_start_fsck (struct fs *fs, int flags)
 
 /* Start a fsck process for FS running, and add an entry for it to FSCKS.
    This also ensures that if FS is currently mounted, it will be made
-   readonly first.  If the fsck is successfully started, 0 is returned,
-   otherwise FSCK_EX_ERROR.  */
+   readonly first.  DISKS and DISKS_LEN, if non-zero, are an argz vector
+   of the disks FS is on, which is consumed.  If the fsck is successfully
+   started, 0 is returned, otherwise FSCK_EX_ERROR.  */
 static int
-fscks_start_fsck (struct fscks *fscks, struct fs *fs)
+fscks_start_fsck (struct fscks *fscks, struct fs *fs,
+		  char *disks, size_t disks_len)
 {
   error_t err;
   int mounted, make_writable;
@@ -273,6 +288,9 @@ fscks_start_fsck (struct fscks *fscks, struct fs *fs)
 
   fsck->fs = fs;
   fsck->make_writable = make_writable;
+  fsck->disks = disks;
+  fsck->disks_len = disks_len;
+  gettimeofday (&fsck->start, 0);
   fsck->next = fscks->running;
   if (fsck->next)
     fsck->next->self = &fsck->next;
@@ -324,6 +342,7 @@ fsck_cleanup (struct fsck *fsck, int remount, int make_writable)
 	}
     }
 
+   free (fsck->disks);
    free (fsck);
 }
 
@@ -368,6 +387,18 @@ fscks_wait (struct fscks *fscks)
 	    int remount = (status != 0);
 	    int make_writable = (status == 0 || FSCK_EX_IS_FIXED (status));
 	    fs_debug (fsck->fs, "Fsck finished (status = %d)", status);
+	    if ((fscks->flags & FSCK_F_VERBOSE)
+		|| ((fscks->flags & FSCK_F_BY_DEVICE)
+		    && ! (fscks->flags & FSCK_F_SILENT)))
+	      {
+		struct timeval now;
+		gettimeofday (&now, 0);
+		timersub (&now, &fsck->start, &now);
+		printf ("%s: %s: finished in %ld.%02lds (status %d)\n",
+			program_invocation_name, fsck->fs->mntent.mnt_fsname,
+			(long) now.tv_sec, (long) now.tv_usec / 10000, status);
+		fflush (stdout);
+	      }
 	    fsck_cleanup (fsck, remount, make_writable);
 	    fscks->free_slots++;
 	    break;
@@ -396,6 +427,249 @@ fscks_wait (struct fscks *fscks)
   return status;
 }
 
+/* Returns true if FS can be fscked, otherwise complains as appropriate
+   and merges an error into *STATUS if need be.  */
+static int
+fs_fsckable (struct fs *fs, int flags, int *status)
+{
+  struct fstype *type;
+  error_t err = fs_type (fs, &type);
+
+  if (err)
+    {
+      error (0, err, "%s: Cannot find fsck program (type %s)",
+	     fs->mntent.mnt_dir, fs->mntent.mnt_type);
+      if (*status < FSCK_EX_ERROR)
+	*status = FSCK_EX_ERROR;
+    }
+  else if (type->program)
+    return 1;
+  else if (flags & FSCK_F_AUTO)
+    fs_debug (fs, "Not fsckable");
+  else
+    error (0, 0, "%s: %s: Not a fsckable filesystem type",
+	   fs->mntent.mnt_dir, fs->mntent.mnt_type);
+
+  return 0;
+}
+
+/* Adds to the argz vector DISKS the name of each device underlying STORE,
+   without any partition suffix, so that filesystems on different
+   partitions of the same disk get the same name.  */
+static error_t
+store_disks (struct store *store, char **disks, size_t *disks_len)
+{
+  error_t err = 0;
+
+  if (store->num_children > 0)
+    {
+      size_t i;
+      for (i = 0; i < store->num_children && !err; i++)
+	err = store_disks (store->children[i], disks, disks_len);
+    }
+  else if (store->name)
+    {
+      const char *name = store->name, *end = name + strlen (name);
+      char *disk;
+
+      if (store->class->id == STORAGE_DEVICE)
+	/* Kernel partition devices look like `hd0s1' or `sd0s2a'.  */
+	{
+	  const char *p = end, *q;
+
+	  if (p - name > 1 && islower (p[-1]) && isdigit (p[-2]))
+	    p--;
+	  for (q = p; q > name && isdigit (q[-1]); q--)
+	    ;
+	  if (q < p && q - name > 1 && q[-1] == 's' && isdigit (q[-2]))
+	    end = q - 1;
+	}
+
+      if (asprintf (&disk, "%s:%.*s",
+		    store->class->name, (int) (end - name), name) < 0)
+	return ENOMEM;
+      err = argz_add (disks, disks_len, disk);
+      free (disk);
+    }
+
+  return err;
+}
+
+/* Returns in DISKS and DISKS_LEN an argz vector of the disks FS is on.  If
+   we can't tell, FS's device name is used.  */
+static error_t
+fs_disks (struct fs *fs, char **disks, size_t *disks_len)
+{
+  error_t err;
+  struct store *store;
+  file_t node = file_name_lookup (fs->mntent.mnt_fsname, 0, 0);
+
+  *disks = 0;
+  *disks_len = 0;
+
+  if (node == MACH_PORT_NULL)
+    err = errno;
+  else
+    {
+      err = store_create (node, STORE_INACTIVE | STORE_NO_FILEIO, 0, &store);
+      mach_port_deallocate (mach_task_self (), node);
+      if (! err)
+	{
+	  err = store_disks (store, disks, disks_len);
+	  store_free (store);
+	}
+    }
+
+  if (err || *disks_len == 0)
+    {
+      if (err)
+	fs_debug (fs, "Cannot find underlying disks: %s", strerror (err));
+      else
+	fs_debug (fs, "No underlying disks");
+      free (*disks);
+      *disks = 0;
+      *disks_len = 0;
+      err = argz_add (disks, disks_len, fs->mntent.mnt_fsname);
+    }
+
+  return err;
+}
+
+/* Returns true if the argz vectors A and B have a string in common.  */
+static int
+disks_overlap (const char *a, size_t a_len, const char *b, size_t b_len)
+{
+  const char *p, *q;
+
+  for (p = argz_next (a, a_len, 0); p; p = argz_next (a, a_len, p))
+    for (q = argz_next (b, b_len, 0); q; q = argz_next (b, b_len, q))
+      if (strcmp (p, q) == 0)
+	return 1;
+
+  return 0;
+}
+
+/* Fsck all the filesystems in FSTAB whose pass is between MIN_PASS and
+   MAX_PASS, starting a check whenever the disks its filesystem is on are
+   not being checked already.  At most MAX_PARALLEL fscks are done at once,
+   or if that is 0, as many as there are disks.  FSCKS should have no fscks
+   running, and none are when this returns.  The greatest exit code
+   returned by any one fsck is returned.  */
+static int
+fscks_by_device (struct fscks *fscks, struct fstab *fstab,
+		 int min_pass, int max_pass, int max_parallel)
+{
+  struct job
+  {
+    struct fs *fs;
+    char *disks;
+    size_t disks_len;
+  } *jobs = 0;
+  size_t num_jobs = 0, num_started = 0, i;
+  char *all_disks = 0;
+  size_t all_disks_len = 0;
+  int num_disks = 0;
+  int pass, status = 0;
+  struct fs *fs;
+
+  void merge_status (int st)
+    {
+      if (st > status)
+	status = st;
+    }
+
+  /* Find out what there is to do, in pass order.  */
+  for (fs = fstab->entries; fs; fs = fs->next)
+    num_jobs++;
+  jobs = calloc (num_jobs ?: 1, sizeof *jobs);
+  if (! jobs)
+    {
+      error (0, ENOMEM, "malloc");
+      return FSCK_EX_ERROR;
+    }
+  num_jobs = 0;
+  for (pass = min_pass; pass > 0 && pass <= max_pass;
+       pass = fstab_next_pass (fstab, pass))
+    for (fs = fstab->entries; fs; fs = fs->next)
+      if (fs->mntent.mnt_passno == pass && fs_fsckable (fs, fscks->flags, &status))
+	{
+	  struct job *job = &jobs[num_jobs];
+	  error_t err = fs_disks (fs, &job->disks, &job->disks_len);
+	  const char *disk;
+
+	  if (err)
+	    {
+	      error (0, err, "%s", fs->mntent.mnt_dir);
+	      merge_status (FSCK_EX_ERROR);
+	      continue;
+	    }
+
+	  job->fs = fs;
+	  num_jobs++;
+
+	  for (disk = argz_next (job->disks, job->disks_len, 0); disk;
+	       disk = argz_next (job->disks, job->disks_len, disk))
+	    if (! disks_overlap (disk, strlen (disk) + 1,
+				 all_disks, all_disks_len))
+	      {
+		fs_debug (fs, "On disk %s", disk);
+		if (argz_add (&all_disks, &all_disks_len, disk) == 0)
+		  num_disks++;
+	      }
+	}
+  free (all_disks);
+
+  fscks->free_slots = max_parallel ?: num_disks;
+  debug ("Passes %d-%d: %zu filesystems on %d disks, %d at a time",
+	 min_pass, max_pass, num_jobs, num_disks, fscks->free_slots);
+
+  while (num_started < num_jobs || fscks->running)
+    {
+      int started = 0;
+
+      for (i = 0; i < num_jobs && fscks->free_slots > 0; i++)
+	if (jobs[i].fs)
+	  {
+	    struct fsck *fsck;
+	    int st;
+
+	    for (fsck = fscks->running; fsck; fsck = fsck->next)
+	      if (fsck->pid
+		  && disks_overlap (jobs[i].disks, jobs[i].disks_len,
+				    fsck->disks, fsck->disks_len))
+		break;
+	    if (fsck)
+	      /* One of its disks is busy.  */
+	      continue;
+
+	    num_started++;
+	    if (! (fscks->flags & FSCK_F_SILENT))
+	      {
+		printf ("%s: %s: checking (%zu of %zu)\n",
+			program_invocation_name, jobs[i].fs->mntent.mnt_fsname,
+			num_started, num_jobs);
+		fflush (stdout);
+	      }
+	    st = fscks_start_fsck (fscks, jobs[i].fs,
+				   jobs[i].disks, jobs[i].disks_len);
+	    if (st)
+	      /* It didn't take the disks.  */
+	      free (jobs[i].disks);
+	    merge_status (st);
+	    jobs[i].fs = 0;
+	    started = 1;
+	  }
+
+      if (fscks->running && (!started || fscks->free_slots == 0
+			     || num_started == num_jobs))
+	merge_status (fscks_wait (fscks));
+    }
+
+  free (jobs);
+
+  return status;
+}
+
 /* Fsck all the filesystems in FSTAB, with the flags in FLAGS, doing at most
    MAX_PARALLEL parallel fscks.  The greatest exit code returned by any one
    fsck is returned.  */
@@ -404,7 +678,6 @@ fsck (struct fstab *fstab, int flags, int max_parallel)
 {
   int pass;
   struct fs *fs;
-  int autom = (flags & FSCK_F_AUTO);
   int summary_status = 0;
   struct fscks fscks = { running: 0, flags: flags };
 
@@ -414,6 +687,15 @@ fsck (struct fstab *fstab, int flags, int max_parallel)
 	summary_status = status;
     }
 
+  if (flags & FSCK_F_BY_DEVICE)
+    /* Do the root pass first, as usual, and then everything else.  */
+    {
+      merge_status (fscks_by_device (&fscks, fstab, 1, 1, max_parallel));
+      merge_status (fscks_by_device (&fscks, fstab, 2, INT_MAX,
+				     max_parallel));
+      return summary_status;
+    }
+
   /* Do in pass order; pass 0 is never run, it is reserved for "off".  */
   for (pass = 1; pass > 0; pass = fstab_next_pass (fstab, pass))
     /* Submit all filesystems in the given pass, up to MAX_PARALLEL at a
@@ -425,32 +707,15 @@ fsck (struct fstab *fstab, int flags, int max_parallel)
 
       /* Try and fsck every filesystem in this pass.  */
       for (fs = fstab->entries; fs; fs = fs->next)
-	if (fs->mntent.mnt_passno == pass)
-	  /* FS is applicable for this pass.  */
+	if (fs->mntent.mnt_passno == pass
+	    && fs_fsckable (fs, flags, &summary_status))
+	  /* This is a fsckable filesystem applicable for this pass.  */
 	  {
-	    struct fstype *type;
-	    error_t err = fs_type (fs, &type);
-
-	    if (err)
-	      {
-		error (0, err, "%s: Cannot find fsck program (type %s)",
-		       fs->mntent.mnt_dir, fs->mntent.mnt_type);
-		merge_status (FSCK_EX_ERROR);
-	      }
-	    else if (type->program)
-	      /* This is a fsckable filesystem.  */
-	      {
-		fs_debug (fs, "Fsckable; free_slots = %d", fscks.free_slots);
-		while (fscks.free_slots == 0)
-		  /* No room; wait for another fsck to finish.  */
-		  merge_status (fscks_wait (&fscks));
-		merge_status (fscks_start_fsck (&fscks, fs));
-	      }
-	    else if (autom)
-	      fs_debug (fs, "Not fsckable");
-	    else
-	      error (0, 0, "%s: %s: Not a fsckable filesystem type",
-		     fs->mntent.mnt_dir, fs->mntent.mnt_type);
+	    fs_debug (fs, "Fsckable; free_slots = %d", fscks.free_slots);
+	    while (fscks.free_slots == 0)
+	      /* No room; wait for another fsck to finish.  */
+	      merge_status (fscks_wait (&fscks));
+	    merge_status (fscks_start_fsck (&fscks, fs, 0, 0));
 	  }
 
       /* Now wait for them all to finish.  */
@@ -474,6 +739,9 @@ static const struct argp_option options[] =
   {"force",	 'f', 0,      0, "Check even if clean"},
 
   {"dry-run",	 'N', 0,      0, "Don't check, just show what would be done"},
+  {"by-device",  'd', 0,      0,
+     "After pass 1, check filesystems on different disks in parallel"
+     " regardless of their pass, but never two on the same disk"},
   {0, 0, 0, 0, "In --preen mode, the following also apply:", 2},
   {"silent",     's', 0,      0, "Print only diagnostic messages"},
   {"quiet",      'q', 0,      OPTION_ALIAS | OPTION_HIDDEN },
@@ -507,6 +775,7 @@ main (int argc, char **argv)
 	case 'v': flags |= FSCK_F_VERBOSE; break;
 	case 'w': flags |= FSCK_F_WRITABLE; break;
 	case 'N': flags |= FSCK_F_DRYRUN; break;
+	case 'd': flags |= FSCK_F_BY_DEVICE; break;
 	case 'D': _debug = 1; break;
 	case 'l':
 	  max_parallel = atoi (arg);
@@ -543,7 +812,9 @@ main (int argc, char **argv)
 
   if (max_parallel <= 0)
     {
-      if (flags & FSCK_F_PREEN)
+      if (flags & FSCK_F_BY_DEVICE)
+	max_parallel = 0;	/* One per disk.  */
+      else if (flags & FSCK_F_PREEN)
 	max_parallel = 100;	/* In preen mode, do lots in parallel.  */
       else
 	max_parallel = 1;	/* Do one at a time to keep output rational. */
@@ -1,5 +1,5 @@
 /*
-   Copyright (C) 1995,96,98,99,2000,01,02 Free Software Foundation, Inc.
+   Copyright (C) 1995,96,98,99,2000,01,02,26 Free Software Foundation, Inc.
    Written by Michael I. Bushnell, p/BSG.
 
    This file is part of the GNU Hurd.
@@ -324,6 +324,7 @@ device_write_reply_inband (mach_port_t replypt,
 	  npending_output = 0;
 	  pthread_cond_broadcast (outputq->wait);
 	  pthread_cond_broadcast (&select_alert);
+	  post_select_events ();
 	}
       else
 	{
@@ -1,5 +1,5 @@
 /*
-   Copyright (C) 1995,96,98,99,2000,01,02 Free Software Foundation, Inc.
+   Copyright (C) 1995,96,98,99,2000,01,02,26 Free Software Foundation, Inc.
    Written by Michael I. Bushnell, p/BSG and Marcus Brinkmann.
 
    This file is part of the GNU Hurd.
@@ -305,6 +305,7 @@ hurdio_writer_loop (void *arg)
 	      npending_output = 0;
 	      pthread_cond_broadcast (outputq->wait);
 	      pthread_cond_broadcast (&select_alert);
+	      post_select_events ();
 	    }
 	  else
 	    {
@@ -1,5 +1,5 @@
 /* main.c - A translator that emulates a terminal.
-   Copyright (C) 1995,96,97,2000,02 Free Software Foundation, Inc.
+   Copyright (C) 1995,96,97,2000,02,2026 Free Software Foundation, Inc.
    Written by Michael I. Bushnell, p/BSG.
 
    This file is part of the GNU Hurd.
@@ -35,6 +35,7 @@
 #include "term_S.h"
 #include "tioctl_S.h"
 #include "device_reply_S.h"
+#include "io_event_S.h"
 
 const char *argp_program_version = STANDARD_HURD_VERSION (term);
 
@@ -68,6 +69,7 @@ struct port_class *cttyid_class;
 struct port_class *pty_class;
 struct port_class *pty_cntl_class;
 struct trivfs_control *termctl;
+volatile struct mapped_time_value *term_maptime;
 struct trivfs_control *ptyctl;
 struct queue *inputq, *outputq;
 int remote_input_mode;
@@ -91,6 +93,7 @@ demuxer (mach_msg_header_t *inp, mach_msg_header_t *outp)
   if ((routine = NULL, trivfs_demuxer (inp, outp)) ||
       (routine = term_server_routine (inp)) ||
       (routine = tioctl_server_routine (inp)) ||
+      (routine = io_event_server_routine (inp)) ||
       (routine = device_reply_server_routine (inp)))
     {
       if (routine)
@@ -338,6 +341,11 @@ main (int argc, char **argv)
 
   init_users ();
 
+  /* Without the time, we just update the times of the underlying node on
+     every read and write.  */
+  if (maptime_map_any (&term_maptime))
+    term_maptime = 0;
+
   argp_parse (&term_argp, argc, argv, 0, 0, 0);
 
   switch (tty_type)
@@ -1,5 +1,5 @@
 /*
-   Copyright (C) 2014 Free Software Foundation, Inc.
+   Copyright (C) 2014, 2026 Free Software Foundation, Inc.
    Written by Justus Winter.
 
    This file is part of the GNU Hurd.
@@ -23,6 +23,7 @@
 #define IO_INTRAN_PAYLOAD trivfs_protid_t trivfs_begin_using_protid_payload
 #define IO_DESTRUCTOR trivfs_end_using_protid (trivfs_protid_t)
 #define IO_OUTTRAN io_t trivfs_convert_to_port (trivfs_protid_t)
+#define IO_IMPORTS import "../libtrivfs/mig-decls.h";
 
 #define CTTY_INTRAN					\
   port_info_t begin_using_ctty_port (mach_port_t)
@@ -1,5 +1,5 @@
 /*
-   Copyright (C) 1995, 1996, 1999, 2002 Free Software Foundation, Inc.
+   Copyright (C) 1995, 1996, 1999, 2002, 2026 Free Software Foundation, Inc.
    Written by Michael I. Bushnell, p/BSG.
 
    This file is part of the GNU Hurd.
@@ -34,6 +34,9 @@ static pthread_cond_t pty_read_wakeup = PTHREAD_COND_INITIALIZER;
 
 static pthread_cond_t pty_select_wakeup = PTHREAD_COND_INITIALIZER;
 
+/* Registrations made with io_event_register on the pty master.  */
+static struct iohelp_event *pty_select_events;
+
 /* Set if "dtr" is on. */
 static int dtr_on = 0;
 
@@ -132,6 +135,7 @@ wake_reader (void)
       pty_read_blocked = 0;
       pthread_cond_broadcast (&pty_read_wakeup);
       pthread_cond_broadcast (&pty_select_wakeup);
+      post_select_events ();
     }
 }
 
@@ -511,6 +515,47 @@ pty_io_select (struct trivfs_protid *cred, mach_port_t reply,
     }
 }
 
+/* Return what the pty master is ready for, as pty_io_select sees it.  */
+static int
+pty_select_ready (void)
+{
+  int avail = 0;
+
+  if (control_byte || qsize (outputq) || !(termflags & TTY_OPEN))
+    avail |= SELECT_READ;
+  if (control_byte)
+    avail |= SELECT_URG;
+  if (!remote_input_mode || !qsize (inputq))
+    avail |= SELECT_WRITE;
+
+  return avail;
+}
+
+error_t
+pty_io_event_register (struct trivfs_protid *cred, mach_port_t port,
+		       vm_address_t cookie, int type)
+{
+  error_t err;
+
+  pthread_mutex_lock (&global_lock);
+  err = iohelp_register_event (&pty_select_events, port, cookie, type,
+			       pty_select_ready ());
+  if (pty_select_events)
+    /* Have wake_reader tell us about output.  */
+    pty_read_blocked = 1;
+  pthread_mutex_unlock (&global_lock);
+
+  return err;
+}
+
+/* Called by post_select_events.  */
+void
+pty_post_select_events (void)
+{
+  if (pty_select_events)
+    iohelp_post_events (&pty_select_events, pty_select_ready ());
+}
+
 kern_return_t
 S_tioctl_tiocsig (struct trivfs_protid *cred,
 		  int sig)
@@ -1,5 +1,5 @@
 /*
-   Copyright (C) 1995,96,98,99, 2002 Free Software Foundation, Inc.
+   Copyright (C) 1995,96,98,99, 2002, 2026 Free Software Foundation, Inc.
    Written by Michael I. Bushnell, p/BSG.
 
    This file is part of the GNU Hurd.
@@ -30,6 +30,7 @@
 #include <fcntl.h>
 #include <features.h>
 #include <hurd/hurd_types.h>
+#include <maptime.h>
 
 extern int nperopens;
 
@@ -111,6 +112,11 @@ extern pthread_cond_t select_alert;
 /* Wakeup for pty select, if not null */
 extern pthread_cond_t *pty_select_alert;
 
+/* Post the events registered with io_event_register on the terminal and
+   the pty master that can now be satisfied.  Called, with global_lock
+   held, wherever select_alert or pty_select_alert is broadcast.  */
+void post_select_events (void);
+
 /* Bucket for all our ports. */
 extern struct port_bucket *term_bucket;
 
@@ -135,6 +141,9 @@ extern struct trivfs_control *termctl;
 /* Trivfs control structure for the pty */
 extern struct trivfs_control *ptyctl;
 
+/* The mapped time, or zero if it couldn't be mapped.  */
+extern volatile struct mapped_time_value *term_maptime;
+
 /* The queues we use */
 extern struct queue *inputq, *rawq, *outputq;
 
@@ -234,6 +243,7 @@ clear_queue (struct queue *q)
   q->cs = q->ce = q->array;
   pthread_cond_broadcast (q->wait);
   pthread_cond_broadcast (&select_alert);
+  post_select_events ();
   if (q == inputq && pty_select_alert != NULL)
     pthread_cond_broadcast (pty_select_alert);
 }
@@ -261,6 +271,7 @@ dequeue_quote (struct queue *q)
     {
       pthread_cond_broadcast (q->wait);
       pthread_cond_broadcast (&select_alert);
+      post_select_events ();
       if (q == inputq && pty_select_alert != NULL)
 	pthread_cond_broadcast (pty_select_alert);
       else if (q == outputq)
@@ -295,6 +306,7 @@ enqueue_internal (struct queue **qp, quoted_char c)
     {
       pthread_cond_broadcast (q->wait);
       pthread_cond_broadcast (&select_alert);
+      post_select_events ();
       if (q == inputq)
 	{
 	  if (pty_select_alert != NULL)
@@ -356,6 +368,7 @@ queue_erase (struct queue *q)
     {
       pthread_cond_broadcast (q->wait);
       pthread_cond_broadcast (&select_alert);
+      post_select_events ();
       if (q == inputq && pty_select_alert != NULL)
 	pthread_cond_broadcast (pty_select_alert);
     }
@@ -393,6 +406,9 @@ error_t pty_io_read (struct trivfs_protid *, char **,
 error_t pty_io_readable (size_t *);
 error_t pty_io_select (struct trivfs_protid *, mach_port_t,
 		       struct timespec *, int *);
+error_t pty_io_event_register (struct trivfs_protid *, mach_port_t,
+			       vm_address_t, int);
+void pty_post_select_events (void);
 error_t pty_open_hook (struct trivfs_control *, struct iouser *, int);
 error_t pty_po_create_hook (struct trivfs_peropen *);
 error_t pty_po_destroy_hook (struct trivfs_peropen *);
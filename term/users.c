@@ -1,5 +1,5 @@
 /*
-   Copyright (C) 1995,96,97,98,99,2000,01,02 Free Software Foundation, Inc.
+   Copyright (C) 1995,96,97,98,99,2000,01,02,2026 Free Software Foundation, Inc.
    Written by Michael I. Bushnell, p/BSG.
 
    This file is part of the GNU Hurd.
@@ -44,6 +44,7 @@
 
 #include "term_S.h"
 #include "tioctl_S.h"
+#include "io_event_S.h"
 #include "libtrivfs/trivfs_fs_S.h"
 #include "libtrivfs/trivfs_io_S.h"
 #include <sys/ioctl.h>
@@ -54,6 +55,26 @@
 /* Count of active opens.  */
 int nperopens;
 
+/* When the atime and mtime of the underlying node were last set.  */
+static time_t atime_stamp, mtime_stamp;
+
+/* Set the time at *STAMP of the underlying node with SET, unless that was
+   already done this second: it takes an RPC to the underlying node's
+   server, which would otherwise be done for every read and write.  */
+static void
+set_node_time (error_t (*set) (struct trivfs_control *), time_t *stamp)
+{
+  if (term_maptime)
+    {
+      time_t now = maptime_seconds (term_maptime);
+      if (now == *stamp)
+	return;
+      *stamp = now;
+    }
+
+  (*set) (termctl);
+}
+
 /* io_async requests.  */
 struct async_req
 {
@@ -625,7 +646,7 @@ trivfs_S_io_write (struct trivfs_protid *cred,
   if (!err && datalen)
     (*bottom->start_output) ();
 
-  trivfs_set_mtime (termctl);
+  set_node_time (trivfs_set_mtime, &mtime_stamp);
 
   call_asyncs (O_WRITE);
 
@@ -767,7 +788,7 @@ trivfs_S_io_read (struct trivfs_protid *cred,
 
   /* If we really read something, set atime.  */
   if (*datalen || !cancel)
-    trivfs_set_atime (termctl);
+    set_node_time (trivfs_set_atime, &atime_stamp);
 
   call_asyncs (O_READ);
 
@@ -1939,6 +1960,25 @@ trivfs_S_io_async (struct trivfs_protid *cred,
   return 0;
 }
 
+/* Registrations made with io_event_register on the terminal.  */
+static struct iohelp_event *select_events;
+
+/* Return what the terminal is ready for, as io_select_common sees it.  */
+static int
+tty_select_ready (void)
+{
+  return ((qsize (inputq) ? SELECT_READ : 0)
+	  | (qavail (outputq) ? SELECT_WRITE : 0));
+}
+
+void
+post_select_events (void)
+{
+  if (select_events)
+    iohelp_post_events (&select_events, tty_select_ready ());
+  pty_post_select_events ();
+}
+
 static error_t
 io_select_common (struct trivfs_protid *cred,
 		  mach_port_t reply,
@@ -2006,6 +2046,36 @@ trivfs_S_io_select_timeout (struct trivfs_protid *cred,
   return io_select_common (cred, reply, reply_type, &ts, type);
 }
 
+/* Like io_select, but leave a registration behind instead of waiting,
+   which post_select_events posts once the terminal is ready.  */
+kern_return_t
+S_io_event_register (struct trivfs_protid *cred,
+		     mach_port_t event_port,
+		     vm_address_t cookie,
+		     int type)
+{
+  error_t err;
+
+  if (!cred)
+    return EOPNOTSUPP;
+
+  if (cred->pi.class == pty_class)
+    return pty_io_event_register (cred, event_port, cookie, type);
+
+  if ((cred->po->openmodes & O_READ) == 0)
+    type &= ~SELECT_READ;
+  if ((cred->po->openmodes & O_WRITE) == 0)
+    type &= ~SELECT_WRITE;
+  type &= SELECT_READ | SELECT_WRITE;
+
+  pthread_mutex_lock (&global_lock);
+  err = iohelp_register_event (&select_events, event_port, cookie, type,
+			       tty_select_ready ());
+  pthread_mutex_unlock (&global_lock);
+
+  return err;
+}
+
 kern_return_t
 trivfs_S_io_map  (struct trivfs_protid *cred,
 		  mach_port_t reply,
@@ -1,5 +1,5 @@
 /* Node state and file contents for tmpfs.
-   Copyright (C) 2000,01,02 Free Software Foundation, Inc.
+   Copyright (C) 2000,01,02,26 Free Software Foundation, Inc.
 
    This file is part of the GNU Hurd.
 
@@ -30,6 +30,10 @@
 unsigned int num_files;
 static unsigned int gen;
 
+/* Inline file contents are allocated in multiples of this, so that
+   st_blocks can be kept exact by adding whole blocks.  */
+#define INLINE_ROUND(size)	(((size) + 511) & ~(off_t) 511)
+
 /* all_nodes is a list of all nodes.
 
    Access to all_nodes and all_nodes_nr_items is protected by
@@ -79,6 +83,7 @@ diskfs_free_node (struct node *np, mode_t mode)
 	vm_deallocate (mach_task_self (), np->dn->u.reg.memref, 4096);
 	mach_port_deallocate (mach_task_self (), np->dn->u.reg.memobj);
       }	
+      free (np->dn->u.reg.data);
       break;
     case DT_DIR:
       assert_backtrace (np->dn->u.dir.entries == 0);
@@ -125,6 +130,8 @@ diskfs_node_norefs (struct node *np)
       switch (np->dn->type)
 	{
 	case DT_REG:
+	  if (np->dn->u.reg.data != 0)
+	    break;		/* DATALEN is always current.  */
 	  assert_backtrace (np->allocsize % vm_page_size == 0);
 	  np->dn->u.reg.allocpages = np->allocsize / vm_page_size;
 	  break;
@@ -148,7 +155,10 @@ recompute_blocks (struct node *np)
   switch (dn->type)
     {
     case DT_REG:
-      np->allocsize = dn->u.reg.allocpages * vm_page_size;
+      if (dn->u.reg.data != 0)
+	np->allocsize = dn->u.reg.datalen;
+      else
+	np->allocsize = dn->u.reg.allocpages * vm_page_size;
       st->st_blocks += np->allocsize;
       break;
     case DT_LNK:
@@ -409,6 +419,27 @@ read_symlink_hook (struct node *np, char *target)
 error_t (*diskfs_read_symlink_hook)(struct node *np, char *target)
      = read_symlink_hook;
 
+/* Small files keep their contents in the disknode, so reading and
+   writing them is a plain memcpy.  Everything else goes through the
+   memory object.  */
+static error_t
+rdwr_hook (struct node *np, char *data, off_t offset, size_t *amt, int dir)
+{
+  struct disknode *const dn = np->dn;
+
+  if (dn->type != DT_REG || dn->u.reg.data == 0
+      || offset + *amt > dn->u.reg.datalen)
+    return EINVAL;
+
+  if (dir)
+    memcpy (dn->u.reg.data + offset, data, *amt);
+  else
+    memcpy (data, dn->u.reg.data + offset, *amt);
+  return 0;
+}
+error_t (*diskfs_rdwr_hook)(struct node *np, char *data, off_t offset,
+			    size_t *amt, int dir) = rdwr_hook;
+
 void
 diskfs_write_disknode (struct node *np, int wait)
 {
@@ -449,6 +480,33 @@ diskfs_truncate (struct node *np, off_t size)
 
   assert_backtrace (np->dn->type == DT_REG);
 
+  if (np->dn->u.reg.data != 0)
+    {
+      /* The contents are inline.  Keep the bytes past the new size
+	 zeroed, so that growing the file again reads back zeros.  */
+      off_t len = INLINE_ROUND (size);
+
+      np->dn_stat.st_size = size;
+      if (len == 0)
+	{
+	  free (np->dn->u.reg.data);
+	  np->dn->u.reg.data = 0;
+	}
+      else
+	{
+	  char *data = realloc (np->dn->u.reg.data, len);
+	  if (data != 0)
+	    np->dn->u.reg.data = data;
+	  memset (np->dn->u.reg.data + size, 0, len - size);
+	}
+
+      adjust_used (len - np->allocsize);
+      np->dn_stat.st_blocks += (len - np->allocsize) / 512;
+      np->dn->u.reg.datalen = len;
+      np->allocsize = len;
+      return 0;
+    }
+
   if (default_pager == MACH_PORT_NULL)
     return EIO;
 
@@ -480,6 +538,61 @@ diskfs_truncate (struct node *np, off_t size)
   return 0;
 }
 
+/* Grow the inline contents of locked node NP, which has no memory object,
+   to hold SIZE bytes.  The new space reads as zeros.  */
+static error_t
+grow_inline (struct node *np, off_t size)
+{
+  struct disknode *const dn = np->dn;
+  off_t len = INLINE_ROUND (size);
+  char *data;
+
+  if (round_page (get_used () + len - np->allocsize)
+      / vm_page_size > tmpfs_page_limit)
+    return ENOSPC;
+
+  data = realloc (dn->u.reg.data, len);
+  if (data == 0)
+    return ENOSPC;
+  memset (data + np->allocsize, 0, len - np->allocsize);
+
+  adjust_used (len - np->allocsize);
+  np->dn_stat.st_blocks += (len - np->allocsize) / 512;
+  dn->u.reg.data = data;
+  dn->u.reg.datalen = len;
+  np->allocsize = len;
+  return 0;
+}
+
+/* Copy the inline contents of locked node NP into its memory object,
+   which has just been created, and free them.  From now on the file is
+   accounted in whole pages like any other.  */
+static error_t
+promote_inline (struct node *np)
+{
+  struct disknode *const dn = np->dn;
+  off_t size = round_page (np->allocsize);
+  vm_address_t addr = 0;
+  error_t err;
+
+  err = vm_map (mach_task_self (), &addr, size, 0, 1, dn->u.reg.memobj,
+		0, 0, VM_PROT_READ | VM_PROT_WRITE,
+		VM_PROT_READ | VM_PROT_WRITE, VM_INHERIT_NONE);
+  if (err)
+    return err;
+  memcpy ((void *) addr, dn->u.reg.data, np->dn_stat.st_size);
+  vm_deallocate (mach_task_self (), addr, size);
+
+  free (dn->u.reg.data);
+  dn->u.reg.data = 0;
+  dn->u.reg.datalen = 0;
+
+  adjust_used (size - np->allocsize);
+  np->dn_stat.st_blocks += (size - np->allocsize) / 512;
+  np->allocsize = size;
+  return 0;
+}
+
 /* The user must define this function.  Grow the disk allocated to locked node
    NP to be at least SIZE bytes, and set NP->allocsize to the actual
    allocated size.  (If the allocated size is already SIZE bytes, do
@@ -492,6 +605,24 @@ diskfs_grow (struct node *np, off_t size, struct protid *cred)
   if (np->allocsize >= size)
     return 0;
 
+  if (np->dn->u.reg.memobj == MACH_PORT_NULL
+      && (np->dn->u.reg.data != 0 || np->allocsize == 0))
+    {
+      if (size <= tmpfs_inline_max)
+	return grow_inline (np, size);
+
+      if (np->dn->u.reg.data != 0)
+	{
+	  /* Too big to keep inline any longer.  */
+	  mach_port_t memobj = diskfs_get_filemap (np, VM_PROT_ALL);
+	  if (memobj == MACH_PORT_NULL)
+	    return errno;
+	  mach_port_deallocate (mach_task_self (), memobj);
+	  if (np->allocsize >= size)
+	    return 0;
+	}
+    }
+
   off_t set_size = size;
   size = round_page (size);
   if (round_page (get_used () + size - np->allocsize)
@@ -541,18 +672,32 @@ diskfs_get_filemap (struct node *np, vm_prot_t prot)
      pager how big to make its bitmaps.  This is just an optimization for
      the default pager; the memory object can be expanded at any time just
      by accessing more of it.  (It also optimizes the case of empty files
-     so we might never make a memory object at all.) */
+     so we might never make a memory object at all.)  Small files may
+     have lived inline until now; their contents move into the new
+     object, since it is about to be mapped.  */
   if (np->dn->u.reg.memobj == MACH_PORT_NULL)
     {
       error_t err = default_pager_object_create (default_pager,
 						 &np->dn->u.reg.memobj,
-						 np->allocsize);
+						 round_page (np->allocsize));
       if (err)
 	{
 	  errno = err;
 	  return MACH_PORT_NULL;
 	}
       assert_backtrace (np->dn->u.reg.memobj != MACH_PORT_NULL);
+
+      if (np->dn->u.reg.data != 0)
+	{
+	  err = promote_inline (np);
+	  if (err)
+	    {
+	      mach_port_deallocate (mach_task_self (), np->dn->u.reg.memobj);
+	      np->dn->u.reg.memobj = MACH_PORT_NULL;
+	      errno = err;
+	      return MACH_PORT_NULL;
+	    }
+	}
       
       /* XXX we need to keep a reference to the object, or GNU Mach
 	 will terminate it when we release the map. */
@@ -1,5 +1,5 @@
 /* Main program and global state for tmpfs.
-   Copyright (C) 2000,01,02 Free Software Foundation, Inc.
+   Copyright (C) 2000,01,02,26 Free Software Foundation, Inc.
 
    This file is part of the GNU Hurd.
 
@@ -54,6 +54,9 @@ struct node *diskfs_root_node;
 mach_port_t default_pager;
 
 off_t tmpfs_page_limit, tmpfs_space_used;
+
+#define DEFAULT_INLINE_MAX 2048
+off_t tmpfs_inline_max = DEFAULT_INLINE_MAX;
 mode_t tmpfs_root_mode = -1;
 
 error_t
@@ -99,11 +102,15 @@ diskfs_reload_global_state (void)
 int diskfs_synchronous = 0;
 
 #define OPT_SIZE 600	/* --size */
+#define OPT_INLINE_MAX 601	/* --inline-max */
 
 static const struct argp_option options[] =
 {
   {"mode", 'm', "MODE", 0, "Permissions (octal) for root directory"},
   {"size", OPT_SIZE, "MAX-BYTES", 0, "Maximum size"},
+  {"inline-max", OPT_INLINE_MAX, "BYTES", 0,
+   "Keep files of up to BYTES without a memory object until they are"
+   " mapped (default 2K, 0 disables)"},
   {NULL,}
 };
 
@@ -111,6 +118,7 @@ struct option_values
 {
   off_t size;
   mode_t mode;
+  off_t inline_max;
 };
 
 /* Parse the size string ARG, and set *NEWSIZE with the resulting size.  */
@@ -191,6 +199,7 @@ parse_opt (int key, char *arg, struct argp_state *state)
       state->hook = values;
       values->size = -1;
       values->mode = -1;
+      values->inline_max = -1;
       break;
     case ARGP_KEY_FINI:
       free (values);
@@ -223,6 +232,14 @@ parse_opt (int key, char *arg, struct argp_state *state)
       }
       break;
 
+    case OPT_INLINE_MAX:	/* --inline-max=BYTES */
+      {
+	error_t err = parse_opt_size (arg, state, &values->inline_max);
+	if (err)
+	  return err;
+      }
+      break;
+
     case ARGP_KEY_NO_ARGS:
       if (values->size < 0)
 	{
@@ -258,6 +275,8 @@ parse_opt (int key, char *arg, struct argp_state *state)
       /* All options parse successfully, so implement ours if possible.  */
       tmpfs_page_limit = values->size / vm_page_size;
       tmpfs_root_mode = values->mode;
+      if (values->inline_max >= 0)
+	tmpfs_inline_max = values->inline_max;
       break;
 
     default:
@@ -286,6 +305,13 @@ diskfs_append_args (char **argz, size_t *argz_len)
       err = argz_add (argz, argz_len, buf);
     }
 
+  if (!err && tmpfs_inline_max != DEFAULT_INLINE_MAX)
+    {
+      char buf[100];
+      snprintf (buf, sizeof buf, "--inline-max=%" PRIi64, tmpfs_inline_max);
+      err = argz_add (argz, argz_len, buf);
+    }
+
   return err;
 }
 
@@ -1,5 +1,5 @@
 /* Private data structures for tmpfs.
-   Copyright (C) 2000 Free Software Foundation, Inc.
+   Copyright (C) 2000, 2026 Free Software Foundation, Inc.
 
 This file is part of the GNU Hurd.
 
@@ -49,6 +49,8 @@ struct disknode
       mach_port_t memobj, ro_memobj;
       vm_address_t memref;
       unsigned int allocpages;	/* largest size while memobj was live */
+      char *data;		/* malloc'd contents while small, or 0 */
+      size_t datalen;		/* bytes allocated at DATA */
     } reg;
     struct
     {
@@ -70,6 +72,10 @@ struct tmpfs_dirent
 };
 
 extern off_t tmpfs_page_limit;
+
+/* Regular files no bigger than this keep their contents in the disknode
+   instead of a default pager memory object, until they are mapped.  */
+extern off_t tmpfs_inline_max;
 extern mach_port_t default_pager;
 
 /* These two must be accessed using atomic operations.  */
@@ -1,6 +1,6 @@
 /* A translator for providing access to Mach default_pager.defs control calls
 
-   Copyright (C) 2002, 2007 Free Software Foundation, Inc.
+   Copyright (C) 2002, 2007, 2026 Free Software Foundation, Inc.
 
    This program is free software; you can redistribute it and/or
    modify it under the terms of the GNU General Public License as
@@ -76,6 +76,15 @@ S_default_pager_storage_info (mach_port_t default_pager,
     ?: default_pager_storage_info (real_defpager, size, sizeCnt, free, freeCnt, name, nameCnt);
 }
 
+kern_return_t
+S_default_pager_server_stats (mach_port_t default_pager,
+			      vm_size_array_t *stats,
+			      mach_msg_type_number_t *statsCnt)
+{
+  return allowed (default_pager, O_READ)
+    ?: default_pager_server_stats (real_defpager, stats, statsCnt);
+}
+
 kern_return_t
 S_default_pager_objects (mach_port_t default_pager,
 			 default_pager_object_array_t *objects,
@@ -1,6 +1,6 @@
 /* Root usermux node
 
-   Copyright (C) 1997, 1998, 1999, 2000, 2002, 2008
+   Copyright (C) 1997, 1998, 1999, 2000, 2002, 2008, 2026
      Free Software Foundation, Inc.
    Written by Miles Bader <miles@gnu.org>
    This file is part of the GNU Hurd.
@@ -21,6 +21,7 @@
 
 #include <stddef.h>
 #include <string.h>
+#include <ctype.h>
 #include <dirent.h>
 #include <pwd.h>
 #include <sys/mman.h>
@@ -282,46 +283,57 @@ free_name (struct usermux_name *nm)
   free (nm);
 }
 
+/* Hash NAME, ignoring case.  */
+hurd_ihash_key_t
+usermux_name_hash (const void *name)
+{
+  const unsigned char *p;
+  uint32_t hash = 0;
+
+  for (p = name; *p; p++)
+    hash = hash * 31 + tolower (*p);
+  return (hurd_ihash_key_t) hash;
+}
+
+/* Return true if NAME1 and NAME2 are the same, ignoring case.  */
+int
+usermux_name_compare (const void *name1, const void *name2)
+{
+  return strcasecmp (name1, name2) == 0;
+}
+
 /* See if there's an existing entry for the name USER, and if so, return its
    node in NODE with an additional references.  True is returned iff the
-   lookup succeeds.  If PURGE is true, then any nodes with a null node are
-   removed.  */
+   lookup succeeds.  */
 static int
-lookup_cached (struct usermux *mux, const char *user, int purge,
-	       struct node **node)
+lookup_cached (struct usermux *mux, const char *user, struct node **node)
 {
-  struct usermux_name *nm = mux->names, **prevl = &mux->names;
+  struct usermux_name *nm =
+    hurd_ihash_find (&mux->names_ht, (hurd_ihash_key_t) user);
 
-  while (nm)
+  if (nm && nm->node)
     {
-      struct usermux_name *next = nm->next;
-
-      if (strcasecmp (user, nm->name) == 0)
-	{
-          if (nm->node)
-            netfs_nref (nm->node);
-
-	  if (nm->node)
-	    {
-	      *node = nm->node;
-	      return 1;
-	    }
-	}
-
-      if (purge && !nm->node)
-	{
-	  *prevl = nm->next;
-	  free_name (nm);
-	}
-      else
-	prevl = &nm->next;
-
-      nm = next;
+      netfs_nref (nm->node);
+      *node = nm->node;
+      return 1;
     }
 
   return 0;
 }
-
+
+/* Remove NM, whose node has gone away, from MUX and free it.  */
+void
+usermux_drop_name (struct usermux *mux, struct usermux_name *nm)
+{
+  pthread_rwlock_wrlock (&mux->names_lock);
+  *nm->prevp = nm->next;
+  if (nm->next)
+    nm->next->prevp = nm->prevp;
+  hurd_ihash_locp_remove (&mux->names_ht, nm->locp);
+  pthread_rwlock_unlock (&mux->names_lock);
+  free_name (nm);
+}
+
 /* See if there's an existing entry for the name USER, and if so, return its
    node in NODE, with an additional reference, otherwise, create a new node
    for the user HE as referred to by USER, and return that instead, with a
@@ -347,7 +359,7 @@ lookup_pwent (struct usermux *mux, const char *user, struct passwd *pw,
     }
 
   pthread_rwlock_wrlock (&mux->names_lock);
-  if (lookup_cached (mux, user, 1, node))
+  if (lookup_cached (mux, user, node))
     /* An entry for USER has already been created between the time we last
        looked and now (which is possible because we didn't lock MUX).
        Just throw away our version and return the one already in the cache.  */
@@ -360,7 +372,21 @@ lookup_pwent (struct usermux *mux, const char *user, struct passwd *pw,
   else
     /* Enter NM into MUX's list of names, and return the new node.  */
     {
+      err = hurd_ihash_add (&mux->names_ht, (hurd_ihash_key_t) nm->name, nm);
+      if (err)
+	{
+	  pthread_rwlock_unlock (&mux->names_lock);
+	  nm->node->nn->name = 0;
+	  netfs_nrele (nm->node);
+	  free_name (nm);
+	  *node = 0;
+	  return err;
+	}
+
       nm->next = mux->names;
+      nm->prevp = &mux->names;
+      if (mux->names)
+	mux->names->prevp = &nm->next;
       mux->names = nm;
       pthread_rwlock_unlock (&mux->names_lock);
     }
@@ -378,7 +404,7 @@ lookup_user (struct usermux *mux, const char *user, struct node **node)
   char pwent_data[2048];	/* XXX what size should this be???? */
 
   pthread_rwlock_rdlock (&mux->names_lock);
-  was_cached = lookup_cached (mux, user, 0, node);
+  was_cached = lookup_cached (mux, user, node);
   pthread_rwlock_unlock (&mux->names_lock);
 
   if (was_cached)
@@ -19,6 +19,7 @@
    Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111, USA. */
 
 #include <unistd.h>
+#include <stddef.h>
 #include <argp.h>
 #include <argz.h>
 #include <error.h>
@@ -106,6 +107,9 @@ main (int argc, char **argv)
   /* Parse our command line arguments.  */
   argp_parse (&argp, argc, argv, 0, 0, 0);
 
+  hurd_ihash_init (&mux.names_ht, offsetof (struct usermux_name, locp));
+  hurd_ihash_set_gki (&mux.names_ht, usermux_name_hash, usermux_name_compare);
+
   task_get_bootstrap_port (mach_task_self (), &bootstrap);
   netfs_init ();
 
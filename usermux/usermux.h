@@ -1,6 +1,6 @@
 /* Multiplexing filesystems by user
 
-   Copyright (C) 1997, 2000 Free Software Foundation, Inc.
+   Copyright (C) 1997, 2000, 2026 Free Software Foundation, Inc.
    Written by Miles Bader <miles@gnu.ai.mit.edu>
    This file is part of the GNU Hurd.
 
@@ -22,6 +22,7 @@
 #define __USERMUX_H__
 
 #include <hurd/netfs.h>
+#include <hurd/ihash.h>
 #include <pthread.h>
 #include <maptime.h>
 
@@ -40,6 +41,9 @@ struct usermux
   struct usermux_name *names;
   pthread_rwlock_t names_lock;
 
+  /* NAMES indexed by name, ignoring case; protected by NAMES_LOCK.  */
+  struct hurd_ihash names_ht;
+
   /* A template argz, which is used to start each user-specific translator
      with the user name appropriately added.  */
   char *trans_template;
@@ -68,7 +72,8 @@ struct usermux_name
   /* A filesystem node associated with NAME.  */
   struct node *node;
 
-  struct usermux_name *next;
+  struct usermux_name *next, **prevp;
+  hurd_ihash_locp_t locp;	/* Our slot in the mux's NAMES_HT.  */
 };
 
 /* The fs specific storage that libnetfs associates with each filesystem
@@ -92,6 +97,13 @@ struct netnode
 error_t create_user_node (struct usermux *mux, struct usermux_name *name,
 			  struct passwd *pw, struct node **node);
 
+/* Hash and comparison functions for user names.  */
+hurd_ihash_key_t usermux_name_hash (const void *name);
+int usermux_name_compare (const void *name1, const void *name2);
+
+/* Remove NM, whose node has gone away, from MUX and free it.  */
+void usermux_drop_name (struct usermux *mux, struct usermux_name *nm);
+
 #ifndef USERMUX_EI
 # define USERMUX_EI __extern_inline
 #endif
@@ -1,6 +1,6 @@
 /* Set a file's translator.
 
-   Copyright (C) 1995,96,97,98,2001,02,13,14
+   Copyright (C) 1995,96,97,98,2001,02,13,14,26
      Free Software Foundation, Inc.
    Written by Miles Bader <miles@gnu.org>
 
@@ -48,6 +48,7 @@ const char *argp_program_version = STANDARD_HURD_VERSION (settrans);
 
 #define OPT_CHROOT_CHDIR	-1
 #define OPT_STACK		-2
+#define OPT_TIMES		-3
 
 static struct argp_option options[] =
 {
@@ -62,6 +63,8 @@ static struct argp_option options[] =
      " wait for a newline on stdin before completing the startup handshake"},
   {"timeout",     't',"SEC",0, "Timeout for translator startup, in seconds"
      " (default " STRINGIFY (DEFAULT_TIMEOUT) "); 0 means no timeout"},
+  {"times",       OPT_TIMES, 0, 0, "When starting an active translator, report"
+     " how long each phase of its startup took"},
   {"exclusive",   'x', 0, 0, "Only set the translator if there is not one already"},
   {"orphan",      'o', 0, 0, "Disconnect old translator from the filesystem "
 			     "(do not ask it to go away)"},
@@ -160,6 +163,7 @@ main(int argc, char *argv[])
       orphan = 0;
   int start = 0;
   int stack = 0;
+  int times = 0;
   char *pid_file = NULL;
   int excl = 0;
   int timeout = DEFAULT_TIMEOUT * 1000; /* ms */
@@ -208,6 +212,7 @@ main(int argc, char *argv[])
 	case 'g': kill_active = 1; break;
 	case 'x': excl = 1; break;
 	case 'P': pause = 1; break;
+	case OPT_TIMES: times = 1; break;
 	case 'F':
 	  pid_file = strdup (arg);
 	  if (pid_file == NULL)
@@ -378,6 +383,14 @@ main(int argc, char *argv[])
 	}
       err = fshelp_start_translator (open_node, NULL, argz, argz, argz_len,
 				     timeout, &active_control);
+      if (times)
+	{
+	  struct fshelp_start_times t;
+	  fshelp_start_translator_times (&t);
+	  fprintf (stderr, "%s: lookup %luus, task %luus, exec %luus,"
+		   " startup %luus\n", argz, t.lookup, t.task, t.exec,
+		   t.startup);
+	}
       if (err)
 	/* If ERR is due to a problem opening the translated node, we print
 	   that name, otherwise, the name of the translator.  */